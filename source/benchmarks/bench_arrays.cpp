@@ -0,0 +1,196 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/number_codec.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Large lists of doubles: getValue<std::vector<double>>, which copies, against getArray(), a
+// view of the stored list, for a 100k-value curve written in the INI file; then loading a
+// 1M-value curve written in the file against one referred to as an .npy array file, and the
+// first and later reads of the latter. Checks that stored lists are aligned, that .npy and raw
+// array files read back exactly, in snapshots and through getValue too, and that a file of the
+// wrong type fails on read rather than at load.
+
+namespace {
+
+	const char* const kConfigPath = "bench_arrays.ini";
+	const char* const kNpyPath = "bench_arrays.npy";
+	const char* const kRawPath = "bench_arrays.bin";
+	const char* const kWrongPath = "bench_arrays_int.npy";
+	const size_t kInlineCount = 100000;
+	const size_t kLargeCount = 1000000;
+
+	std::vector<ConfigLib::ConfigGen::ConfigSection> schema() {
+		return {
+			{"Calibration", {
+				{"short", "vector<double>", "0", "A few knots", nullptr},
+				{"curve", "vector<double>", "0", "Curve written in the file", nullptr},
+				{"surface", "vector<double>", "0", "Surface in an .npy file", nullptr},
+				{"raw", "vector<double>", "0", "Curve in a raw binary file", nullptr},
+				{"wrong", "vector<double>", "0", "Integers in an .npy file", nullptr},
+			}},
+		};
+	}
+
+	std::vector<double> makeValues(size_t count, double scale) {
+		std::vector<double> values(count);
+		for (size_t i = 0; i < count; ++i) values[i] = scale * static_cast<double>(i % 977) / 977.0 + static_cast<double>(i);
+		return values;
+	}
+
+	// Version 1.0 .npy: magic, version, header length, and a header padded so that the data
+	// starts on a 64-byte boundary
+	std::string npyFile(const char* descr, const void* data, size_t count, size_t itemSize) {
+		std::string header = std::string("{'descr': '") + descr + "', 'fortran_order': False, 'shape': (" + std::to_string(count) + ",), }";
+		while ((10 + header.size() + 1) % 64 != 0) header += ' ';
+		header += '\n';
+		std::string file("\x93NUMPY\x01\x00", 8);
+		file += static_cast<char>(header.size() & 0xff);
+		file += static_cast<char>(header.size() >> 8);
+		file += header;
+		file.append(static_cast<const char*>(data), count * itemSize);
+		return file;
+	}
+
+}
+
+int main() {
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Off);
+
+	const std::vector<double> curve = makeValues(kInlineCount, 0.5);
+	const std::vector<double> surface = makeValues(kLargeCount, 2.0);
+	const std::vector<int32_t> integers(1000, 7);
+	Bench::writeFile(kNpyPath, npyFile("<f8", surface.data(), surface.size(), sizeof(double)));
+	Bench::writeFile(kRawPath, std::string(reinterpret_cast<const char*>(curve.data()), curve.size() * sizeof(double)));
+	Bench::writeFile(kWrongPath, npyFile("<i4", integers.data(), integers.size(), sizeof(int32_t)));
+
+	const std::string common = "[Calibration]\nshort = 0.5, 1, 2, 5\ncurve = " + ConfigLib::NumberCodec::formatDoubleList(curve)
+		+ "\nraw = @" + kRawPath + "\nwrong = @" + kWrongPath + "\n";
+	const std::string inlineText = common + "surface = " + ConfigLib::NumberCodec::formatDoubleList(surface) + "\n";
+	const std::string externalText = common + "surface = @" + kNpyPath + "\n";
+	std::printf("config with the 1M-value surface written in: %.1f MB, referred to: %.1f MB\n",
+		inlineText.size() / (1024.0 * 1024.0), externalText.size() / (1024.0 * 1024.0));
+
+	bool ok = true;
+	const int runs = 5;
+	double inlineLoad = 1e9;
+	double externalLoad = 1e9;
+	Bench::writeFile(kConfigPath, inlineText);
+	for (int run = 0; run < runs; ++run) {
+		Bench::GeneratedConfig config(schema(), kConfigPath);
+		Bench::Timer timer;
+		config.initialize();
+		inlineLoad = std::min(inlineLoad, timer.elapsedSeconds() * 1e3);
+	}
+	Bench::writeFile(kConfigPath, externalText);
+	double firstRead = 1e9;
+	for (int run = 0; run < runs; ++run) {
+		Bench::GeneratedConfig config(schema(), kConfigPath);
+		Bench::Timer timer;
+		config.initialize();
+		externalLoad = std::min(externalLoad, timer.elapsedSeconds() * 1e3);
+		Bench::Timer readTimer;
+		const ConfigLib::DoubleSpan values = config.getArray("Calibration", "surface");
+		firstRead = std::min(firstRead, readTimer.elapsedSeconds() * 1e6);
+		ok = ok && values.size() == kLargeCount;
+	}
+	std::printf("%-40s %10.2f ms\n", "initialize(), surface written in", inlineLoad);
+	std::printf("%-40s %10.2f ms\n", "initialize(), surface in .npy", externalLoad);
+	std::printf("%-40s %10.2f us\n", "first getArray() of the .npy surface", firstRead);
+
+	Bench::GeneratedConfig config(schema(), kConfigPath);
+	config.initialize();
+	const size_t reads = 2000;
+	{
+		double sum = 0.0;
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		for (size_t i = 0; i < reads; ++i) {
+			const std::vector<double> values = config.getValue<std::vector<double>>("Calibration", "curve");
+			sum += values[i % values.size()];
+		}
+		const double elapsed = timer.elapsedNanoseconds();
+		Bench::doNotOptimize(sum);
+		Bench::report("getValue<vector>, 100k values", elapsed / reads,
+			static_cast<double>(Bench::allocationCount() - allocationsBefore) / reads);
+	}
+	{
+		double sum = 0.0;
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		for (size_t i = 0; i < reads; ++i) {
+			const ConfigLib::DoubleSpan values = config.getArray("Calibration", "curve");
+			sum += values[i % values.size()];
+		}
+		const double elapsed = timer.elapsedNanoseconds();
+		Bench::doNotOptimize(sum);
+		Bench::report("getArray(), 100k values", elapsed / reads,
+			static_cast<double>(Bench::allocationCount() - allocationsBefore) / reads);
+	}
+	{
+		double sum = 0.0;
+		Bench::Timer timer;
+		for (size_t i = 0; i < reads; ++i) {
+			const ConfigLib::DoubleSpan values = config.getArray("Calibration", "surface");
+			sum += values[i % values.size()];
+		}
+		const double elapsed = timer.elapsedNanoseconds();
+		Bench::doNotOptimize(sum);
+		Bench::report("getArray(), 1M values in .npy, mapped", elapsed / reads, 0.0);
+	}
+
+	// Layout and contents
+	const ConfigLib::DoubleSpan stored = config.getArray("Calibration", "curve");
+	const bool aligned = reinterpret_cast<uintptr_t>(stored.data()) % ConfigLib::kListAlignment == 0;
+	std::printf("%-40s %10s\n", "stored list 64-byte aligned", aligned ? "yes" : "no");
+	ok = ok && aligned && std::equal(stored.begin(), stored.end(), curve.begin(), curve.end());
+	const ConfigLib::DoubleSpan mapped = config.getArray("Calibration", "surface");
+	ok = ok && std::equal(mapped.begin(), mapped.end(), surface.begin(), surface.end());
+	const ConfigLib::DoubleSpan raw = config.getArray("Calibration", "raw");
+	ok = ok && std::equal(raw.begin(), raw.end(), curve.begin(), curve.end());
+	ok = ok && config.getValue<std::vector<double>>("Calibration", "raw") == curve
+		&& config.getArray("Calibration", "short").size() == 4;
+	ok = ok && config.getLoadViolations().empty();
+
+	// The wrong file only fails once read
+	bool rejected = false;
+	try {
+		config.getArray("Calibration", "wrong");
+	} catch (const std::runtime_error& e) {
+		rejected = std::string(e.what()).find("<i4") != std::string::npos;
+	}
+	ok = ok && rejected;
+
+	// Snapshots share the mapping of the generation they copy
+	Bench::GeneratedConfig shared(schema(), kConfigPath);
+	shared.setSnapshotMode(true);
+	shared.initialize();
+	shared.setValue("Calibration", "short", std::vector<double>{1.0, 2.0});
+	{
+		const ConfigLib::ConfigSnapshot snapshot = shared.snapshot();
+		const ConfigLib::DoubleSpan values = snapshot.getArray("Calibration", "surface");
+		ok = ok && values.size() == kLargeCount && values[kLargeCount - 1] == surface.back()
+			&& snapshot.getArray("Calibration", "short").size() == 2;
+	}
+	bool guarded = false;
+	try {
+		shared.getArray("Calibration", "surface");
+	} catch (const std::logic_error&) {
+		guarded = true;
+	}
+	ok = ok && guarded;
+
+	Bench::removeFile(kConfigPath);
+	Bench::removeFile(kNpyPath);
+	Bench::removeFile(kRawPath);
+	Bench::removeFile(kWrongPath);
+	std::printf("arrays read back: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "bench_common.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <new>
+#include <stdexcept>
+
+namespace {
+	std::atomic<size_t> allocations(0);
+	std::atomic<size_t> bytes(0);
+
+	size_t readStatusField(const char* field) {
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		const size_t length = std::strlen(field);
+		while (std::getline(status, line)) {
+			if (line.compare(0, length, field) == 0) {
+				return std::strtoul(line.c_str() + length, nullptr, 10);
+			}
+		}
+		return 0;
+	}
+}
+
+// Counting replacements for the global allocation functions. They are linked into every
+// benchmark executable through config_bench_support.
+void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return ::operator new(size);
+}
+
+// Memory resources such as std::pmr::new_delete_resource allocate through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(size, std::memory_order_relaxed);
+	const size_t align = static_cast<size_t>(alignment);
+	if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return ::operator new(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace Bench {
+
+	size_t allocationCount() {
+		return allocations.load(std::memory_order_relaxed);
+	}
+
+	size_t allocatedBytes() {
+		return bytes.load(std::memory_order_relaxed);
+	}
+
+	size_t currentRssKilobytes() {
+		return readStatusField("VmRSS:");
+	}
+
+	size_t peakRssKilobytes() {
+		return readStatusField("VmHWM:");
+	}
+
+	void writeFile(const std::string& path, const std::string& contents) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			throw std::runtime_error("Unable to open file for writing: " + path);
+		}
+		file << contents;
+	}
+
+	void removeFile(const std::string& path) {
+		std::remove(path.c_str());
+	}
+
+	void report(const std::string& name, double nanosecondsPerOp, double allocationsPerOp) {
+		std::printf("%-40s %12.2f ns/op %10.3f allocs/op\n", name.c_str(), nanosecondsPerOp, allocationsPerOp);
+	}
+
+} // namespace Bench
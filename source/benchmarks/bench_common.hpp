@@ -0,0 +1,44 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace Bench {
+
+    // Number of calls to the global operator new since program start.
+    size_t allocationCount();
+    // Total bytes requested from the global operator new since program start.
+    size_t allocatedBytes();
+
+    class Timer {
+    public:
+        Timer() : start(std::chrono::steady_clock::now()) {}
+        double elapsedSeconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        double elapsedNanoseconds() const { return elapsedSeconds() * 1e9; }
+
+    private:
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Keeps the optimizer from discarding a computed value.
+    template<typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    // Resident set size of this process in KiB, current and peak; 0 where /proc is unavailable.
+    size_t currentRssKilobytes();
+    size_t peakRssKilobytes();
+
+    void writeFile(const std::string& path, const std::string& contents);
+    void removeFile(const std::string& path);
+
+    void report(const std::string& name, double nanosecondsPerOp, double allocationsPerOp);
+
+} // namespace Bench
+
+#endif // BENCH_COMMON_H
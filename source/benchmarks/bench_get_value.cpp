@@ -0,0 +1,111 @@
+#include "bench_common.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/validation_rules.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+
+// Measures the steady-state cost of ConfigReader::getValue<double> with logging at its
+// default configuration: it should neither allocate nor reach the log sink.
+
+namespace {
+
+	const char* const kConfigPath = "bench_get_value.ini";
+
+	class BenchConfig : public ConfigLib::ConfigReader {
+	public:
+		BenchConfig() { initialize(); }
+
+		std::string getConfigFilePath() const override { return kConfigPath; }
+
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override {
+			return {
+				{
+					"Simulation",
+					{
+						{"num_steps", "int", "252", "Number of time steps", &ValidationRules::greaterThanZero},
+						{"volatility", "double", "0.2", "Asset price volatility", &ValidationRules::greaterThanZero}
+					}
+				}
+			};
+		}
+	};
+
+	class CountingSink : public ConfigLib::Log::Sink {
+	public:
+		void write(ConfigLib::Log::Level, const std::string&) override { ++messages; }
+		std::atomic<size_t> messages{0};
+	};
+
+}
+
+int main() {
+	Bench::writeFile(kConfigPath, "[Simulation]\nnum_steps = 252\nvolatility = 0.25\n");
+
+	auto sink = std::make_shared<CountingSink>();
+	ConfigLib::Log::setSink(sink);
+	// Ask for everything at runtime; only levels compiled in can reach the sink.
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Trace);
+
+	{
+		BenchConfig config;
+		const std::string section = "Simulation";
+		const std::string key = "volatility";
+		const size_t iterations = 5000000;
+
+		double sum = 0.0;
+		size_t messagesBefore = sink->messages.load();
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += config.getValue<double>(section, key);
+		}
+		double elapsed = timer.elapsedNanoseconds();
+		size_t allocations = Bench::allocationCount() - allocationsBefore;
+		size_t messages = sink->messages.load() - messagesBefore;
+		Bench::doNotOptimize(sum);
+
+		Bench::report("getValue<double>", elapsed / iterations, static_cast<double>(allocations) / iterations);
+		std::printf("log messages emitted during reads: %zu (compiled minimum level %d)\n", messages, CONFIG_LOG_MIN_LEVEL);
+
+		// Bound handle: the lookup and type check happen once, outside the loop
+		ConfigLib::ConfigHandle<double> handle = config.bind<double>(section, key);
+		sum = 0.0;
+		allocationsBefore = Bench::allocationCount();
+		Bench::Timer handleTimer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += handle.get();
+			Bench::doNotOptimize(sum);
+		}
+		elapsed = handleTimer.elapsedNanoseconds();
+		allocations = Bench::allocationCount() - allocationsBefore;
+		Bench::report("ConfigHandle<double>::get", elapsed / iterations, static_cast<double>(allocations) / iterations);
+	}
+
+	// Same loop with every message routed through the batched asynchronous sink.
+	{
+		auto async = std::make_shared<ConfigLib::Log::AsyncSink>(sink);
+		ConfigLib::Log::setSink(async);
+		BenchConfig config;
+		const std::string section = "Simulation";
+		const std::string key = "volatility";
+		const size_t iterations = 200000;
+
+		double sum = 0.0;
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += config.getValue<double>(section, key);
+		}
+		double elapsed = timer.elapsedNanoseconds();
+		size_t allocations = Bench::allocationCount() - allocationsBefore;
+		async->flush();
+		Bench::doNotOptimize(sum);
+		Bench::report("getValue<double> (async sink)", elapsed / iterations, static_cast<double>(allocations) / iterations);
+		ConfigLib::Log::setSink(sink);
+	}
+
+	Bench::removeFile(kConfigPath);
+	return 0;
+}
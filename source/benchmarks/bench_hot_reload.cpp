@@ -0,0 +1,147 @@
+#include "bench_common.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/config_watcher.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Hot reload through ConfigWatcher: latency from saving the file to the change callback, for
+// in-place writes and for the write-temporary-then-rename pattern most editors use, and the
+// number of reloads a burst of writes costs after debouncing.
+
+namespace {
+
+	const char* const kConfigPath = "bench_hot_reload.ini";
+	const char* const kTemporaryPath = "bench_hot_reload.ini.tmp";
+
+	class BenchConfig : public ConfigLib::ConfigReader {
+	public:
+		std::string getConfigFilePath() const override { return kConfigPath; }
+
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override {
+			return {
+				{
+					"Simulation",
+					{
+						{"num_steps", "int", "252", "Number of time steps", nullptr},
+						{"volatility", "double", "0.25", "Asset price volatility", nullptr}
+					}
+				}
+			};
+		}
+
+		void load() { initialize(); }
+	};
+
+	std::string contents(int steps, double volatility) {
+		return "[Simulation]\nnum_steps = " + std::to_string(steps) + "\nvolatility = " + std::to_string(volatility) + "\n";
+	}
+
+	// Counts volatility notifications and lets the main thread wait for the next one
+	class Notifications {
+	public:
+		void record(double value) {
+			std::lock_guard<std::mutex> lock(mutex);
+			++count;
+			last = value;
+			changed.notify_all();
+		}
+
+		bool waitFor(size_t expected, std::chrono::milliseconds timeout) {
+			std::unique_lock<std::mutex> lock(mutex);
+			return changed.wait_for(lock, timeout, [&] { return count >= expected; });
+		}
+
+		size_t getCount() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return count;
+		}
+
+		double getLast() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return last;
+		}
+
+	private:
+		std::mutex mutex;
+		std::condition_variable changed;
+		size_t count = 0;
+		double last = 0.0;
+	};
+
+}
+
+int main() {
+	const auto debounce = std::chrono::milliseconds(20);
+	const auto timeout = std::chrono::milliseconds(2000);
+
+	Bench::writeFile(kConfigPath, contents(252, 0.25));
+	BenchConfig config;
+	config.load();
+	config.setSnapshotMode(true);
+
+	Notifications volatility;
+	std::atomic<size_t> stepNotifications(0);
+	ConfigLib::ConfigWatcher watcher(config, debounce);
+	watcher.subscribe("Simulation", "volatility", [&](const ConfigLib::ConfigChange& change) {
+		volatility.record(*change.newValue->get<double>());
+	});
+	watcher.subscribe("Simulation", "num_steps", [&](const ConfigLib::ConfigChange&) { ++stepNotifications; });
+	watcher.start();
+
+	bool ok = true;
+	const int rounds = 20;
+	for (int rename = 0; rename < 2; ++rename) {
+		double totalMs = 0.0;
+		double worstMs = 0.0;
+		for (int round = 0; round < rounds; ++round) {
+			const double value = 0.3 + 0.01 * round + 0.5 * rename;
+			const size_t expected = volatility.getCount() + 1;
+			Bench::Timer timer;
+			if (rename) {
+				Bench::writeFile(kTemporaryPath, contents(252, value));
+				std::rename(kTemporaryPath, kConfigPath);
+			} else {
+				Bench::writeFile(kConfigPath, contents(252, value));
+			}
+			if (!volatility.waitFor(expected, timeout)) {
+				std::printf("no notification after %s\n", rename ? "rename" : "write");
+				ok = false;
+				break;
+			}
+			const double ms = timer.elapsedSeconds() * 1e3;
+			totalMs += ms;
+			worstMs = std::max(worstMs, ms);
+			ok = ok && volatility.getLast() == config.getValue<double>("Simulation", "volatility");
+		}
+		std::printf("%-40s %8.2f ms mean %8.2f ms worst (debounce %lld ms)\n",
+			rename ? "save by rename -> callback" : "save in place -> callback",
+			totalMs / rounds, worstMs, static_cast<long long>(debounce.count()));
+	}
+
+	// A burst of writes faster than the debounce interval
+	const size_t reloadsBefore = watcher.getReloadCount();
+	const size_t expected = volatility.getCount() + 1;
+	const int burst = 10;
+	for (int i = 0; i < burst; ++i) {
+		Bench::writeFile(kConfigPath, contents(252, 2.0 + i));
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	ok = volatility.waitFor(expected, timeout) && ok;
+	std::this_thread::sleep_for(debounce * 5);
+	std::printf("burst of %d writes: %zu reloads, final volatility %.1f\n",
+		burst, watcher.getReloadCount() - reloadsBefore, config.getValue<double>("Simulation", "volatility"));
+	ok = ok && config.getValue<double>("Simulation", "volatility") == 2.0 + burst - 1;
+
+	// Only volatility ever changed
+	std::printf("num_steps notifications: %zu, failed reloads: %zu\n", stepNotifications.load(), watcher.getFailedReloadCount());
+	ok = ok && stepNotifications == 0;
+
+	watcher.stop();
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
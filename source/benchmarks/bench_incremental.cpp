@@ -0,0 +1,131 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Full reload() against reloadIncremental() on a 50k-key file after editing one line, and a
+// check that after a series of edits, removals and a dropped section the incremental reader
+// holds exactly what a freshly loaded reader holds.
+
+namespace {
+
+	const char* const kConfigPath = "bench_incremental.ini";
+
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 500;
+		shape.keysPerSection = 100;
+		shape.vectorLength = 6;
+		shape.commentDensity = 0.0;
+		return shape;
+	}
+
+	std::string sectionName(int index) {
+		return "Section" + std::to_string(index);
+	}
+
+	// Index of the first key of a section
+	size_t firstKey(const Bench::IniGenerator& generator, const std::string& section) {
+		const auto& keys = generator.getKeys();
+		size_t i = 0;
+		while (keys[i].section != section) ++i;
+		return i;
+	}
+
+	// Index of the first int key of a section
+	size_t firstInt(const Bench::IniGenerator& generator, const std::string& section) {
+		const auto& keys = generator.getKeys();
+		size_t i = firstKey(generator, section);
+		while (keys[i].type != ConfigLib::ValueType::Int) ++i;
+		return i;
+	}
+
+	bool sameValues(const Bench::GeneratedConfig& a, const Bench::GeneratedConfig& b) {
+		const ConfigLib::ConfigSnapshot other = b.snapshot();
+		for (const auto& section : a.getSections()) {
+			for (const auto& entry : section.getEntries()) {
+				if (entry.value.empty()) continue;
+				const ConfigLib::StoredValue* value = other.getGeneration().findValue(section.getName(), entry.key);
+				if (!value || *value != entry.value) return false;
+			}
+		}
+		return true;
+	}
+
+	size_t countValues(const Bench::GeneratedConfig& config) {
+		size_t count = 0;
+		for (const auto& section : config.getSections()) {
+			for (const auto& entry : section.getEntries()) count += entry.value.empty() ? 0 : 1;
+		}
+		return count;
+	}
+
+}
+
+int main() {
+	const Bench::IniShape sizes = shape();
+	Bench::IniGenerator generator(sizes);
+	Bench::writeFile(kConfigPath, generator.generate());
+	Bench::GeneratedConfig config(generator, kConfigPath);
+	config.initialize();
+	std::printf("%zu keys in %d sections, one int edited per reload\n", generator.getKeys().size(), sizes.sections);
+
+	// Best of several runs; each run edits the same line to a new value
+	const size_t edited = firstInt(generator, sectionName(sizes.sections / 2));
+	const std::string original = generator.getKeys()[edited].value;
+	const auto offset = [&](int by) { return std::to_string(std::stoi(original) + by); };
+	const int runs = 10;
+	double fullMs = 1e9;
+	double incrementalMs = 1e9;
+	bool ok = true;
+	for (int run = 0; run < runs; ++run) {
+		generator.setValue(edited, offset(2 * run + 1));
+		Bench::writeFile(kConfigPath, generator.generate());
+		{
+			Bench::Timer timer;
+			config.reload();
+			fullMs = std::min(fullMs, timer.elapsedSeconds() * 1e3);
+		}
+		generator.setValue(edited, offset(2 * run + 2));
+		Bench::writeFile(kConfigPath, generator.generate());
+		Bench::Timer timer;
+		const ConfigLib::ConfigChangeSet changes = config.reloadIncremental();
+		incrementalMs = std::min(incrementalMs, timer.elapsedSeconds() * 1e3);
+		ok = ok && changes.changes.size() == 1 && changes.sectionsParsed == 1
+			&& changes.changes[0].kind == ConfigLib::ConfigKeyChange::Kind::Modified;
+	}
+	std::printf("%-40s %10.2f ms\n", "reload()", fullMs);
+	std::printf("%-40s %10.2f ms\n", "reloadIncremental()", incrementalMs);
+
+	// The edited value put back, a removed key, a dropped section and a value set by hand,
+	// against a fresh load of the same file
+	const size_t setByHand = firstInt(generator, sectionName(7));
+	config.setValue(sectionName(7), generator.getKeys()[setByHand].name, 12345);
+	generator.setValue(edited, original);
+	generator.omit(firstKey(generator, sectionName(3)) + 5);
+	const size_t dropped = firstKey(generator, sectionName(9));
+	for (int k = 0; k < sizes.keysPerSection; ++k) generator.omit(dropped + k);
+	Bench::writeFile(kConfigPath, generator.generate());
+	const ConfigLib::ConfigChangeSet changes = config.reloadIncremental();
+	size_t added = 0, removed = 0, modified = 0;
+	for (const auto& change : changes.changes) {
+		switch (change.kind) {
+			case ConfigLib::ConfigKeyChange::Kind::Added: ++added; break;
+			case ConfigLib::ConfigKeyChange::Kind::Removed: ++removed; break;
+			case ConfigLib::ConfigKeyChange::Kind::Modified: ++modified; break;
+		}
+	}
+	std::printf("edit set: %zu added, %zu removed, %zu modified, %zu sections parsed, %zu skipped\n",
+		added, removed, modified, changes.sectionsParsed, changes.sectionsSkipped);
+
+	Bench::GeneratedConfig fresh(generator, kConfigPath);
+	fresh.initialize();
+	const bool equivalent = sameValues(config, fresh) && sameValues(fresh, config) && countValues(config) == countValues(fresh);
+	std::printf("matches a full load: %s\n", equivalent ? "yes" : "no");
+	ok = ok && equivalent && removed == 1 + static_cast<size_t>(sizes.keysPerSection) && modified == 2 && added == 0;
+
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include "bench_common.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/validation_rules.hpp"
+#include <cstdio>
+#include <string>
+
+// getValue by (section, key) strings against getValue through a compile-time key id, with a
+// bound handle as the floor, on a reader declared with a constexpr schema. Also checks that
+// both paths return the same values, before and after a write and in snapshot mode.
+
+namespace {
+
+	const char* const kConfigPath = "bench_key_id.ini";
+
+	using ConfigLib::ConfigGen::Key;
+
+	inline constexpr Key<int> numSteps{"Simulation", "num_steps", "252", "Number of time steps", &ValidationRules::greaterThanZero};
+	inline constexpr Key<double> volatility{"Simulation", "volatility", "0.2", "Asset price volatility", &ValidationRules::greaterThanZero};
+	inline constexpr Key<std::string> model{"Simulation", "model", "heston", "Pricing model"};
+	inline constexpr Key<std::vector<double>> tenors{"Curve", "tenors", "0.25, 0.5, 1, 2, 5", "Curve tenors in years"};
+
+	inline constexpr auto schema = ConfigLib::ConfigGen::makeSchema(numSteps, volatility, model, tenors);
+
+	class BenchConfig : public ConfigLib::StaticConfigReader<schema> {
+	public:
+		BenchConfig() { initialize(); }
+
+		std::string getConfigFilePath() const override { return kConfigPath; }
+	};
+
+	bool sameValues(const BenchConfig& config) {
+		return config.get<numSteps>() == config.getValue<int>("Simulation", "num_steps")
+			&& config.get<volatility>() == config.getValue<double>("Simulation", "volatility")
+			&& config.get<model>() == config.getValue<std::string>("Simulation", "model")
+			&& config.get<tenors>() == config.getValue<std::vector<double>>("Curve", "tenors");
+	}
+
+}
+
+int main() {
+	Bench::writeFile(kConfigPath, "[Simulation]\nnum_steps = 252\nvolatility = 0.25\nmodel = black-scholes\n\n[Curve]\ntenors = 1, 2, 3\n");
+
+	bool ok = true;
+	{
+		BenchConfig config;
+		const std::string section = "Simulation";
+		const std::string key = "volatility";
+		const size_t iterations = 5000000;
+
+		double sum = 0.0;
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += config.getValue<double>(section, key);
+		}
+		double elapsed = timer.elapsedNanoseconds();
+		size_t allocations = Bench::allocationCount() - allocationsBefore;
+		Bench::doNotOptimize(sum);
+		Bench::report("getValue<double>(section, key)", elapsed / iterations, static_cast<double>(allocations) / iterations);
+
+		sum = 0.0;
+		allocationsBefore = Bench::allocationCount();
+		Bench::Timer idTimer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += config.get<volatility>();
+		}
+		elapsed = idTimer.elapsedNanoseconds();
+		allocations = Bench::allocationCount() - allocationsBefore;
+		Bench::doNotOptimize(sum);
+		Bench::report("get<volatility>() (key id)", elapsed / iterations, static_cast<double>(allocations) / iterations);
+
+		ConfigLib::ConfigHandle<double> handle = config.bind<double>(section, key);
+		sum = 0.0;
+		Bench::Timer handleTimer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += handle.get();
+			Bench::doNotOptimize(sum);
+		}
+		Bench::report("ConfigHandle<double>::get", handleTimer.elapsedNanoseconds() / iterations, 0.0);
+
+		ok = sameValues(config);
+		config.setValue(section, key, 0.5);
+		ok = ok && sameValues(config) && config.get<volatility>() == 0.5;
+		config.setSnapshotMode(true);
+		config.setValue("Simulation", "num_steps", 365);
+		ok = ok && sameValues(config) && config.get<numSteps>() == 365;
+		std::printf("key ids match string lookups: %s\n", ok ? "yes" : "no");
+	}
+
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
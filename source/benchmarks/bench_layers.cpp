@@ -0,0 +1,195 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_layers.hpp"
+#include "config_library/config_log.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Layered loading against merging by hand: a generated 20k-key site file, a scenario file that
+// overrides every 20th key, an environment variable and a command-line argument, flattened by
+// LayeredConfig::load(), against initialize() on the site file followed by loadFromBuffer() of
+// the scenario. Then reloadLayer() of the scenario after one of its values changed. Checks that
+// both give the same values, that each layer wins where it should, that an invalid override
+// falls through to the layer below, and that the reload reports exactly the changed key.
+
+namespace {
+
+	const char* const kSitePath = "bench_layers_site.ini";
+	const char* const kScenarioPath = "bench_layers_scenario.ini";
+
+	void setEnvironment(const char* name, const char* value) {
+#ifdef _WIN32
+		_putenv_s(name, value);
+#else
+		setenv(name, value, 1);
+#endif
+	}
+
+	// A valid value of key's type other than the generated one
+	std::string overrideValue(const Bench::GeneratedKey& key, int variant) {
+		switch (key.type) {
+			case ConfigLib::ValueType::Int: return std::to_string(7 + variant);
+			case ConfigLib::ValueType::Double: return std::to_string(2.5 + variant);
+			case ConfigLib::ValueType::String: {
+				const char* const words[] = {"adaptive", "fixed", "implicit", "explicit"};
+				const char* word = words[variant % 4];
+				return key.value == word ? words[(variant + 1) % 4] : word;
+			}
+			case ConfigLib::ValueType::DoubleVector: return "1.5, " + std::to_string(2.5 + variant);
+		}
+		return key.value;
+	}
+
+	struct Scenario {
+		std::vector<std::pair<const Bench::GeneratedKey*, std::string>> values;
+
+		std::string text() const {
+			std::string contents;
+			const std::string* section = nullptr;
+			for (const auto& value : values) {
+				if (!section || *section != value.first->section) {
+					section = &value.first->section;
+					contents += "\n[" + *section + "]\n";
+				}
+				contents += value.first->name + " = " + value.second + "\n";
+			}
+			return contents;
+		}
+	};
+
+	const ConfigLib::StoredValue* find(const ConfigLib::ConfigSnapshot& snapshot, const Bench::GeneratedKey& key) {
+		return snapshot.getGeneration().findValue(key.section, key.name);
+	}
+
+}
+
+int main(int argc, char** argv) {
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Off);
+
+	Bench::IniShape shape;
+	shape.sections = 200;
+	shape.keysPerSection = 100;
+	const Bench::IniGenerator generator(shape);
+	const std::vector<Bench::GeneratedKey>& keys = generator.getKeys();
+	Bench::writeFile(kSitePath, generator.generate());
+
+	Scenario scenario;
+	for (size_t i = 0; i < keys.size(); i += 20) scenario.values.push_back({&keys[i], overrideValue(keys[i], 0)});
+	// An int key of the scenario gets a value that does not parse, so the site's stays. The
+	// first few are kept for the other checks.
+	const Bench::GeneratedKey* invalid = nullptr;
+	for (size_t i = 6; i < scenario.values.size() && !invalid; ++i) {
+		if (scenario.values[i].first->type != ConfigLib::ValueType::Int) continue;
+		invalid = scenario.values[i].first;
+		scenario.values[i].second = "twelve";
+	}
+	Bench::writeFile(kScenarioPath, scenario.text());
+
+	// Keys of the scenario overridden again by the environment, and one of them by the arguments
+	const Bench::GeneratedKey& environmentKey = keys[40];
+	const Bench::GeneratedKey& argumentKey = keys[60];
+	std::string environmentName = "CFG_" + environmentKey.section + "__" + environmentKey.name;
+	std::transform(environmentName.begin(), environmentName.end(), environmentName.begin(), [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+	setEnvironment(environmentName.c_str(), overrideValue(environmentKey, 1).c_str());
+	std::string argumentEnvironment = "CFG_" + argumentKey.section + "__" + argumentKey.name;
+	setEnvironment(argumentEnvironment.c_str(), overrideValue(argumentKey, 1).c_str());
+	const std::string argument = "--" + argumentKey.section + "." + argumentKey.name + "=" + overrideValue(argumentKey, 2);
+	std::vector<const char*> arguments(argv, argv + argc);
+	arguments.push_back(argument.c_str());
+	std::printf("input: %zu keys, %zu overridden by the scenario\n", keys.size(), scenario.values.size());
+
+	const int runs = 7;
+	double handBest = 1e9;
+	double layeredBest = 1e9;
+	const std::string scenarioText = scenario.text();
+	for (int run = 0; run < runs; ++run) {
+		Bench::GeneratedConfig config(generator, kSitePath);
+		Bench::Timer timer;
+		config.initialize();
+		config.loadFromBuffer(scenarioText);
+		handBest = std::min(handBest, timer.elapsedSeconds() * 1e3);
+	}
+	for (int run = 0; run < runs; ++run) {
+		Bench::GeneratedConfig config(generator, kSitePath);
+		ConfigLib::LayeredConfig layers(config);
+		layers.add(ConfigLib::ConfigLayer::defaults()).add(ConfigLib::ConfigLayer::file(kSitePath))
+			.add(ConfigLib::ConfigLayer::file(kScenarioPath)).add(ConfigLib::ConfigLayer::environment())
+			.add(ConfigLib::ConfigLayer::arguments(static_cast<int>(arguments.size()), arguments.data()));
+		Bench::Timer timer;
+		layers.load();
+		layeredBest = std::min(layeredBest, timer.elapsedSeconds() * 1e3);
+	}
+	std::printf("%-40s %10.2f ms\n", "initialize() + loadFromBuffer()", handBest);
+	std::printf("%-40s %10.2f ms\n", "LayeredConfig::load(), 5 layers", layeredBest);
+
+	Bench::GeneratedConfig hand(generator, kSitePath);
+	hand.initialize();
+	hand.loadFromBuffer(scenarioText);
+	Bench::GeneratedConfig config(generator, kSitePath);
+	ConfigLib::LayeredConfig layers(config);
+	layers.add(ConfigLib::ConfigLayer::defaults()).add(ConfigLib::ConfigLayer::file(kSitePath))
+		.add(ConfigLib::ConfigLayer::file(kScenarioPath)).add(ConfigLib::ConfigLayer::environment())
+		.add(ConfigLib::ConfigLayer::arguments(static_cast<int>(arguments.size()), arguments.data()));
+	layers.load();
+
+	bool ok = true;
+	{
+		const ConfigLib::ConfigSnapshot handValues = hand.snapshot();
+		const ConfigLib::ConfigSnapshot layeredValues = config.snapshot();
+		size_t differing = 0;
+		for (const auto& key : keys) {
+			if (&key == invalid || &key == &environmentKey || &key == &argumentKey) continue;
+			const ConfigLib::StoredValue* a = find(handValues, key);
+			const ConfigLib::StoredValue* b = find(layeredValues, key);
+			if (!a || !b || !(*a == *b)) ++differing;
+		}
+		std::printf("%-40s %10zu\n", "values differing from the hand merge", differing);
+		ok = ok && differing == 0;
+	}
+
+	// Precedence and provenance
+	const auto origin = [&](const Bench::GeneratedKey& key) {
+		const ConfigLib::ConfigLayer* layer = layers.getOrigin(key.section, key.name);
+		return layer ? layer->getName() : std::string("none");
+	};
+	ok = ok && origin(keys[1]) == kSitePath && origin(keys[20]) == kScenarioPath;
+	ok = ok && origin(environmentKey) == "CFG_" && origin(argumentKey) == "arguments";
+	ok = ok && origin(*invalid) == kSitePath && config.getValue<int>(invalid->section, invalid->name) == std::stoi(invalid->value);
+	const std::vector<ConfigLib::ConfigViolation> violations = layers.getViolations();
+	ok = ok && violations.size() == 1 && violations[0].key == invalid->name && violations[0].value == "twelve"
+		&& violations[0].reason.find(kScenarioPath) != std::string::npos;
+	ok = ok && config.getLoadViolations().size() == 1;
+
+	// One value of the scenario changes; one value overridden from above changes too, and is hidden
+	const auto& changedValue = scenario.values[5];
+	scenario.values[5].second = overrideValue(*changedValue.first, 5);
+	for (auto& value : scenario.values) {
+		if (value.first == &environmentKey) value.second = overrideValue(environmentKey, 6);
+	}
+	Bench::writeFile(kScenarioPath, scenario.text());
+	double reloadBest = 1e9;
+	ConfigLib::ConfigChangeSet changes;
+	for (int run = 0; run < runs; ++run) {
+		Bench::Timer timer;
+		ConfigLib::ConfigChangeSet result = layers.reloadLayer(2);
+		reloadBest = std::min(reloadBest, timer.elapsedSeconds() * 1e3);
+		if (run == 0) changes = std::move(result);
+	}
+	std::printf("%-40s %10.2f ms\n", "reloadLayer(), 1 of 1000 keys changed", reloadBest);
+	std::printf("%-40s %10zu\n", "keys reported changed", changes.changes.size());
+	ok = ok && changes.changes.size() == 1 && changes.changes[0].key == changedValue.first->name;
+	ok = ok && origin(environmentKey) == "CFG_";
+
+	// Replacing the arguments hands the key back to the environment
+	const ConfigLib::ConfigChangeSet dropped = layers.setLayer(4, ConfigLib::ConfigLayer::arguments(argc, argv));
+	ok = ok && dropped.changes.size() == 1 && origin(argumentKey) == "CFG_";
+
+	Bench::removeFile(kScenarioPath);
+	Bench::removeFile(kSitePath);
+	std::printf("layered values match: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
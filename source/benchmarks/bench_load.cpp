@@ -0,0 +1,60 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/ini_tokenizer.hpp"
+#include "config_library/mapped_file.hpp"
+#include <cstdio>
+#include <string>
+
+// Load throughput on a generated multi-megabyte INI file: raw tokenizing of the mapped file,
+// and a full ConfigReader load into typed values.
+
+namespace {
+
+	const char* const kConfigPath = "bench_load.ini";
+
+	// Ints, doubles and short lists, most with a trailing comment
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 200;
+		shape.keysPerSection = 500;
+		shape.stringWeight = 0;
+		shape.commentDensity = 0.8;
+		return shape;
+	}
+
+}
+
+int main() {
+	const Bench::IniGenerator generator(shape());
+	const std::string contents = generator.generate();
+	Bench::writeFile(kConfigPath, contents);
+	const double megabytes = contents.size() / (1024.0 * 1024.0);
+	std::printf("input: %.2f MB, %zu keys\n", megabytes, generator.getKeys().size());
+
+	{
+		Bench::Timer timer;
+		ConfigLib::MappedFile file(kConfigPath);
+		ConfigLib::IniTokenizer tokenizer(file.view());
+		ConfigLib::IniToken token;
+		size_t keyValues = 0;
+		while (tokenizer.next(token)) {
+			if (token.kind == ConfigLib::IniToken::Kind::KeyValue) ++keyValues;
+		}
+		double seconds = timer.elapsedSeconds();
+		Bench::doNotOptimize(keyValues);
+		std::printf("%-40s %12.1f MB/s\n", "tokenize (mapped)", megabytes / seconds);
+	}
+
+	{
+		Bench::GeneratedConfig config(generator, kConfigPath);
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		config.initialize();
+		double seconds = timer.elapsedSeconds();
+		size_t allocations = Bench::allocationCount() - allocationsBefore;
+		std::printf("%-40s %12.1f MB/s %12zu allocations\n", "ConfigReader::initialize", megabytes / seconds, allocations);
+	}
+
+	Bench::removeFile(kConfigPath);
+	return 0;
+}
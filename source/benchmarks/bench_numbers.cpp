@@ -0,0 +1,95 @@
+#include "bench_common.hpp"
+#include "config_library/number_codec.hpp"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares NumberCodec with the std::stod/std::stoi/std::to_string path the loader and
+// saveConfig() used before, on the kind of values found in large numeric config files.
+
+namespace {
+
+	const size_t kValues = 1000000;
+
+	template<typename F>
+	void run(const char* name, size_t count, F body) {
+		size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		body();
+		double elapsed = timer.elapsedNanoseconds();
+		size_t allocations = Bench::allocationCount() - allocationsBefore;
+		Bench::report(name, elapsed / count, static_cast<double>(allocations) / count);
+	}
+
+}
+
+int main() {
+	std::mt19937_64 rng(42);
+	std::uniform_real_distribution<double> doubles(-1e6, 1e6);
+	std::uniform_int_distribution<int> ints(-1000000, 1000000);
+
+	std::vector<double> doubleValues(kValues);
+	std::vector<std::string> doubleTexts(kValues);
+	std::vector<std::string> intTexts(kValues);
+	for (size_t i = 0; i < kValues; ++i) {
+		doubleValues[i] = doubles(rng);
+		doubleTexts[i] = ConfigLib::NumberCodec::formatDouble(doubleValues[i]);
+		intTexts[i] = ConfigLib::NumberCodec::formatInt(ints(rng));
+	}
+
+	double doubleSum = 0.0;
+	long long intSum = 0;
+
+	run("parse double: std::stod", kValues, [&] {
+		for (const auto& text : doubleTexts) doubleSum += std::stod(text);
+	});
+	run("parse double: NumberCodec", kValues, [&] {
+		for (const auto& text : doubleTexts) {
+			double value;
+			if (ConfigLib::NumberCodec::parseDouble(text, value)) doubleSum += value;
+		}
+	});
+	run("parse int: std::stoi", kValues, [&] {
+		for (const auto& text : intTexts) intSum += std::stoi(text);
+	});
+	run("parse int: NumberCodec", kValues, [&] {
+		for (const auto& text : intTexts) {
+			int value;
+			if (ConfigLib::NumberCodec::parseInt(text, value)) intSum += value;
+		}
+	});
+
+	size_t toStringExact = 0;
+	size_t codecExact = 0;
+	run("format double: std::to_string", kValues, [&] {
+		for (double value : doubleValues) {
+			std::string text = std::to_string(value);
+			toStringExact += std::stod(text) == value;
+		}
+	});
+	run("format double: NumberCodec", kValues, [&] {
+		for (double value : doubleValues) {
+			std::string text = ConfigLib::NumberCodec::formatDouble(value);
+			double parsed;
+			codecExact += ConfigLib::NumberCodec::parseDouble(text, parsed) && parsed == value;
+		}
+	});
+
+	std::string list;
+	for (size_t i = 0; i < 100000; ++i) {
+		if (i > 0) list += ", ";
+		list += doubleTexts[i];
+	}
+	run("parse 100k-element list: NumberCodec", 100000, [&] {
+		std::vector<double> values;
+		ConfigLib::NumberCodec::parseDoubleList(list, values);
+		doubleSum += values.back();
+	});
+
+	Bench::doNotOptimize(doubleSum);
+	Bench::doNotOptimize(intSum);
+	std::printf("round-trip exact: std::to_string %zu/%zu, NumberCodec %zu/%zu\n",
+				toStringExact, kValues, codecExact, kValues);
+	return 0;
+}
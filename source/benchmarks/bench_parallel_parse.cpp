@@ -0,0 +1,135 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/hash_bytes.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// reload() of a generated table of 1M keys over 4000 sections, parsed serially and split at
+// section boundaries over 2 threads up to twice the hardware threads. Some sections appear
+// twice and some values break their rule, so the parallel merge must reproduce last-writer-wins
+// and the violation order of the serial parse exactly.
+
+namespace {
+
+	const char* const kConfigPath = "bench_parallel_parse.ini";
+
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 4000;
+		shape.keysPerSection = 250;
+		shape.stringWeight = 0;
+		shape.commentDensity = 0.0;
+		return shape;
+	}
+
+	void appendKey(std::string& contents, const Bench::GeneratedKey& key, size_t index, bool second) {
+		contents += key.name + " = ";
+		if (key.type == ConfigLib::ValueType::Int && index % 1000 == 0) {
+			// Every 1000th key, when an int, breaks greaterThanOrEqualToZero
+			contents += "-1";
+		} else {
+			contents += key.value;
+			// A second occurrence changes every scalar it repeats
+			if (second && key.type != ConfigLib::ValueType::DoubleVector) contents += "1";
+		}
+		contents += " # generated value\n";
+	}
+
+	// The generator's keys, laid out here so that sections can be split and repeated
+	std::string generate(const Bench::IniGenerator& generator) {
+		const Bench::IniShape& sizes = generator.getShape();
+		const auto& keys = generator.getKeys();
+		std::string contents = "# Generated benchmark input\n\n";
+		for (int s = 0; s < sizes.sections; ++s) {
+			const size_t first = static_cast<size_t>(s) * sizes.keysPerSection;
+			contents += "[" + keys[first].section + "]\n";
+			// Every 7th section leaves a few keys to its second occurrence
+			const int count = s % 7 == 0 ? sizes.keysPerSection - 10 : sizes.keysPerSection;
+			for (int k = 0; k < count; ++k) appendKey(contents, keys[first + k], first + k, false);
+			contents += "\n";
+		}
+		// Second occurrences, far from the first, overriding some keys and adding the missing ones
+		for (int s = 0; s < sizes.sections; s += 7) {
+			const size_t first = static_cast<size_t>(s) * sizes.keysPerSection;
+			contents += "[" + keys[first].section + "]\n";
+			for (int k = sizes.keysPerSection - 1; k >= sizes.keysPerSection - 20; --k) {
+				appendKey(contents, keys[first + k], first + k, true);
+			}
+			contents += "\n";
+		}
+		// A section that appears only at the end, with keys the schema does not know
+		contents += "[Unknown]\n" + keys[0].name + " = 1\n";
+		return contents;
+	}
+
+	// Sections, keys and values in stored order, and the violations in reported order
+	uint64_t digest(const Bench::GeneratedConfig& config) {
+		std::string text;
+		for (const auto& section : config.getSections()) {
+			text += "[" + std::string(section.getName()) + "]\n";
+			for (const auto& entry : section.getEntries()) {
+				if (!entry.value.empty()) text += std::string(entry.key) + "=" + entry.value.toString() + "\n";
+			}
+		}
+		for (const auto& violation : config.getLoadViolations()) {
+			text += violation.section + "." + violation.key + "=" + violation.value + "\n";
+		}
+		return ConfigLib::hashBytes(text);
+	}
+
+	// Best of runs reloads, in milliseconds
+	double timeReload(Bench::GeneratedConfig& config, size_t threshold, unsigned threads, uint64_t& result) {
+		config.setParallelParse(threshold, threads);
+		double best = 1e9;
+		for (int run = 0; run < 5; ++run) {
+			Bench::Timer timer;
+			config.reload();
+			best = std::min(best, timer.elapsedSeconds() * 1e3);
+		}
+		result = digest(config);
+		return best;
+	}
+
+}
+
+int main() {
+	const Bench::IniGenerator generator(shape());
+	const std::string contents = generate(generator);
+	Bench::writeFile(kConfigPath, contents);
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Error);
+
+	Bench::GeneratedConfig config(generator, kConfigPath);
+	config.setParallelParse(SIZE_MAX);
+	config.initialize();
+
+	const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("%.1f MB, %zu keys, %zu violations, %u hardware threads\n", contents.size() / 1e6,
+		generator.getKeys().size(), config.getLoadViolations().size(), hardware);
+
+	uint64_t expected = 0;
+	const double serialMs = timeReload(config, SIZE_MAX, 1, expected);
+	std::printf("%-40s %10.2f ms\n", "reload(), serial", serialMs);
+
+	bool ok = !config.getLoadViolations().empty();
+	for (unsigned threads = 2; threads <= std::max(4u, 2 * hardware) && threads <= 16; threads *= 2) {
+		uint64_t result = 0;
+		const double ms = timeReload(config, 0, threads, result);
+		ok = ok && result == expected;
+		const std::string name = "reload(), " + std::to_string(threads) + " threads";
+		std::printf("%-40s %10.2f ms %8.2fx\n", name.c_str(), ms, serialMs / ms);
+	}
+	// The default threshold, so that the automatic switch is exercised too
+	uint64_t result = 0;
+	const double ms = timeReload(config, ConfigLib::ConfigReader::kDefaultParallelParseThreshold, 0, result);
+	ok = ok && result == expected;
+	std::printf("%-40s %10.2f ms %8.2fx\n", "reload(), default threshold", ms, serialMs / ms);
+	std::printf("identical to the serial parse: %s\n", ok ? "yes" : "no");
+
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
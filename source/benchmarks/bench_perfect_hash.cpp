@@ -0,0 +1,138 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/perfect_hash.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Lookups by name of keys the schema declares: through the section table and then the key's,
+// and with setSchemaLookup() through the schema's minimal perfect hash and the generation's key
+// table, over a generated 20k-key file with keys read in a shuffled order. Also times building
+// the hash as part of the schema index, and checks that it places every key on its own slot,
+// that both paths read the same values, and that keys outside the schema are still not found.
+
+namespace {
+
+	const char* const kConfigPath = "bench_perfect_hash.ini";
+
+	struct Name {
+		std::string section;
+		std::string key;
+	};
+
+	// ns per getValue<double>
+	double timeReads(const Bench::GeneratedConfig& config, const std::vector<Name>& names, size_t reads) {
+		double sum = 0.0;
+		Bench::Timer timer;
+		for (size_t i = 0; i < reads; ++i) {
+			const Name& name = names[i % names.size()];
+			sum += config.getValue<double>(name.section, name.key);
+		}
+		const double nanoseconds = timer.elapsedNanoseconds() / reads;
+		Bench::doNotOptimize(sum);
+		return nanoseconds;
+	}
+
+	// ns per hasValue() of a key the schema lacks
+	double timeMisses(const Bench::GeneratedConfig& config, const std::vector<Name>& names, size_t reads, size_t& found) {
+		found = 0;
+		Bench::Timer timer;
+		for (size_t i = 0; i < reads; ++i) {
+			const Name& name = names[i % names.size()];
+			found += config.hasValue(name.section, name.key);
+		}
+		return timer.elapsedNanoseconds() / reads;
+	}
+
+}
+
+int main() {
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Off);
+
+	Bench::IniShape shape;
+	shape.sections = 200;
+	shape.keysPerSection = 100;
+	const Bench::IniGenerator generator(shape);
+	Bench::writeFile(kConfigPath, generator.generate());
+	std::printf("input: %zu keys in %d sections\n", generator.getKeys().size(), shape.sections);
+
+	// Doubles in a fixed shuffled order, so that reads do not walk the tables in memory order
+	std::vector<Name> doubles;
+	std::vector<Name> missing;
+	for (const auto& key : generator.getKeys()) {
+		if (key.type == ConfigLib::ValueType::Double) doubles.push_back({key.section, key.name});
+		missing.push_back({key.section, key.name + "_x"});
+	}
+	uint64_t state = 1;
+	for (size_t i = doubles.size(); i > 1; --i) {
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		std::swap(doubles[i - 1], doubles[(state >> 33) % i]);
+	}
+	for (size_t i = 0; i < 100; ++i) missing.push_back({"NoSuchSection" + std::to_string(i), doubles[i].key});
+
+	bool ok = true;
+	const int runs = 7;
+	double buildBest = 1e9;
+	ConfigLib::ConfigGen::SchemaIndex index;
+	const std::vector<ConfigLib::ConfigGen::ConfigSection> schema = generator.getSchema();
+	for (int run = 0; run < runs; ++run) {
+		Bench::Timer timer;
+		index.build(schema);
+		buildBest = std::min(buildBest, timer.elapsedSeconds() * 1e3);
+	}
+	std::printf("%-40s %10.2f ms\n", "SchemaIndex::build(), with perfect hash", buildBest);
+	{
+		// Every key finds its own position, which leaves no slot to share
+		size_t misplaced = 0;
+		for (size_t i = 0; i < index.size(); ++i) {
+			const ConfigLib::ConfigGen::SchemaEntry& entry = index.getEntries()[i];
+			if (index.findPosition(entry.section, entry.key) != i || index.find(entry.section, entry.key) != &entry) ++misplaced;
+		}
+		std::printf("%-40s %10zu\n", "keys not found at their position", misplaced);
+		ok = ok && misplaced == 0;
+	}
+
+	Bench::GeneratedConfig tables(generator, kConfigPath);
+	tables.initialize();
+	Bench::GeneratedConfig hashed(generator, kConfigPath);
+	hashed.setSchemaLookup(true);
+	hashed.initialize();
+	const size_t reads = 4000000;
+	std::printf("%-40s %10.2f ns\n", "getValue<double>, section and key tables", timeReads(tables, doubles, reads));
+	std::printf("%-40s %10.2f ns\n", "getValue<double>, perfect hash", timeReads(hashed, doubles, reads));
+	size_t foundTables = 0;
+	size_t foundHashed = 0;
+	std::printf("%-40s %10.2f ns\n", "hasValue() miss, section and key tables", timeMisses(tables, missing, reads, foundTables));
+	std::printf("%-40s %10.2f ns\n", "hasValue() miss, perfect hash", timeMisses(hashed, missing, reads, foundHashed));
+	ok = ok && foundTables == 0 && foundHashed == 0;
+
+	{
+		size_t differing = 0;
+		const ConfigLib::ConfigSnapshot a = tables.snapshot();
+		const ConfigLib::ConfigSnapshot b = hashed.snapshot();
+		for (const auto& key : generator.getKeys()) {
+			const ConfigLib::StoredValue* x = a.getGeneration().findValue(key.section, key.name);
+			const ConfigLib::StoredValue* y = b.getGeneration().findValue(key.section, key.name);
+			if (!x || !y || !(*x == *y)) ++differing;
+		}
+		std::printf("%-40s %10zu\n", "values differing between the two", differing);
+		ok = ok && differing == 0;
+	}
+
+	// Writes and snapshot mode go through the same table
+	Bench::GeneratedConfig shared(generator, kConfigPath);
+	shared.setSchemaLookup(true);
+	shared.initialize();
+	shared.setSnapshotMode(true);
+	shared.setValue(doubles[0].section, doubles[0].key, 42.5);
+	ok = ok && shared.getValue<double>(doubles[0].section, doubles[0].key) == 42.5
+		&& shared.snapshot().getValue<double>(doubles[0].section, doubles[0].key) == 42.5
+		&& !shared.hasValue(missing[0].section, missing[0].key);
+
+	Bench::removeFile(kConfigPath);
+	std::printf("perfect hash lookups match: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
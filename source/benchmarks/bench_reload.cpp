@@ -0,0 +1,74 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Repeated reloads of a 100k-key file, once with every generation on the global heap and
+// once with per-generation arenas. Each mode runs in its own child process so that peak RSS
+// is measured independently. Between reloads the "application" keeps a few small objects
+// alive, which is what pins freed heap pages in a long-running process.
+
+namespace {
+
+	const char* const kConfigPath = "bench_reload.ini";
+	const int kReloads = 20;
+
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 100;
+		shape.keysPerSection = 1000;
+		shape.vectorLength = 6;
+		shape.commentDensity = 0.0;
+		return shape;
+	}
+
+	void run(const Bench::IniGenerator& generator, bool arena) {
+		Bench::GeneratedConfig config(generator, kConfigPath);
+		config.setArenaEnabled(arena);
+		config.initialize();
+
+		std::vector<std::unique_ptr<std::string>> retained;
+		const size_t allocationsBefore = Bench::allocationCount();
+		Bench::Timer timer;
+		for (int i = 0; i < kReloads; ++i) {
+			config.reload();
+			for (int j = 0; j < 2000; ++j) {
+				retained.push_back(std::make_unique<std::string>("application state kept across reloads"));
+			}
+		}
+		const double seconds = timer.elapsedSeconds();
+		// Exclude the retained objects: one string and one vector slot each, plus vector growth
+		const size_t allocations = Bench::allocationCount() - allocationsBefore - retained.size();
+
+		std::printf("%-8s %10.1f ms/reload %12.0f allocs/reload   RSS %7zu KiB   peak RSS %7zu KiB\n",
+			arena ? "arena" : "heap", seconds * 1e3 / kReloads, static_cast<double>(allocations) / kReloads,
+			Bench::currentRssKilobytes(), Bench::peakRssKilobytes());
+	}
+
+	void runInChild(const Bench::IniGenerator& generator, bool arena) {
+		std::fflush(stdout);
+		const pid_t pid = fork();
+		if (pid == 0) {
+			run(generator, arena);
+			std::fflush(stdout);
+			_exit(0);
+		}
+		int status = 0;
+		waitpid(pid, &status, 0);
+	}
+
+}
+
+int main() {
+	const Bench::IniGenerator generator(shape());
+	Bench::writeFile(kConfigPath, generator.generate());
+	std::printf("%zu keys, %d reloads\n", generator.getKeys().size(), kReloads);
+	runInChild(generator, false);
+	runInChild(generator, true);
+	Bench::removeFile(kConfigPath);
+	return 0;
+}
@@ -0,0 +1,165 @@
+#include "bench_common.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/config_repository.hpp"
+#include "config_library/hash_bytes.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ConfigRepository::loadAll() over a synthetic corpus of 1000 scenario files, against the
+// serial initialize() loop it replaces, from 1 thread up to twice the hardware threads. Every
+// run must produce identical values, violations and errors for every file.
+
+namespace {
+
+	const int kFiles = 1000;
+	const int kSections = 10;
+	const int kKeysPerSection = 20;
+
+	const char* const kTypes[] = {"int", "double", "vector<double>", "string"};
+
+	std::string pathOf(int file) { return "bench_repository_" + std::to_string(file) + ".ini"; }
+
+	std::vector<ConfigLib::ConfigGen::ConfigSection> schema() {
+		// The item strings must outlive every reader
+		static const std::vector<std::string> names = [] {
+			std::vector<std::string> names;
+			for (int k = 0; k < kKeysPerSection; ++k) names.push_back("parameter_" + std::to_string(k));
+			return names;
+		}();
+		std::vector<ConfigLib::ConfigGen::ConfigSection> sections;
+		for (int s = 0; s < kSections; ++s) {
+			ConfigLib::ConfigGen::ConfigSection section;
+			section.name = "Scenario" + std::to_string(s);
+			for (int k = 0; k < kKeysPerSection; ++k) {
+				const ValidationRules::Rule* rule = k % 4 < 2 ? &ValidationRules::greaterThanZero : nullptr;
+				section.items.push_back({names[k].c_str(), kTypes[k % 4], "1", "generated", rule});
+			}
+			sections.push_back(std::move(section));
+		}
+		return sections;
+	}
+
+	// Every 100th file has one value its rule rejects
+	std::string generate(int file) {
+		std::string contents;
+		for (int s = 0; s < kSections; ++s) {
+			contents += "[Scenario" + std::to_string(s) + "]\n";
+			for (int k = 0; k < kKeysPerSection; ++k) {
+				const int value = file % 100 == 0 && s == 0 && k == 0 ? -1 : file + s + k + 1;
+				contents += "parameter_" + std::to_string(k) + " = ";
+				switch (k % 4) {
+					case 0: contents += std::to_string(value); break;
+					case 1: contents += std::to_string(value * 0.25); break;
+					case 2: contents += std::to_string(value) + ", 2.5, 3.75"; break;
+					default: contents += "scenario " + std::to_string(value); break;
+				}
+				contents += "\n";
+			}
+			contents += "\n";
+		}
+		return contents;
+	}
+
+	// A reader whose schema cannot be produced, to exercise per-file errors
+	class BrokenConfig : public ConfigLib::ConfigReader {
+	public:
+		std::string getConfigFilePath() const override { return "bench_repository_broken.ini"; }
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override {
+			throw std::runtime_error("schema unavailable");
+		}
+	};
+
+	void fill(ConfigLib::ConfigRepository& repository) {
+		const std::vector<ConfigLib::ConfigGen::ConfigSection> sections = schema();
+		for (int file = 0; file < kFiles; ++file) {
+			if (file == kFiles / 2) repository.add(std::make_unique<BrokenConfig>());
+			repository.add(pathOf(file), sections);
+		}
+	}
+
+	// Digest of everything a load produced, in a fixed order
+	uint64_t digest(const ConfigLib::ConfigRepository& repository, const std::vector<ConfigLib::ConfigLoadResult>& results) {
+		std::string text;
+		for (size_t i = 0; i < results.size(); ++i) {
+			text += results[i].path + (results[i].loaded ? " ok " : " failed ") + results[i].error + "\n";
+			for (const auto& violation : results[i].violations) text += violation.section + "." + violation.key + "\n";
+			if (!results[i].loaded) continue;
+			for (const auto& section : repository.get(i).getSections()) {
+				for (const auto& entry : section.getEntries()) {
+					if (!entry.value.empty()) text += std::string(entry.key) + "=" + entry.value.toString() + "\n";
+				}
+			}
+		}
+		return ConfigLib::hashBytes(text);
+	}
+
+	double timeSerial(uint64_t& result) {
+		ConfigLib::ConfigRepository repository;
+		fill(repository);
+		std::vector<ConfigLib::ConfigLoadResult> results(repository.size());
+		Bench::Timer timer;
+		for (size_t i = 0; i < repository.size(); ++i) {
+			results[i].path = repository.get(i).getConfigFilePath();
+			try {
+				repository.get(i).initialize();
+				results[i].loaded = true;
+				results[i].violations = repository.get(i).getLoadViolations();
+			} catch (const std::exception& e) {
+				results[i].error = e.what();
+			}
+		}
+		const double ms = timer.elapsedSeconds() * 1e3;
+		result = digest(repository, results);
+		return ms;
+	}
+
+	double timeParallel(unsigned threads, uint64_t& result, size_t& failed, size_t& violations) {
+		ConfigLib::ConfigRepository repository;
+		fill(repository);
+		Bench::Timer timer;
+		const std::vector<ConfigLib::ConfigLoadResult> results = repository.loadAll(threads);
+		const double ms = timer.elapsedSeconds() * 1e3;
+		result = digest(repository, results);
+		failed = std::count_if(results.begin(), results.end(), [](const ConfigLib::ConfigLoadResult& r) { return !r.loaded; });
+		violations = 0;
+		for (const auto& r : results) violations += r.violations.size();
+		return ms;
+	}
+
+}
+
+int main() {
+	for (int file = 0; file < kFiles; ++file) Bench::writeFile(pathOf(file), generate(file));
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Off);
+
+	const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	std::printf("%d files of %d keys, %u hardware threads\n", kFiles, kSections * kKeysPerSection, hardware);
+
+	const int runs = 3;
+	uint64_t expected = 0;
+	double serialMs = 1e9;
+	for (int run = 0; run < runs; ++run) serialMs = std::min(serialMs, timeSerial(expected));
+	std::printf("%-40s %10.2f ms\n", "serial initialize()", serialMs);
+
+	bool ok = true;
+	for (unsigned threads = 1; threads <= 2 * hardware && threads <= 16; threads *= 2) {
+		double best = 1e9;
+		for (int run = 0; run < runs; ++run) {
+			uint64_t result = 0;
+			size_t failed = 0, violations = 0;
+			best = std::min(best, timeParallel(threads, result, failed, violations));
+			ok = ok && result == expected && failed == 1 && violations == kFiles / 100;
+		}
+		const std::string name = "loadAll(), " + std::to_string(threads) + " threads";
+		std::printf("%-40s %10.2f ms %8.2fx\n", name.c_str(), best, serialMs / best);
+	}
+	std::printf("identical results for every thread count: %s\n", ok ? "yes" : "no");
+
+	for (int file = 0; file < kFiles; ++file) Bench::removeFile(pathOf(file));
+	return ok ? 0 : 1;
+}
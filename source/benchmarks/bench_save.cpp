@@ -0,0 +1,149 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/mapped_file.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// saveConfig() after changing one key of a generated 200k-key file with comments, against the
+// full rewrite it replaces (every value formatted and streamed out). The saved file must differ
+// from the original only in the changed value, added keys must land at the end of their
+// section, and reloading must give back what was set.
+
+namespace {
+
+	const char* const kConfigPath = "bench_save.ini";
+
+	// Doubles and lists, each key with a comment line and a trailing comment
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 1000;
+		shape.keysPerSection = 200;
+		shape.intWeight = 0;
+		shape.stringWeight = 0;
+		shape.vectorLength = 3;
+		shape.commentDensity = 1.0;
+		return shape;
+	}
+
+	// Indexes of the double keys of section, in file order
+	std::vector<size_t> doubleKeys(const Bench::IniGenerator& generator, const std::string& section) {
+		std::vector<size_t> found;
+		const auto& keys = generator.getKeys();
+		for (size_t i = 0; i < keys.size(); ++i) {
+			if (keys[i].section == section && keys[i].type == ConfigLib::ValueType::Double) found.push_back(i);
+		}
+		return found;
+	}
+
+	std::string readFile(const std::string& path) {
+		ConfigLib::MappedFile file(path);
+		return std::string(file.view());
+	}
+
+	// What saveConfig() did before: every stored value formatted and written out
+	void fullRewrite(const ConfigLib::ConfigReader& config, const std::string& path) {
+		std::ofstream file(path);
+		for (const auto& section : config.getSections()) {
+			file << "[" << section.getName() << "]\n";
+			for (const auto& entry : section.getEntries()) {
+				if (entry.value.empty()) continue;
+				file << entry.key << " = " << entry.value.toString() << "\n";
+			}
+			file << "\n";
+		}
+	}
+
+	bool noTemporariesLeft() {
+		for (const auto& entry : std::filesystem::directory_iterator(".")) {
+			if (entry.path().filename().string().rfind(std::string(kConfigPath) + ".tmp", 0) == 0) return false;
+		}
+		return true;
+	}
+
+}
+
+int main() {
+	Bench::IniGenerator generator(shape());
+	const auto& keys = generator.getKeys();
+	// One key of Section7 is declared but left out of the file, to be added by a save
+	const std::string addedSection = "Section7";
+	const std::vector<size_t> addedSectionDoubles = doubleKeys(generator, addedSection);
+	const Bench::GeneratedKey& added = keys[addedSectionDoubles.back()];
+	generator.omit(addedSectionDoubles.back());
+
+	const std::string original = generator.generate();
+	Bench::writeFile(kConfigPath, original);
+	std::printf("input: %.2f MB, %zu keys\n", original.size() / (1024.0 * 1024.0), keys.size() - 1);
+
+	Bench::GeneratedConfig config(generator, kConfigPath);
+	config.initialize();
+	const int runs = 5;
+	bool ok = true;
+
+	{
+		double best = 1e9;
+		for (int run = 0; run < runs; ++run) {
+			Bench::Timer timer;
+			fullRewrite(config, "bench_save_full.ini");
+			best = std::min(best, timer.elapsedSeconds());
+		}
+		Bench::removeFile("bench_save_full.ini");
+		std::printf("%-40s %10.2f ms\n", "full rewrite (previous saveConfig)", best * 1e3);
+	}
+
+	{
+		const std::string section = "Section" + std::to_string(shape().sections / 2);
+		const std::string key = keys[doubleKeys(generator, section).front()].name;
+		double best = 1e9;
+		for (int run = 0; run < runs; ++run) {
+			Bench::writeFile(kConfigPath, original);
+			config.reload();
+			config.setValue(section, key, 42.5);
+			Bench::Timer timer;
+			config.saveConfig();
+			best = std::min(best, timer.elapsedSeconds());
+		}
+		std::printf("%-40s %10.2f ms\n", "saveConfig(), one key changed", best * 1e3);
+
+		// Only the value changed, comment and all
+		std::string expected = original;
+		const size_t line = expected.find("\n" + key + " = ", expected.find("[" + section + "]\n")) + 1;
+		const size_t valueEnd = expected.find("   # generated", line);
+		const size_t valueBegin = line + key.size() + 3;
+		expected.replace(valueBegin, valueEnd - valueBegin, "42.5");
+		ok = ok && readFile(kConfigPath) == expected;
+
+		config.reload();
+		ok = ok && config.getValue<double>(section, key) == 42.5;
+	}
+
+	{
+		// A key the file lacks goes after the last key of its section, before the next header
+		const std::string& first = keys[addedSectionDoubles.front()].name;
+		config.setValue(addedSection, added.name, 7.25);
+		config.setValue(addedSection, first, 1.0);
+		Bench::Timer timer;
+		config.saveConfig();
+		const double seconds = timer.elapsedSeconds();
+		std::printf("%-40s %10.2f ms\n", "saveConfig(), one key added", seconds * 1e3);
+
+		const std::string saved = readFile(kConfigPath);
+		const std::string addedLine = added.name + " = 7.25\n\n[Section8]\n";
+		ok = ok && saved.find(addedLine) != std::string::npos && saved.find("# Synthetic benchmark input") != std::string::npos;
+		config.reload();
+		ok = ok && config.getValue<double>(addedSection, added.name) == 7.25
+			&& config.getValue<double>(addedSection, first) == 1.0;
+
+		// Nothing unsaved: the file is left alone
+		const auto modified = std::filesystem::last_write_time(kConfigPath);
+		config.saveConfig();
+		ok = ok && std::filesystem::last_write_time(kConfigPath) == modified && noTemporariesLeft();
+	}
+
+	Bench::removeFile(kConfigPath);
+	std::printf("only changed values rewritten, layout kept: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#include "bench_common.hpp"
+#include "config_library/config_reader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Read throughput from 1 to N threads: getValue behind an external mutex (what callers had to
+// do before), getValue in snapshot mode, and reads through one pinned snapshot per batch.
+// A writer thread keeps publishing new generations throughout, and every reader checks that
+// the value it sees is one the writer actually stored.
+
+namespace {
+
+	const char* const kConfigPath = "bench_snapshot.ini";
+
+	class BenchConfig : public ConfigLib::ConfigReader {
+	public:
+		std::string getConfigFilePath() const override { return kConfigPath; }
+
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override {
+			return {
+				{
+					"Simulation",
+					{
+						{"num_steps", "int", "252", "Number of time steps", nullptr},
+						{"volatility", "double", "0.25", "Asset price volatility", nullptr}
+					}
+				}
+			};
+		}
+
+		void load() { initialize(); }
+	};
+
+	enum class Mode { Mutex, Snapshot, PinnedSnapshot };
+
+	const char* modeName(Mode mode) {
+		switch (mode) {
+			case Mode::Mutex: return "getValue + std::mutex";
+			case Mode::Snapshot: return "getValue (snapshot mode)";
+			case Mode::PinnedSnapshot: return "snapshot(), 64 reads each";
+		}
+		return "";
+	}
+
+	// The writer only ever stores volatilities of the form k / 1024 for k in [256, 512)
+	bool plausible(double value) {
+		const double scaled = value * 1024.0;
+		return scaled >= 256.0 && scaled < 512.0 && scaled == static_cast<int>(scaled);
+	}
+
+	struct Result {
+		double readsPerSecond;
+		size_t implausible;
+	};
+
+	Result run(Mode mode, unsigned threads, double seconds) {
+		BenchConfig config;
+		config.load();
+		config.setSnapshotMode(mode != Mode::Mutex);
+
+		std::mutex guard;
+		std::atomic<bool> stop(false);
+		std::atomic<size_t> totalReads(0);
+		std::atomic<size_t> implausible(0);
+
+		std::thread writer([&] {
+			const std::string section = "Simulation";
+			const std::string key = "volatility";
+			for (int k = 0; !stop.load(std::memory_order_relaxed); k = (k + 1) % 256) {
+				if (mode == Mode::Mutex) {
+					std::lock_guard<std::mutex> lock(guard);
+					config.setValue(section, key, (256 + k) / 1024.0);
+				} else {
+					config.setValue(section, key, (256 + k) / 1024.0);
+				}
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+		});
+
+		std::vector<std::thread> readers;
+		for (unsigned t = 0; t < threads; ++t) {
+			readers.emplace_back([&] {
+				const std::string section = "Simulation";
+				const std::string key = "volatility";
+				size_t reads = 0;
+				size_t bad = 0;
+				while (!stop.load(std::memory_order_relaxed)) {
+					for (int i = 0; i < 64; ++i) {
+						double value;
+						if (mode == Mode::Mutex) {
+							std::lock_guard<std::mutex> lock(guard);
+							value = config.getValue<double>(section, key);
+						} else if (mode == Mode::Snapshot) {
+							value = config.getValue<double>(section, key);
+						} else {
+							break;
+						}
+						if (!plausible(value)) ++bad;
+						++reads;
+					}
+					if (mode == Mode::PinnedSnapshot) {
+						const ConfigLib::ConfigSnapshot snapshot = config.snapshot();
+						for (int i = 0; i < 64; ++i) {
+							if (!plausible(snapshot.getValue<double>(section, key))) ++bad;
+							++reads;
+						}
+					}
+				}
+				totalReads.fetch_add(reads);
+				implausible.fetch_add(bad);
+			});
+		}
+
+		std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+		stop.store(true);
+		for (auto& reader : readers) reader.join();
+		writer.join();
+		return {totalReads.load() / seconds, implausible.load()};
+	}
+
+}
+
+int main() {
+	Bench::writeFile(kConfigPath, "[Simulation]\nnum_steps = 252\nvolatility = 0.25\n");
+
+	const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<unsigned> threadCounts;
+	for (unsigned threads = 1; threads < hardware; threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(hardware);
+	std::printf("hardware threads: %u (one extra writer thread runs in every configuration)\n", hardware);
+
+	size_t implausible = 0;
+	for (Mode mode : {Mode::Mutex, Mode::Snapshot, Mode::PinnedSnapshot}) {
+		for (unsigned threads : threadCounts) {
+			const Result result = run(mode, threads, 0.5);
+			implausible += result.implausible;
+			std::printf("%-28s %3u threads %12.1f M reads/s\n", modeName(mode), threads, result.readsPerSecond / 1e6);
+		}
+	}
+	std::printf("reads of a value the writer never stored: %zu\n", implausible);
+
+	Bench::removeFile(kConfigPath);
+	return implausible == 0 ? 0 : 1;
+}
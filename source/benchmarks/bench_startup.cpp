@@ -0,0 +1,108 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Time for initialize() on a 100k-key file: parsing the text, compiling the cache on a first
+// start, and starting from a fresh cache. Also checks that a cached start yields exactly the
+// values of a text start, and that editing the file makes the cache stale.
+
+namespace {
+
+	const char* const kConfigPath = "bench_startup.ini";
+
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 100;
+		shape.keysPerSection = 1000;
+		shape.vectorLength = 6;
+		shape.commentDensity = 0.0;
+		return shape;
+	}
+
+	// The first int key of the file
+	size_t firstInt(const Bench::IniGenerator& generator) {
+		const auto& keys = generator.getKeys();
+		size_t i = 0;
+		while (keys[i].type != ConfigLib::ValueType::Int) ++i;
+		return i;
+	}
+
+	bool sameValues(const Bench::GeneratedConfig& a, const Bench::GeneratedConfig& b, size_t keys) {
+		const ConfigLib::ConfigSnapshot other = b.snapshot();
+		size_t count = 0;
+		for (const auto& section : a.getSections()) {
+			for (const auto& entry : section.getEntries()) {
+				if (entry.value.empty()) continue;
+				const ConfigLib::StoredValue* value = other.getGeneration().findValue(section.getName(), entry.key);
+				if (!value || *value != entry.value) return false;
+				++count;
+			}
+		}
+		return count == keys;
+	}
+
+	// Best of several starts, each with a new reader as a new process would have
+	double timeStart(const Bench::IniGenerator& generator, bool cached, int runs) {
+		double best = 1e9;
+		for (int run = 0; run < runs; ++run) {
+			Bench::Timer timer;
+			Bench::GeneratedConfig config(generator, kConfigPath);
+			config.setCacheEnabled(cached);
+			config.initialize();
+			best = std::min(best, timer.elapsedSeconds() * 1e3);
+		}
+		return best;
+	}
+
+}
+
+int main() {
+	Bench::IniGenerator generator(shape());
+	const size_t keys = generator.getKeys().size();
+	const std::string cachePath = ConfigLib::ConfigCache::pathFor(kConfigPath);
+	Bench::writeFile(kConfigPath, generator.generate());
+	Bench::removeFile(cachePath);
+	std::printf("%zu keys\n", keys);
+
+	const double textMs = timeStart(generator, false, 5);
+	const double compileMs = timeStart(generator, true, 1);
+	const double cachedMs = timeStart(generator, true, 5);
+	std::printf("%-40s %10.2f ms\n", "initialize(), text", textMs);
+	std::printf("%-40s %10.2f ms\n", "initialize(), compiling the cache", compileMs);
+	std::printf("%-40s %10.2f ms\n", "initialize(), from the cache", cachedMs);
+
+	bool ok = true;
+	{
+		Bench::GeneratedConfig text(generator, kConfigPath);
+		text.initialize();
+		Bench::GeneratedConfig cached(generator, kConfigPath);
+		cached.setCacheEnabled(true);
+		cached.initialize();
+		ok = sameValues(text, cached, keys) && sameValues(cached, text, keys);
+		std::printf("cached values match the text: %s\n", ok ? "yes" : "no");
+	}
+
+	// An edit that keeps the file size, so only the time and content hash give it away
+	const size_t edited = firstInt(generator);
+	const Bench::GeneratedKey& key = generator.getKeys()[edited];
+	std::string value = key.value;
+	value.back() = value.back() == '9' ? '8' : '9';
+	generator.setValue(edited, value);
+	Bench::writeFile(kConfigPath, generator.generate());
+	{
+		Bench::GeneratedConfig cached(generator, kConfigPath);
+		cached.setCacheEnabled(true);
+		cached.initialize();
+		const bool fresh = cached.getValue<int>(key.section, key.name) == std::stoi(value);
+		std::printf("edited file picked up: %s\n", fresh ? "yes" : "no");
+		ok = ok && fresh;
+	}
+
+	Bench::removeFile(kConfigPath);
+	Bench::removeFile(cachePath);
+	return ok ? 0 : 1;
+}
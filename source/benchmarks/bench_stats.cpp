@@ -0,0 +1,144 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/config_reader.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// What statistics cost: initialize() and getValue() with them off, on, and on with every read
+// counted, over a generated 20k-key file. Also checks what they report for a file with known
+// defects (a malformed line, a bad integer, two values a rule rejects), that the hottest key
+// comes out on top of the read counts, and that the trace names the load and its phases.
+
+namespace {
+
+	const char* const kConfigPath = "bench_stats.ini";
+	const char* const kTracePath = "bench_stats_trace.json";
+
+	const Bench::GeneratedKey& firstOfType(const Bench::IniGenerator& generator, ConfigLib::ValueType type) {
+		for (const auto& key : generator.getKeys()) {
+			if (key.type == type) return key;
+		}
+		return generator.getKeys().front();
+	}
+
+	// Best of runs, in ms
+	double timeInitialize(const Bench::IniGenerator& generator, bool stats, int runs) {
+		double best = 1e9;
+		for (int run = 0; run < runs; ++run) {
+			Bench::GeneratedConfig config(generator, kConfigPath);
+			config.setStatsEnabled(stats);
+			Bench::Timer timer;
+			config.initialize();
+			best = std::min(best, timer.elapsedSeconds() * 1e3);
+		}
+		return best;
+	}
+
+	// ns per read, over the double keys with the first read ten times as often as the others
+	double timeReads(Bench::GeneratedConfig& config, const std::vector<const Bench::GeneratedKey*>& keys, size_t reads) {
+		double sum = 0.0;
+		Bench::Timer timer;
+		for (size_t i = 0; i < reads; ++i) {
+			const Bench::GeneratedKey& key = *keys[i % 11 < 10 ? 0 : (i / 11) % keys.size()];
+			sum += config.getValue<double>(key.section, key.name);
+		}
+		const double nanoseconds = timer.elapsedNanoseconds() / reads;
+		Bench::doNotOptimize(sum);
+		return nanoseconds;
+	}
+
+}
+
+int main() {
+#if !CONFIG_STATS_ENABLED
+	std::printf("statistics are compiled out (CONFIG_STATS=OFF)\n");
+	return 0;
+#endif
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Off);
+
+	Bench::IniShape shape;
+	shape.sections = 200;
+	shape.keysPerSection = 100;
+	const Bench::IniGenerator generator(shape);
+	std::string contents = generator.generate();
+
+	// Defects, each in a section of its own so that they follow the values they replace
+	const auto& intKey = firstOfType(generator, ConfigLib::ValueType::Int);
+	const auto& doubleKey = firstOfType(generator, ConfigLib::ValueType::Double);
+	const auto& stringKey = firstOfType(generator, ConfigLib::ValueType::String);
+	contents += "\n[" + intKey.section + "]\nthis line is not ini\n" + intKey.name + " = twelve\n";
+	contents += "\n[" + doubleKey.section + "]\n" + doubleKey.name + " = -5\n";
+	contents += "\n[" + stringKey.section + "]\n" + stringKey.name + " = bogus\n";
+	Bench::writeFile(kConfigPath, contents);
+	std::printf("input: %.2f MB, %zu keys\n", contents.size() / (1024.0 * 1024.0), generator.getKeys().size());
+
+	const int runs = 7;
+	const double loadOff = timeInitialize(generator, false, runs);
+	const double loadOn = timeInitialize(generator, true, runs);
+	std::printf("%-40s %10.2f ms\n", "initialize(), statistics off", loadOff);
+	std::printf("%-40s %10.2f ms\n", "initialize(), statistics on", loadOn);
+
+	std::vector<const Bench::GeneratedKey*> doubles;
+	for (const auto& key : generator.getKeys()) {
+		if (key.type == ConfigLib::ValueType::Double && key.name != doubleKey.name) doubles.push_back(&key);
+	}
+	const size_t reads = 2000000;
+	bool ok = true;
+
+	Bench::GeneratedConfig config(generator, kConfigPath);
+	config.setStatsEnabled(true, 64);
+	config.initialize();
+	{
+		Bench::GeneratedConfig plain(generator, kConfigPath);
+		plain.initialize();
+		std::printf("%-40s %10.2f ns\n", "getValue<double>, statistics off", timeReads(plain, doubles, reads));
+	}
+	std::printf("%-40s %10.2f ns\n", "getValue<double>, 1 read in 64 counted", timeReads(config, doubles, reads));
+	{
+		Bench::GeneratedConfig every(generator, kConfigPath);
+		every.setStatsEnabled(true, 1);
+		every.initialize();
+		std::printf("%-40s %10.2f ns\n", "getValue<double>, every read counted", timeReads(every, doubles, reads));
+	}
+
+	const ConfigLib::ConfigStats stats = config.getStats();
+	std::printf("\nphases of the profiled initialize():\n");
+	for (size_t phase = 0; phase < ConfigLib::kLoadPhaseCount; ++phase) {
+		std::printf("  %-38s %10.3f ms\n", ConfigLib::loadPhaseName(static_cast<ConfigLib::LoadPhase>(phase)),
+			stats.phaseNanoseconds[phase] / 1e6);
+	}
+	std::printf("  parse errors %llu, validation failures %llu, defaulted keys %llu\n",
+		static_cast<unsigned long long>(stats.parseErrors), static_cast<unsigned long long>(stats.validationFailures),
+		static_cast<unsigned long long>(stats.defaultedKeys));
+	std::printf("most read keys (1 read in %u counted):\n", stats.readSamplePeriod);
+	for (size_t i = 0; i < std::min<size_t>(3, stats.keyReads.size()); ++i) {
+		std::printf("  %s.%s: ~%llu\n", stats.keyReads[i].section.c_str(), stats.keyReads[i].key.c_str(),
+			static_cast<unsigned long long>(stats.keyReads[i].reads));
+	}
+
+	ok = ok && stats.loads == 1 && stats.parseErrors == 2 && stats.validationFailures == 2 && stats.defaultedKeys == 3;
+	ok = ok && stats.totalNanoseconds() > 0 && stats.phaseNanoseconds[static_cast<size_t>(ConfigLib::LoadPhase::Tokenize)] > 0;
+	ok = ok && !stats.keyReads.empty() && stats.keyReads.front().section == doubles[0]->section
+		&& stats.keyReads.front().key == doubles[0]->name;
+	uint64_t counted = 0;
+	for (const auto& count : stats.keyReads) counted += count.reads;
+	ok = ok && counted == reads / 64 * 64;
+
+	const std::string trace = config.exportTrace();
+	Bench::writeFile(kTracePath, trace);
+	ok = ok && trace.find("\"name\": \"initialize\"") != std::string::npos && trace.find("\"name\": \"parse\"") != std::string::npos
+		&& trace.find("\"defaulted keys\": 3") != std::string::npos;
+	std::printf("trace: %zu bytes written to %s\n", trace.size(), kTracePath);
+
+	config.resetStats();
+	config.reload();
+	ok = ok && config.getStats().loads == 1 && config.getStats().keyReads.empty();
+
+	Bench::removeFile(kTracePath);
+	Bench::removeFile(kConfigPath);
+	std::printf("statistics match the input: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "bench_common.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/validation_rules.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Heap footprint per stored key and read latency of ConfigSection, for a section holding
+// a mix of int, double, string and vector<double> values with validation rules on the scalars.
+
+namespace {
+
+	struct Key {
+		std::string name;
+		int type;   // index into the int / double / string / vector rotation
+	};
+
+	std::vector<Key> makeKeys(size_t count) {
+		std::vector<Key> keys;
+		keys.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			keys.push_back({"parameter_" + std::to_string(i), static_cast<int>(i % 4)});
+		}
+		return keys;
+	}
+
+	void populate(ConfigLib::ConfigSection& section, const std::vector<Key>& keys) {
+		const std::vector<double> list = {1.0, 2.0, 3.0};
+		for (size_t i = 0; i < keys.size(); ++i) {
+			const Key& key = keys[i];
+			// The built-in rules do not accept lists
+			if (key.type != 3) section.setValidationRule(key.name, &ValidationRules::greaterThanOrEqualToZero);
+			switch (key.type) {
+				case 0: section.setValue(key.name, static_cast<int>(i)); break;
+				case 1: section.setValue(key.name, i * 0.5); break;
+				case 2: section.setValue(key.name, std::string("42")); break;
+				default: section.setValue(key.name, list); break;
+			}
+		}
+	}
+
+	template<typename T>
+	double timeReads(const ConfigLib::ConfigSection& section, const std::vector<const Key*>& order, size_t rounds) {
+		size_t checksum = 0;
+		Bench::Timer timer;
+		for (size_t round = 0; round < rounds; ++round) {
+			for (const Key* key : order) {
+				checksum += static_cast<size_t>(section.getValue<T>(key->name));
+			}
+		}
+		const double elapsed = timer.elapsedNanoseconds();
+		Bench::doNotOptimize(checksum);
+		return elapsed / (rounds * order.size());
+	}
+
+}
+
+int main() {
+	const size_t counts[] = {64, 100000};
+	for (size_t count : counts) {
+		const std::vector<Key> keys = makeKeys(count);
+
+		const size_t bytesBefore = Bench::allocatedBytes();
+		const size_t allocationsBefore = Bench::allocationCount();
+		ConfigLib::ConfigSection section;
+		populate(section, keys);
+		const double bytesPerKey = static_cast<double>(Bench::allocatedBytes() - bytesBefore) / count;
+		const double allocationsPerKey = static_cast<double>(Bench::allocationCount() - allocationsBefore) / count;
+		std::printf("%zu keys: %.1f bytes/key, %.2f allocs/key (heap bytes requested while populating)\n",
+			count, bytesPerKey, allocationsPerKey);
+
+		// Doubles only, visited in a shuffled order so that large sections do not stream through memory
+		std::vector<const Key*> order;
+		for (const auto& key : keys) {
+			if (key.type == 1) order.push_back(&key);
+		}
+		std::mt19937 rng(11);
+		std::shuffle(order.begin(), order.end(), rng);
+
+		// Best of several runs, the single-key cost is small next to scheduling noise
+		const size_t rounds = std::max<size_t>(1, 2000000 / order.size());
+		double nanoseconds = 1e9;
+		for (int run = 0; run < 5; ++run) {
+			nanoseconds = std::min(nanoseconds, timeReads<double>(section, order, rounds));
+		}
+		Bench::report("getValue<double> (" + std::to_string(count) + " keys)", nanoseconds, 0.0);
+	}
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include "bench_common.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/hash_bytes.hpp"
+#include "config_library/ini_stream.hpp"
+#include "config_library/mapped_file.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// IniStreamReader on a generated 40 MB file read through std::ifstream: counting keys with
+// callbacks and extracting one section with the pull interface, in constant memory, against a
+// full ConfigReader load of the same file. Tricky inputs are streamed through windows as small
+// as one byte and must give exactly the events of the in-memory parse.
+
+namespace {
+
+	const char* const kConfigPath = "bench_stream.ini";
+	const int kSections = 2000;
+	const int kKeysPerSection = 500;
+
+	std::string keyName(int index) {
+		return "param_" + std::to_string(index);
+	}
+
+	std::string sectionName(int index) {
+		return "Entity" + std::to_string(index);
+	}
+
+	// Written a section at a time, so that generating it does not raise the peak RSS
+	size_t generate() {
+		std::ofstream out(kConfigPath, std::ios::binary | std::ios::trunc);
+		size_t bytes = 0;
+		for (int s = 0; s < kSections; ++s) {
+			std::string section = "# Entity " + std::to_string(s) + "\n[" + sectionName(s) + "]\n";
+			for (int k = 0; k < kKeysPerSection; ++k) {
+				section += keyName(k) + " = " + std::to_string(s * 1000 + k) + ", 2.25, 3.125 # generated\n";
+			}
+			section += "\n";
+			out << section;
+			bytes += section.size();
+		}
+		return bytes;
+	}
+
+	class KeyCounter : public ConfigLib::IniHandler {
+	public:
+		bool onKeyValue(std::string_view, std::string_view, std::string_view, size_t) override {
+			++keys;
+			return true;
+		}
+		bool onError(std::string_view, size_t) override {
+			++errors;
+			return true;
+		}
+
+		size_t keys = 0;
+		size_t errors = 0;
+	};
+
+	std::string extractSection(const std::string& name) {
+		std::ifstream in(kConfigPath, std::ios::binary);
+		ConfigLib::IniStreamReader reader(in);
+		std::string extracted;
+		bool inside = false;
+		for (ConfigLib::IniEvent event; reader.next(event);) {
+			if (event.kind == ConfigLib::IniEvent::Kind::Section) {
+				if (inside) break;
+				inside = event.section == name;
+			} else if (inside && event.kind == ConfigLib::IniEvent::Kind::KeyValue) {
+				extracted += std::string(event.key) + "=" + std::string(event.value) + "\n";
+			}
+		}
+		return extracted;
+	}
+
+	std::string describe(ConfigLib::IniStreamReader& reader) {
+		std::string text;
+		for (ConfigLib::IniEvent event; reader.next(event);) {
+			text += std::to_string(static_cast<int>(event.kind)) + "|" + std::string(event.section) + "|"
+				+ std::string(event.key) + "|" + std::string(event.value) + "|" + std::string(event.text) + "|"
+				+ std::to_string(event.line) + "\n";
+		}
+		return text;
+	}
+
+	// Streaming with windows of every size from 1 byte up gives the events of the in-memory parse
+	bool windowsAgree() {
+		const std::vector<std::string> inputs = {
+			"[A]\nx = 1\n",
+			"[A]\r\nx = 1 # note\r\n\r\n# comment\r\ny=2",
+			"x = before any section\n[ A ]\n  long_key_name_longer_than_the_window = value with spaces  \nnot a key\n[B]",
+			"\n\n\n[C]\n=\n[]\n#\n",
+			"",
+		};
+		for (const auto& input : inputs) {
+			ConfigLib::IniStreamReader memory(input);
+			const std::string expected = describe(memory);
+			for (size_t window = 1; window <= input.size() + 1; ++window) {
+				std::istringstream in(input);
+				ConfigLib::IniStreamReader streamed(in, window);
+				if (describe(streamed) != expected) {
+					std::printf("window of %zu bytes differs on input %zu\n", window, &input - inputs.data());
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+}
+
+int main() {
+	const size_t bytes = generate();
+	const double megabytes = bytes / (1024.0 * 1024.0);
+	std::printf("input: %.2f MB, %d keys\n", megabytes, kSections * kKeysPerSection);
+	bool ok = windowsAgree();
+
+	const size_t rssBefore = Bench::peakRssKilobytes();
+	{
+		Bench::Timer timer;
+		std::ifstream in(kConfigPath, std::ios::binary);
+		ConfigLib::IniStreamReader reader(in);
+		KeyCounter counter;
+		reader.parse(counter);
+		const double seconds = timer.elapsedSeconds();
+		ok = ok && counter.keys == size_t(kSections) * kKeysPerSection && counter.errors == 0;
+		std::printf("%-40s %12.1f MB/s %10zu keys\n", "count keys (callbacks, ifstream)", megabytes / seconds, counter.keys);
+	}
+	{
+		Bench::Timer timer;
+		const std::string extracted = extractSection(sectionName(kSections / 2));
+		const double seconds = timer.elapsedSeconds();
+		ok = ok && extracted.rfind(keyName(0) + "=" + std::to_string(kSections / 2 * 1000) + ", 2.25, 3.125\n", 0) == 0;
+		std::printf("%-40s %12.2f ms %10zu bytes\n", "extract middle section (pull, ifstream)", seconds * 1e3, extracted.size());
+	}
+	const size_t rssStreaming = Bench::peakRssKilobytes();
+	std::printf("%-40s %12zu KiB\n", "peak RSS growth, ifstream", rssStreaming - rssBefore);
+	ok = ok && rssStreaming - rssBefore < 4096;
+
+	// For comparison: a mapped file is resident once it has been read through
+	{
+		Bench::Timer timer;
+		ConfigLib::MappedFile file(kConfigPath);
+		ConfigLib::IniStreamReader reader(file.view());
+		KeyCounter counter;
+		reader.parse(counter);
+		const double seconds = timer.elapsedSeconds();
+		std::printf("%-40s %12.1f MB/s\n", "count keys (callbacks, mapped)", megabytes / seconds);
+	}
+	std::printf("%-40s %12zu KiB\n", "peak RSS growth, mapped", Bench::peakRssKilobytes() - rssStreaming);
+
+	Bench::removeFile(kConfigPath);
+	std::printf("streamed in constant memory, windows agree with the in-memory parse: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
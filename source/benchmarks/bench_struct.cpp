@@ -0,0 +1,116 @@
+#include "bench_common.hpp"
+#include "bench_struct_schema.hpp"
+#include "BenchSettings.hpp"
+#include "config_library/config_reader.hpp"
+#include <cstdio>
+#include <string>
+
+// Reads through a struct generated by config_generate_struct() against getValue and bound
+// handles in a hot loop, and the cost of filling the struct. Also checks that load() matches
+// getValue for every type, that save() round-trips, and that a value of the wrong type is
+// reported rather than silently defaulted.
+
+namespace {
+
+	const char* const kConfigPath = "bench_struct.ini";
+
+	class BenchConfig : public ConfigLib::ConfigReader {
+	public:
+		BenchConfig() { initialize(); }
+
+		std::string getConfigFilePath() const override { return kConfigPath; }
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override { return BenchStructSchema::sections(); }
+	};
+
+	bool matches(const BenchSettings& settings, const BenchConfig& config) {
+		return settings.Simulation.num_steps == config.getValue<int>("Simulation", "num_steps")
+			&& settings.Simulation.volatility == config.getValue<double>("Simulation", "volatility")
+			&& settings.Simulation.model == config.getValue<std::string>("Simulation", "model")
+			&& settings.Simulation.seed == config.getValue<int>("Simulation", "seed")
+			&& settings.Curve_EUR.tenors == config.getValue<std::vector<double>>("Curve.EUR", "tenors")
+			&& settings.Curve_EUR._1y_rate == config.getValue<double>("Curve.EUR", "1y-rate")
+			&& settings.Curve_EUR.default_ == config.getValue<int>("Curve.EUR", "default");
+	}
+
+}
+
+int main() {
+	Bench::writeFile(kConfigPath, "[Simulation]\nnum_steps = 365\nvolatility = 0.25\nmodel = heston\nseed = 7\n\n"
+		"[Curve.EUR]\ntenors = 1, 2, 3\n1y-rate = 0.01\ndefault = 3\n");
+
+	bool ok = true;
+	{
+		BenchConfig config;
+		const size_t iterations = 5000000;
+
+		const size_t loads = 100000;
+		Bench::Timer loadTimer;
+		for (size_t i = 0; i < loads; ++i) {
+			BenchSettings settings = BenchSettings::load(config);
+			Bench::doNotOptimize(settings);
+		}
+		std::printf("%-40s %12.2f ns/op\n", "BenchSettings::load", loadTimer.elapsedNanoseconds() / loads);
+
+		const std::string section = "Simulation";
+		const std::string key = "volatility";
+		double sum = 0.0;
+		Bench::Timer getValueTimer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += config.getValue<double>(section, key);
+		}
+		Bench::doNotOptimize(sum);
+		std::printf("%-40s %12.2f ns/op\n", "getValue<double>", getValueTimer.elapsedNanoseconds() / iterations);
+
+		ConfigLib::ConfigHandle<double> handle = config.bind<double>(section, key);
+		sum = 0.0;
+		Bench::Timer handleTimer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += handle.get();
+			Bench::doNotOptimize(sum);
+		}
+		std::printf("%-40s %12.2f ns/op\n", "ConfigHandle<double>::get", handleTimer.elapsedNanoseconds() / iterations);
+
+		const BenchSettings settings = BenchSettings::load(config);
+		sum = 0.0;
+		Bench::Timer fieldTimer;
+		for (size_t i = 0; i < iterations; ++i) {
+			sum += settings.Simulation.volatility;
+			Bench::doNotOptimize(sum);
+		}
+		std::printf("%-40s %12.2f ns/op\n", "BenchSettings field", fieldTimer.elapsedNanoseconds() / iterations);
+
+		ok = matches(settings, config) && settings.Curve_EUR.tenors.size() == 3;
+
+		BenchSettings changed = settings;
+		changed.Simulation.volatility = 0.5;
+		changed.Simulation.model = "sabr";
+		changed.Curve_EUR.tenors.push_back(10.0);
+		changed.save(config);
+		ok = ok && matches(BenchSettings::load(config), config) && config.getValue<std::string>("Simulation", "model") == "sabr";
+		std::printf("load() and save() match getValue: %s\n", ok ? "yes" : "no");
+
+		config.setValue("Simulation", "seed", 1.5);
+		bool reported = false;
+		try {
+			BenchSettings::load(config);
+		} catch (const std::runtime_error&) {
+			reported = true;
+		}
+		std::printf("type mismatch reported: %s\n", reported ? "yes" : "no");
+		ok = ok && reported;
+	}
+
+	// Defaults are compiled into the struct; keys missing from the file keep them
+	Bench::writeFile(kConfigPath, "[Simulation]\nnum_steps = 10\n");
+	{
+		BenchConfig config;
+		const BenchSettings settings = BenchSettings::load(config);
+		const bool defaults = settings.Simulation.num_steps == 10 && settings.Simulation.model == "black \"scholes\""
+			&& settings.Curve_EUR.default_ == -2147483647 - 1 && settings.Curve_EUR.tenors.size() == 5;
+		std::printf("defaults for missing keys: %s\n", defaults ? "yes" : "no");
+		ok = ok && defaults;
+	}
+
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
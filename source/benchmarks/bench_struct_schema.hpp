@@ -0,0 +1,40 @@
+#ifndef BENCH_STRUCT_SCHEMA_H
+#define BENCH_STRUCT_SCHEMA_H
+
+#include "config_library/config_schema.hpp"
+#include "config_library/validation_rules.hpp"
+
+// Schema of bench_struct, which config_generate_struct() turns into BenchSettings. It covers
+// every value type, a section declared twice and names that are not C++ identifiers.
+namespace BenchStructSchema {
+
+    inline std::vector<ConfigLib::ConfigGen::ConfigSection> sections() {
+        return {
+            {
+                "Simulation",
+                {
+                    {"num_steps", "int", "252", "Number of time steps", &ValidationRules::greaterThanZero},
+                    {"volatility", "double", "0.2", "Asset price volatility", &ValidationRules::greaterThanZero},
+                    {"model", "string", "black \"scholes\"", "Pricing model", nullptr}
+                }
+            },
+            {
+                "Curve.EUR",
+                {
+                    {"tenors", "vector<double>", "0.25, 0.5, 1, 2, 5", "Curve tenors in years", nullptr},
+                    {"1y-rate", "double", "-0.005", "One year rate", nullptr},
+                    {"default", "int", "-2147483648", "Keyword as a key", nullptr}
+                }
+            },
+            {
+                "Simulation",
+                {
+                    {"seed", "int", "42", "Random seed", nullptr}
+                }
+            }
+        };
+    }
+
+}
+
+#endif // BENCH_STRUCT_SCHEMA_H
@@ -0,0 +1,141 @@
+#include "bench_common.hpp"
+#include "config_library/ini_tokenizer.hpp"
+#include "config_library/structural_index.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Structural index throughput per kernel, tokenizer throughput with and without the index,
+// and a randomized check that every kernel yields exactly the scalar tokenizer's tokens.
+
+namespace {
+
+	using ConfigLib::IniToken;
+	using ConfigLib::IniTokenizer;
+	using ConfigLib::StructuralIndex;
+
+	const StructuralIndex::Kernel kKernels[] = {
+		StructuralIndex::Kernel::Scalar,
+		StructuralIndex::Kernel::SSE2,
+		StructuralIndex::Kernel::AVX2
+	};
+
+	bool sameToken(const IniToken& a, const IniToken& b) {
+		return a.kind == b.kind && a.line == b.line && a.name == b.name && a.key == b.key
+			&& a.value == b.value && a.text == b.text;
+	}
+
+	bool tokensMatch(const std::string& input, StructuralIndex::Kernel kernel) {
+		IniTokenizer plain(input);
+		IniTokenizer indexed(input, kernel);
+		IniToken expected;
+		IniToken actual;
+		for (;;) {
+			const bool hasExpected = plain.next(expected);
+			const bool hasActual = indexed.next(actual);
+			if (hasExpected != hasActual) return false;
+			if (!hasExpected) return true;
+			if (!sameToken(expected, actual)) return false;
+		}
+	}
+
+	std::string randomInput(std::mt19937& rng) {
+		static const char alphabet[] = "ab1.=#[], \t\r\n\n";
+		std::uniform_int_distribution<size_t> length(0, 300);
+		std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+		std::string input(length(rng), ' ');
+		for (auto& c : input) c = alphabet[pick(rng)];
+		return input;
+	}
+
+	std::string generateLarge(size_t targetBytes) {
+		std::string contents;
+		contents.reserve(targetBytes + 256);
+		for (int section = 0; contents.size() < targetBytes; ++section) {
+			contents += "[Table" + std::to_string(section) + "]\n";
+			for (int key = 0; key < 1000; ++key) {
+				contents += "entry_" + std::to_string(key) + " = " + std::to_string(key * 0.5)
+					+ ", " + std::to_string(key * 0.25) + ", " + std::to_string(key) + "  # lookup row\n";
+			}
+			contents += "\n";
+		}
+		return contents;
+	}
+
+	size_t countKeyValues(IniTokenizer& tokenizer) {
+		IniToken token;
+		size_t keyValues = 0;
+		while (tokenizer.next(token)) {
+			if (token.kind == IniToken::Kind::KeyValue) ++keyValues;
+		}
+		return keyValues;
+	}
+
+}
+
+int main() {
+	std::mt19937 rng(7);
+	size_t mismatches = 0;
+	const size_t cases = 20000;
+	for (size_t i = 0; i < cases; ++i) {
+		const std::string input = randomInput(rng);
+		for (auto kernel : kKernels) {
+			if (StructuralIndex::isSupported(kernel) && !tokensMatch(input, kernel)) ++mismatches;
+		}
+	}
+	// Long inputs make lines cross the tokenizer's index windows
+	for (size_t i = 0; i < 20; ++i) {
+		std::string input;
+		while (input.size() < 300000) input += randomInput(rng);
+		for (auto kernel : kKernels) {
+			if (StructuralIndex::isSupported(kernel) && !tokensMatch(input, kernel)) ++mismatches;
+		}
+	}
+	std::printf("randomized equivalence: %zu cases, %zu mismatches\n", cases + 20, mismatches);
+
+	const std::string input = generateLarge(128u << 20);
+	const double megabytes = input.size() / (1024.0 * 1024.0);
+	std::printf("input: %.1f MB\n", megabytes);
+
+	std::vector<StructuralIndex::Block> blocks;
+	for (auto kernel : kKernels) {
+		if (!StructuralIndex::isSupported(kernel)) continue;
+		Bench::Timer timer;
+		StructuralIndex::build(input, blocks, kernel);
+		const double seconds = timer.elapsedSeconds();
+		size_t delimiters = 0;
+		for (const auto& block : blocks) {
+			delimiters += __builtin_popcountll(block.newlines) + __builtin_popcountll(block.equals)
+				+ __builtin_popcountll(block.hashes) + __builtin_popcountll(block.brackets);
+		}
+		const std::string name = std::string("index build (") + StructuralIndex::kernelName(kernel) + ")";
+		std::printf("%-40s %12.1f MB/s %12zu delimiters\n", name.c_str(), megabytes / seconds, delimiters);
+	}
+
+	// Best of several runs, since a single pass over the input is short
+	const int runs = 5;
+	double scalarSeconds = 1e9;
+	double indexedSeconds = 1e9;
+	for (int run = 0; run < runs; ++run) {
+		{
+			Bench::Timer timer;
+			IniTokenizer tokenizer(input);
+			const size_t keyValues = countKeyValues(tokenizer);
+			Bench::doNotOptimize(keyValues);
+			scalarSeconds = std::min(scalarSeconds, timer.elapsedSeconds());
+		}
+		{
+			Bench::Timer timer;
+			IniTokenizer tokenizer(input, StructuralIndex::Kernel::Auto);
+			const size_t keyValues = countKeyValues(tokenizer);
+			Bench::doNotOptimize(keyValues);
+			indexedSeconds = std::min(indexedSeconds, timer.elapsedSeconds());
+		}
+	}
+	std::printf("%-40s %12.1f MB/s\n", "tokenize (scalar)", megabytes / scalarSeconds);
+	std::printf("%-40s %12.1f MB/s\n", "tokenize (indexed)", megabytes / indexedSeconds);
+
+	return mismatches == 0 ? 0 : 1;
+}
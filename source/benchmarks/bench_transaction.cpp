@@ -0,0 +1,218 @@
+#include "bench_common.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/config_transaction.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An optimizer step that updates 200 keys: 200 setValue() calls against one ConfigTransaction,
+// in place and in snapshot mode. A reader thread checks that it never sees a step half applied
+// through a transaction. Rejected transactions, for a value, a type or a cross-key check, must
+// leave every value as it was, as must one that turns a bound list into an array file reference.
+// Cross-key checks must read a list kept in an array file from that file.
+
+namespace {
+
+	const char* const kConfigPath = "bench_transaction.ini";
+	const char* const kArrayPath = "bench_transaction_curve.bin";
+	const int kKeys = 200;
+
+	const ValidationRules::BetweenValues kWeightRange(0.0, 1000.0);
+
+	std::string keyName(int index) {
+		return "weight_" + std::to_string(index);
+	}
+
+	class OptimizerConfig : public ConfigLib::ConfigReader {
+	public:
+		std::string getConfigFilePath() const override { return kConfigPath; }
+
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override {
+			// The item strings must outlive the returned schema
+			static const std::vector<std::string> names = [] {
+				std::vector<std::string> names;
+				for (int k = 0; k < kKeys; ++k) names.push_back(keyName(k));
+				return names;
+			}();
+			ConfigLib::ConfigGen::ConfigSection section;
+			section.name = "Optimizer";
+			for (int k = 0; k < kKeys; ++k) {
+				section.items.push_back({names[k].c_str(), "double", "1.0", "generated", &kWeightRange});
+			}
+			section.items.push_back({"lower", "double", "0.1", "Lower bound", nullptr});
+			section.items.push_back({"upper", "double", "0.9", "Upper bound", nullptr});
+			section.items.push_back({"curve", "vector<double>", "1, 2, 3", "Bound by a handle", nullptr});
+			return {section};
+		}
+	};
+
+	std::string generate() {
+		std::string contents = "[Optimizer]\n";
+		for (int k = 0; k < kKeys; ++k) contents += keyName(k) + " = 1.0\n";
+		return contents + "lower = 0.1\nupper = 0.9\ncurve = 1, 2, 3\n";
+	}
+
+	void stepWithSetValue(OptimizerConfig& config, double value) {
+		for (int k = 0; k < kKeys; ++k) config.setValue("Optimizer", keyName(k), value);
+	}
+
+	void stepWithTransaction(OptimizerConfig& config, double value) {
+		ConfigLib::ConfigTransaction transaction = config.begin();
+		for (int k = 0; k < kKeys; ++k) transaction.set("Optimizer", keyName(k), value);
+		transaction.commit();
+	}
+
+	// Microseconds per step of 200 keys
+	template<typename Step>
+	double timeSteps(OptimizerConfig& config, Step step) {
+		const int steps = 200;
+		Bench::Timer timer;
+		for (int i = 0; i < steps; ++i) step(config, 1.0 + i);
+		return timer.elapsedSeconds() * 1e6 / steps;
+	}
+
+	// Snapshots in which not all weights are equal, while a writer runs steps
+	template<typename Step>
+	size_t tornReads(OptimizerConfig& config, Step step) {
+		std::atomic<bool> done{false};
+		size_t torn = 0;
+		std::thread reader([&] {
+			while (!done.load()) {
+				const ConfigLib::ConfigSnapshot snapshot = config.snapshot();
+				const double first = snapshot.getValue<double>("Optimizer", keyName(0));
+				for (int k = 1; k < kKeys; ++k) {
+					if (snapshot.getValue<double>("Optimizer", keyName(k)) != first) {
+						++torn;
+						break;
+					}
+				}
+			}
+		});
+		for (int i = 0; i < 300; ++i) {
+			step(config, 2.0 + i);
+			std::this_thread::yield();
+		}
+		done = true;
+		reader.join();
+		return torn;
+	}
+
+	bool unchanged(const OptimizerConfig& config, double weight) {
+		for (int k = 0; k < kKeys; ++k) {
+			if (config.getValue<double>("Optimizer", keyName(k)) != weight) return false;
+		}
+		return config.getValue<double>("Optimizer", "lower") == 0.1 && config.getValue<double>("Optimizer", "upper") == 0.9;
+	}
+
+	// Rejections: one value out of range, one that does not parse, one failing cross-key check
+	bool rejectsAllOrNothing(OptimizerConfig& config) {
+		stepWithTransaction(config, 5.0);
+		size_t failures = 0;
+
+		ConfigLib::ConfigTransaction transaction = config.begin();
+		for (int k = 0; k < kKeys; ++k) transaction.set("Optimizer", keyName(k), k == 150 ? 5000.0 : 6.0);
+		transaction.set("Optimizer", "lower", std::string("not a number"));
+		try {
+			transaction.commit();
+		} catch (const ConfigLib::ConfigTransactionError& e) {
+			failures += e.getViolations().size();
+		}
+		bool ok = failures == 2 && transaction.empty() && unchanged(config, 5.0);
+
+		transaction.set("Optimizer", "lower", 0.95).set("Optimizer", keyName(0), 7.0);
+		transaction.require("lower below upper", [](const ConfigLib::ConfigTransaction::View& view) {
+			return view.getValue<double>("Optimizer", "lower") < view.getValue<double>("Optimizer", "upper");
+		});
+		try {
+			transaction.commit();
+			ok = false;
+		} catch (const ConfigLib::ConfigTransactionError& e) {
+			ok = ok && e.getViolations().size() == 1 && e.getViolations()[0].reason == "lower below upper";
+		}
+		ok = ok && unchanged(config, 5.0);
+
+		// The same check passes once upper moves too, in the same batch
+		transaction.set("Optimizer", "lower", 0.95).set("Optimizer", "upper", std::string("0.99"));
+		transaction.require("lower below upper", [](const ConfigLib::ConfigTransaction::View& view) {
+			return view.getValue<double>("Optimizer", "lower") < view.getValue<double>("Optimizer", "upper");
+		});
+		transaction.commit();
+		ok = ok && config.getValue<double>("Optimizer", "upper") == 0.99;
+
+		// A rejected string leaves the stored value as it was
+		try {
+			config.setValue("Optimizer", keyName(3), std::string("5000"));
+			ok = false;
+		} catch (const std::exception&) {
+		}
+		return ok && config.getValue<double>("Optimizer", keyName(3)) == 5.0;
+	}
+
+	// An inline list bound by a handle cannot become an array file reference; the batch is
+	// rejected before any of it is written in place
+	bool rejectsBoundSwitch(OptimizerConfig& config) {
+		stepWithTransaction(config, 5.0);
+		const ConfigLib::ConfigHandle<std::vector<double>> curve = config.bind<std::vector<double>>("Optimizer", "curve");
+		ConfigLib::ConfigTransaction transaction = config.begin();
+		transaction.set("Optimizer", keyName(0), 6.0).set("Optimizer", "curve", std::string("@bench_transaction_curve.npy"));
+		bool ok = false;
+		try {
+			transaction.commit();
+		} catch (const ConfigLib::ConfigTransactionError& e) {
+			ok = e.getViolations().size() == 1 && e.getViolations()[0].key == "curve";
+		}
+		return ok && config.getValue<double>("Optimizer", keyName(0)) == 5.0 && curve.get().size() == 3;
+	}
+
+	// Cross-key checks read a list that refers to an array file from the file
+	bool checksSeeArrayFiles(OptimizerConfig& config) {
+		const double values[] = {0.5, 1.5, 2.5, 3.5};
+		Bench::writeFile(kArrayPath, std::string(reinterpret_cast<const char*>(values), sizeof(values)));
+		ConfigLib::ConfigTransaction transaction = config.begin();
+		transaction.set("Optimizer", "curve", std::string("@") + kArrayPath);
+		transaction.require("curve has four points", [](const ConfigLib::ConfigTransaction::View& view) {
+			return view.getValue<std::vector<double>>("Optimizer", "curve").size() == 4;
+		});
+		bool ok = true;
+		try {
+			transaction.commit();
+		} catch (const ConfigLib::ConfigTransactionError&) {
+			ok = false;
+		}
+		ok = ok && config.getValue<std::vector<double>>("Optimizer", "curve").size() == 4;
+		Bench::removeFile(kArrayPath);
+		return ok;
+	}
+
+}
+
+int main() {
+	Bench::writeFile(kConfigPath, generate());
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Off);
+
+	OptimizerConfig inPlace;
+	inPlace.initialize();
+	std::printf("%-40s %10.1f us/step\n", "setValue() x200, in place", timeSteps(inPlace, stepWithSetValue));
+	std::printf("%-40s %10.1f us/step\n", "transaction of 200, in place", timeSteps(inPlace, stepWithTransaction));
+
+	OptimizerConfig shared;
+	shared.initialize();
+	shared.setSnapshotMode(true);
+	std::printf("%-40s %10.1f us/step\n", "setValue() x200, snapshot mode", timeSteps(shared, stepWithSetValue));
+	std::printf("%-40s %10.1f us/step\n", "transaction of 200, snapshot mode", timeSteps(shared, stepWithTransaction));
+
+	const size_t tornSetValue = tornReads(shared, stepWithSetValue);
+	const size_t tornTransaction = tornReads(shared, stepWithTransaction);
+	std::printf("%-40s %10zu\n", "torn snapshots, setValue() x200", tornSetValue);
+	std::printf("%-40s %10zu\n", "torn snapshots, transaction", tornTransaction);
+
+	const bool ok = tornTransaction == 0 && rejectsAllOrNothing(inPlace) && rejectsAllOrNothing(shared)
+		&& rejectsBoundSwitch(inPlace) && checksSeeArrayFiles(shared);
+	std::printf("all or nothing: %s\n", ok ? "yes" : "no");
+
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
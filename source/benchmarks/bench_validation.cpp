@@ -0,0 +1,137 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/validation_rules.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Cost of one rule evaluation through Rule::operator() (a TypedConfigValue and a chain of
+// dynamic_casts) against the Check the rule is bound to, and of validate() over a 20k-key
+// config. Also checks that both forms agree on every value they share, and that invalid
+// values in the file come back from getLoadViolations() rather than only as log lines.
+
+namespace {
+
+	const char* const kConfigPath = "bench_validation.ini";
+
+	std::unique_ptr<ValidationRules::Rule> between = ValidationRules::betweenValues(-1.0, 1000.0);
+	std::unique_ptr<ValidationRules::Rule> modes = ValidationRules::inList({"fast", "exact"});
+
+	Bench::IniShape shape() {
+		Bench::IniShape shape;
+		shape.sections = 200;
+		shape.keysPerSection = 100;
+		shape.commentDensity = 0.0;
+		return shape;
+	}
+
+	// Section0 gets one value of each type that must be rejected, by a rule or by the parser
+	void addRejectedValues(Bench::IniGenerator& generator) {
+		const auto& keys = generator.getKeys();
+		const std::pair<ConfigLib::ValueType, const char*> bad[] = {
+			{ConfigLib::ValueType::Int, "-3"},
+			{ConfigLib::ValueType::Double, "-1.5"},
+			{ConfigLib::ValueType::String, "slow"},
+			{ConfigLib::ValueType::DoubleVector, "1, x, 3"},
+		};
+		for (const auto& [type, value] : bad) {
+			for (size_t i = 0; i < keys.size() && keys[i].section == "Section0"; ++i) {
+				if (keys[i].type != type) continue;
+				generator.setValue(i, value);
+				break;
+			}
+		}
+	}
+
+	// The first string key of a section
+	const Bench::GeneratedKey* firstString(const Bench::IniGenerator& generator, const std::string& section) {
+		for (const auto& key : generator.getKeys()) {
+			if (key.section == section && key.type == ConfigLib::ValueType::String) return &key;
+		}
+		return nullptr;
+	}
+
+	template<typename T>
+	bool agree(const ValidationRules::Rule& rule, ConfigLib::ValueType type, const T& value) {
+		return rule(ConfigLib::TypedConfigValue<T>(value)) == rule.bind(type)(value);
+	}
+
+	bool formsAgree() {
+		const ValidationRules::Rule* rules[] = {&ValidationRules::greaterThanZero, &ValidationRules::greaterThanOrEqualToZero, between.get(), modes.get()};
+		bool ok = true;
+		for (const ValidationRules::Rule* rule : rules) {
+			for (int value : {-5, -1, 0, 1, 999, 1000, 1001}) ok = ok && agree(*rule, ConfigLib::ValueType::Int, value);
+			for (double value : {-1e-9, -1.0, 0.0, 1e-300, 1000.0, 1000.5, std::stod("nan"), std::stod("inf")}) {
+				ok = ok && agree(*rule, ConfigLib::ValueType::Double, value);
+			}
+			for (const char* text : {"fast", "exact", "slow", "0", "2.5", " 7 ", "-1", "abc", ""}) {
+				ok = ok && agree(*rule, ConfigLib::ValueType::String, std::string(text));
+			}
+		}
+		return ok;
+	}
+
+	double timeLegacy(const ValidationRules::Rule& rule, size_t iterations) {
+		size_t passed = 0;
+		Bench::Timer timer;
+		for (size_t i = 0; i < iterations; ++i) {
+			passed += rule(ConfigLib::TypedConfigValue<double>(static_cast<double>(i % 2000) - 500.0)) ? 1 : 0;
+		}
+		const double elapsed = timer.elapsedNanoseconds();
+		Bench::doNotOptimize(passed);
+		return elapsed / iterations;
+	}
+
+	double timeBound(const ValidationRules::Rule& rule, size_t iterations) {
+		const ValidationRules::Check check = rule.bind(ConfigLib::ValueType::Double);
+		size_t passed = 0;
+		Bench::Timer timer;
+		for (size_t i = 0; i < iterations; ++i) {
+			passed += check(static_cast<double>(i % 2000) - 500.0) ? 1 : 0;
+			Bench::doNotOptimize(passed);
+		}
+		return timer.elapsedNanoseconds() / iterations;
+	}
+
+}
+
+int main() {
+	Bench::IniGenerator generator(shape());
+	addRejectedValues(generator);
+	Bench::writeFile(kConfigPath, generator.generate());
+
+	const size_t iterations = 5000000;
+	Bench::report("BetweenValues::operator()", timeLegacy(*between, iterations), 0.0);
+	Bench::report("BetweenValues bound Check", timeBound(*between, iterations), 0.0);
+
+	bool ok = formsAgree();
+	std::printf("bound checks agree with operator(): %s\n", ok ? "yes" : "no");
+
+	Bench::GeneratedConfig config(generator, kConfigPath);
+	config.initialize();
+	const std::vector<ConfigLib::ConfigViolation> rejected = config.getLoadViolations();
+	std::printf("values rejected by the load: %zu\n", rejected.size());
+	for (const auto& violation : rejected) {
+		std::printf("  %s.%s = '%s': %s\n", violation.section.c_str(), violation.key.c_str(), violation.value.c_str(), violation.reason.c_str());
+	}
+	ok = ok && rejected.size() == 4;
+
+	const int runs = 20;
+	size_t found = 0;
+	Bench::Timer timer;
+	for (int run = 0; run < runs; ++run) found += config.validate().size();
+	std::printf("%-40s %10.2f ms\n", "validate(), 20k keys", timer.elapsedSeconds() * 1e3 / runs);
+	ok = ok && found == 0;
+
+	// A rule set after the fact that the stored value breaks
+	const Bench::GeneratedKey* mode = firstString(generator, "Section5");
+	config.setValidationRule(mode->section, mode->name, modes.get());
+	const std::vector<ConfigLib::ConfigViolation> violations = config.validate();
+	std::printf("violations of a rule set afterwards: %zu\n", violations.size());
+	ok = ok && violations.size() == 1 && violations[0].section == mode->section;
+
+	Bench::removeFile(kConfigPath);
+	return ok ? 0 : 1;
+}
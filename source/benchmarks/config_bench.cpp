@@ -0,0 +1,367 @@
+#include "bench_common.hpp"
+#include "ini_generator.hpp"
+#include "config_library/config_log.hpp"
+#include "config_library/config_reader.hpp"
+#include "config_library/validation_rules.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// The release-tracking suite: every public entry point of ConfigReader timed over a synthetic
+// config file of a chosen shape, with the distribution of each case written as JSON. A case is
+// run as a number of samples after one untimed warm-up; each sample times a batch of operations
+// and records the mean cost of one, and the samples give min, mean, p50, p90, p99 and max.
+// Before timing, and again after the saves, every key is read back and compared with what was
+// generated; any mismatch or load violation makes the run fail.
+//
+//   config_bench [--sections N] [--keys N] [--types INT,DOUBLE,STRING,VECTOR] [--vector-length N]
+//                [--comments F] [--seed N] [--samples N] [--batch N] [--filter TEXT] [--output FILE]
+
+namespace {
+
+	const char* const kConfigPath = "config_bench.ini";
+
+	struct Options {
+		Bench::IniShape shape;
+		int samples = 50;
+		int batch = 1000;
+		std::string filter;
+		std::string output = "config_bench.json";
+	};
+
+	struct Result {
+		std::string name;
+		int samples = 0;
+		int opsPerSample = 0;
+		double min = 0, mean = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;   // ns per operation
+	};
+
+	void usage() {
+		std::fprintf(stderr,
+			"usage: config_bench [--sections N] [--keys N] [--types INT,DOUBLE,STRING,VECTOR]\n"
+			"                    [--vector-length N] [--comments F] [--seed N] [--samples N]\n"
+			"                    [--batch N] [--filter TEXT] [--output FILE]\n");
+	}
+
+	bool parseInt(const char* text, int minimum, int& value) {
+		char* end = nullptr;
+		const long parsed = std::strtol(text, &end, 10);
+		if (end == text || *end != '\0' || parsed < minimum || parsed > 1000000000L) return false;
+		value = static_cast<int>(parsed);
+		return true;
+	}
+
+	bool parseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (i + 1 >= argc) return false;
+			const char* value = argv[++i];
+			bool ok = true;
+			if (option == "--sections") ok = parseInt(value, 1, options.shape.sections);
+			else if (option == "--keys") ok = parseInt(value, 1, options.shape.keysPerSection);
+			else if (option == "--vector-length") ok = parseInt(value, 1, options.shape.vectorLength);
+			else if (option == "--samples") ok = parseInt(value, 1, options.samples);
+			else if (option == "--batch") ok = parseInt(value, 1, options.batch);
+			else if (option == "--filter") options.filter = value;
+			else if (option == "--output") options.output = value;
+			else if (option == "--seed") {
+				char* end = nullptr;
+				options.shape.seed = std::strtoull(value, &end, 10);
+				ok = end != value && *end == '\0';
+			} else if (option == "--comments") {
+				char* end = nullptr;
+				options.shape.commentDensity = std::strtod(value, &end);
+				ok = end != value && *end == '\0' && options.shape.commentDensity >= 0 && options.shape.commentDensity <= 1;
+			} else if (option == "--types") {
+				int* weights[] = { &options.shape.intWeight, &options.shape.doubleWeight,
+					&options.shape.stringWeight, &options.shape.vectorWeight };
+				std::string list = value;
+				size_t begin = 0;
+				for (int t = 0; t < 4 && ok; ++t) {
+					const size_t end = t < 3 ? list.find(',', begin) : list.size();
+					ok = end != std::string::npos && parseInt(list.substr(begin, end - begin).c_str(), 0, *weights[t]);
+					begin = end + 1;
+				}
+				ok = ok && begin == list.size() + 1;
+			} else {
+				ok = false;
+			}
+			if (!ok) return false;
+		}
+		return true;
+	}
+
+	// Nearest-rank percentile of sorted samples
+	double percentile(const std::vector<double>& sorted, double fraction) {
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+		return sorted[rank == 0 ? 0 : rank - 1];
+	}
+
+	class Suite {
+	public:
+		explicit Suite(const Options& options) : options(options) {}
+
+		// setup runs before every sample, untimed; body runs opsPerSample operations.
+		template<typename Setup, typename Body>
+		void run(const std::string& name, int opsPerSample, Setup setup, Body body) {
+			if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+			setup();
+			body();
+			std::vector<double> samples;
+			samples.reserve(static_cast<size_t>(options.samples));
+			for (int s = 0; s < options.samples; ++s) {
+				setup();
+				Bench::Timer timer;
+				body();
+				samples.push_back(timer.elapsedNanoseconds() / opsPerSample);
+			}
+			std::sort(samples.begin(), samples.end());
+
+			Result result;
+			result.name = name;
+			result.samples = options.samples;
+			result.opsPerSample = opsPerSample;
+			result.min = samples.front();
+			result.max = samples.back();
+			for (double sample : samples) result.mean += sample / samples.size();
+			result.p50 = percentile(samples, 0.50);
+			result.p90 = percentile(samples, 0.90);
+			result.p99 = percentile(samples, 0.99);
+			std::printf("%-40s %12.1f %12.1f %12.1f %12.1f\n", name.c_str(), result.p50, result.p90, result.p99, result.max);
+			results.push_back(result);
+		}
+
+		template<typename Body>
+		void run(const std::string& name, int opsPerSample, Body body) {
+			run(name, opsPerSample, [] {}, body);
+		}
+
+		const std::vector<Result>& getResults() const { return results; }
+
+	private:
+		const Options& options;
+		std::vector<Result> results;
+	};
+
+	std::string jsonString(const std::string& text) {
+		std::string quoted = "\"";
+		for (char c : text) {
+			if (c == '"' || c == '\\') quoted += '\\';
+			if (static_cast<unsigned char>(c) < 0x20) {
+				char escape[8];
+				std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+				quoted += escape;
+			} else {
+				quoted += c;
+			}
+		}
+		return quoted + "\"";
+	}
+
+	bool writeJson(const std::string& path, const Options& options, size_t fileBytes, const std::vector<Result>& results) {
+		std::ofstream file(path);
+		const Bench::IniShape& shape = options.shape;
+		char line[512];
+		file << "{\n  \"suite\": \"config_bench\",\n  \"version\": 1,\n";
+#ifdef NDEBUG
+		file << "  \"build\": \"release\",\n";
+#else
+		file << "  \"build\": \"debug\",\n";
+#endif
+		std::snprintf(line, sizeof(line),
+			"  \"shape\": {\"sections\": %d, \"keys_per_section\": %d, "
+			"\"type_weights\": {\"int\": %d, \"double\": %d, \"string\": %d, \"vector\": %d}, "
+			"\"vector_length\": %d, \"comment_density\": %g, \"seed\": %llu, \"file_bytes\": %zu},\n",
+			shape.sections, shape.keysPerSection, shape.intWeight, shape.doubleWeight, shape.stringWeight,
+			shape.vectorWeight, shape.vectorLength, shape.commentDensity,
+			static_cast<unsigned long long>(shape.seed), fileBytes);
+		file << line << "  \"unit\": \"ns/op\",\n  \"results\": [\n";
+		for (size_t i = 0; i < results.size(); ++i) {
+			const Result& r = results[i];
+			std::snprintf(line, sizeof(line),
+				"\"samples\": %d, \"ops_per_sample\": %d, \"min\": %.2f, \"mean\": %.2f, "
+				"\"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f}",
+				r.samples, r.opsPerSample, r.min, r.mean, r.p50, r.p90, r.p99, r.max);
+			file << "    {\"name\": " << jsonString(r.name) << ", " << line << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		file << "  ]\n}\n";
+		return static_cast<bool>(file);
+	}
+
+	std::vector<double> parseVector(const std::string& text) {
+		std::vector<double> values;
+		const char* cursor = text.c_str();
+		while (*cursor) {
+			char* end = nullptr;
+			values.push_back(std::strtod(cursor, &end));
+			cursor = end;
+			while (*cursor == ',' || *cursor == ' ') ++cursor;
+		}
+		return values;
+	}
+
+	// Whether every key holds what the generator wrote and nothing was rejected on load
+	bool matchesGenerated(const Bench::GeneratedConfig& config, const Bench::IniGenerator& generator) {
+		if (!config.getLoadViolations().empty() || !config.validate().empty()) return false;
+		for (const auto& key : generator.getKeys()) {
+			bool same = false;
+			switch (key.type) {
+				case ConfigLib::ValueType::Int:
+					same = config.getValue<int>(key.section, key.name) == std::atoi(key.value.c_str());
+					break;
+				case ConfigLib::ValueType::Double:
+					same = config.getValue<double>(key.section, key.name) == std::strtod(key.value.c_str(), nullptr);
+					break;
+				case ConfigLib::ValueType::String:
+					same = config.getValue<std::string>(key.section, key.name) == key.value;
+					break;
+				case ConfigLib::ValueType::DoubleVector:
+					same = config.getValue<std::vector<double>>(key.section, key.name) == parseVector(key.value);
+					break;
+			}
+			if (!same) return false;
+		}
+		return true;
+	}
+
+	// Runs batch getValue<T> calls, cycling through the keys of T's type
+	template<typename T>
+	void benchGetValue(Suite& suite, const Bench::GeneratedConfig& config, const std::vector<const Bench::GeneratedKey*>& keys,
+		int batch, const char* name) {
+		if (keys.empty()) return;
+		suite.run(std::string("getValue<") + name + ">", batch, [&] {
+			size_t next = 0;
+			for (int i = 0; i < batch; ++i) {
+				const Bench::GeneratedKey& key = *keys[next];
+				Bench::doNotOptimize(config.getValue<T>(key.section, key.name));
+				if (++next == keys.size()) next = 0;
+			}
+		});
+	}
+
+	// Runs batch setValue calls, each writing back the value its key already holds
+	template<typename T>
+	void benchSetValue(Suite& suite, Bench::GeneratedConfig& config, const std::vector<const Bench::GeneratedKey*>& keys,
+		int batch, const char* name) {
+		if (keys.empty()) return;
+		std::vector<T> values;
+		for (const auto* key : keys) values.push_back(config.getValue<T>(key->section, key->name));
+		suite.run(std::string("setValue<") + name + ">", batch, [&] {
+			size_t next = 0;
+			for (int i = 0; i < batch; ++i) {
+				const Bench::GeneratedKey& key = *keys[next];
+				config.setValue(key.section, key.name, values[next]);
+				if (++next == keys.size()) next = 0;
+			}
+		});
+	}
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		usage();
+		return 2;
+	}
+	ConfigLib::Log::setLevel(ConfigLib::Log::Level::Error);
+
+	const Bench::IniGenerator generator(options.shape);
+	const std::string contents = generator.generate();
+	Bench::writeFile(kConfigPath, contents);
+	std::printf("input: %zu sections, %zu keys, %.2f MB\n", generator.getSchema().size(),
+		generator.getKeys().size(), contents.size() / (1024.0 * 1024.0));
+
+	std::vector<const Bench::GeneratedKey*> byType[4];
+	for (const auto& key : generator.getKeys()) byType[static_cast<int>(key.type)].push_back(&key);
+	const auto& ints = byType[static_cast<int>(ConfigLib::ValueType::Int)];
+	const auto& doubles = byType[static_cast<int>(ConfigLib::ValueType::Double)];
+	const auto& strings = byType[static_cast<int>(ConfigLib::ValueType::String)];
+	const auto& vectors = byType[static_cast<int>(ConfigLib::ValueType::DoubleVector)];
+
+	Bench::GeneratedConfig config(generator, kConfigPath);
+	config.initialize();
+	bool ok = matchesGenerated(config, generator);
+
+	const int batch = options.batch;
+	Suite suite(options);
+	std::printf("%-40s %12s %12s %12s %12s\n", "ns/op", "p50", "p90", "p99", "max");
+
+	suite.run("initialize()", 1, [&] {
+		Bench::GeneratedConfig fresh(generator, kConfigPath);
+		fresh.initialize();
+		Bench::doNotOptimize(fresh);
+	});
+	suite.run("loadConfig()", 1, [&] { config.loadFile(); });
+
+	benchGetValue<int>(suite, config, ints, batch, "int");
+	benchGetValue<double>(suite, config, doubles, batch, "double");
+	benchGetValue<std::string>(suite, config, strings, batch, "string");
+	benchGetValue<std::vector<double>>(suite, config, vectors, batch, "vector<double>");
+
+	benchSetValue<int>(suite, config, ints, batch, "int");
+	benchSetValue<double>(suite, config, doubles, batch, "double");
+	benchSetValue<std::string>(suite, config, strings, batch, "string");
+	benchSetValue<std::vector<double>>(suite, config, vectors, batch, "vector<double>");
+
+	{
+		const auto& rule = ValidationRules::greaterThanOrEqualToZero;
+		const auto between = ValidationRules::betweenValues(0.0, 1000.0);
+		const auto& inList = generator.getStringRule();
+		const ConfigLib::TypedConfigValue<double> number(42.5);
+		const std::string wordValue = "spline";
+		const ConfigLib::TypedConfigValue<std::string> word(wordValue);
+		const ValidationRules::Check numberCheck = rule.bind(ConfigLib::ValueType::Double);
+		const ValidationRules::Check wordCheck = inList.bind(ConfigLib::ValueType::String);
+
+		suite.run("rule GreaterThanOrEqualToZero", batch, [&] {
+			for (int i = 0; i < batch; ++i) Bench::doNotOptimize(rule(number));
+		});
+		suite.run("rule BetweenValues", batch, [&] {
+			for (int i = 0; i < batch; ++i) Bench::doNotOptimize((*between)(number));
+		});
+		suite.run("rule InList", batch, [&] {
+			for (int i = 0; i < batch; ++i) Bench::doNotOptimize(inList(word));
+		});
+		suite.run("check GreaterThanOrEqualToZero", batch, [&] {
+			for (int i = 0; i < batch; ++i) Bench::doNotOptimize(numberCheck(42.5));
+		});
+		suite.run("check InList", batch, [&] {
+			for (int i = 0; i < batch; ++i) Bench::doNotOptimize(wordCheck(std::string_view(wordValue)));
+		});
+		suite.run("validate()", 1, [&] { Bench::doNotOptimize(config.validate()); });
+	}
+
+	{
+		// Start from a clean file, so each save writes only what its setup changed
+		config.reload();
+		const Bench::GeneratedKey& middle = generator.getKeys()[generator.getKeys().size() / 2];
+		suite.run("saveConfig(), one key changed", 1,
+			[&] { config.setValue(middle.section, middle.name, middle.value); },
+			[&] { config.saveConfig(); });
+		// loadFromBuffer() marks every key it sets as changed
+		suite.run("saveConfig(), every key changed", 1,
+			[&] { config.loadFromBuffer(contents); },
+			[&] { config.saveConfig(); });
+		config.reload();
+		ok = ok && matchesGenerated(config, generator);
+	}
+
+	suite.run("ConfigGen::generateConfig()", 1, [&] {
+		Bench::doNotOptimize(ConfigLib::ConfigGen::generateConfig(generator.getSchema()));
+	});
+
+	Bench::removeFile(kConfigPath);
+	if (!writeJson(options.output, options, contents.size(), suite.getResults())) {
+		std::fprintf(stderr, "unable to write %s\n", options.output.c_str());
+		return 1;
+	}
+	std::printf("results written to %s\n", options.output.c_str());
+	std::printf("values read back as generated: %s\n", ok ? "yes" : "no");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include "ini_generator.hpp"
+#include <cstdio>
+
+namespace Bench {
+
+	namespace {
+		const std::vector<std::string> kWords = {
+			"linear", "cubic", "spline", "nearest", "adaptive", "fixed", "implicit", "explicit"
+		};
+
+		// splitmix64; fully specified, unlike the <random> distributions
+		class Random {
+		public:
+			explicit Random(uint64_t seed) : state(seed) {}
+
+			uint64_t next() {
+				uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+				z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+				return z ^ (z >> 31);
+			}
+			// In [0, bound)
+			uint64_t below(uint64_t bound) { return bound == 0 ? 0 : next() % bound; }
+			// In [0, 1)
+			double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+		private:
+			uint64_t state;
+		};
+
+		std::string formatDouble(double value) {
+			char text[32];
+			std::snprintf(text, sizeof(text), "%.3f", value);
+			return text;
+		}
+
+		const char* defaultFor(ConfigLib::ValueType type) {
+			switch (type) {
+				case ConfigLib::ValueType::Int: return "0";
+				case ConfigLib::ValueType::Double: return "0.0";
+				case ConfigLib::ValueType::DoubleVector: return "0.0";
+				case ConfigLib::ValueType::String: break;
+			}
+			return kWords[0].c_str();
+		}
+	}
+
+	IniGenerator::IniGenerator(const IniShape& shape) : shape(shape), stringRule(ValidationRules::inList(kWords)) {
+		Random random(shape.seed);
+		int weights[] = { shape.intWeight, shape.doubleWeight, shape.stringWeight, shape.vectorWeight };
+		const ConfigLib::ValueType types[] = {
+			ConfigLib::ValueType::Int, ConfigLib::ValueType::Double,
+			ConfigLib::ValueType::String, ConfigLib::ValueType::DoubleVector
+		};
+		int totalWeight = 0;
+		for (int& weight : weights) {
+			if (weight < 0) weight = 0;
+			totalWeight += weight;
+		}
+		if (totalWeight == 0) totalWeight = weights[1] = 1;
+
+		const size_t count = static_cast<size_t>(shape.sections) * static_cast<size_t>(shape.keysPerSection);
+		keys.reserve(count);
+		for (int s = 0; s < shape.sections; ++s) {
+			const std::string section = "Section" + std::to_string(s);
+			for (int k = 0; k < shape.keysPerSection; ++k) {
+				int pick = static_cast<int>(random.below(static_cast<uint64_t>(totalWeight)));
+				size_t t = 0;
+				while (pick >= weights[t]) pick -= weights[t++];
+
+				GeneratedKey key{section, "key_" + std::to_string(k), types[t], std::string()};
+				switch (key.type) {
+					case ConfigLib::ValueType::Int:
+						key.value = std::to_string(random.below(1000000));
+						break;
+					case ConfigLib::ValueType::Double:
+						key.value = formatDouble(random.unit() * 1000.0);
+						break;
+					case ConfigLib::ValueType::String:
+						key.value = kWords[random.below(kWords.size())];
+						break;
+					case ConfigLib::ValueType::DoubleVector:
+						for (int i = 0; i < shape.vectorLength; ++i) {
+							if (i > 0) key.value += ", ";
+							key.value += formatDouble(random.unit() * 100.0);
+						}
+						break;
+				}
+				keys.push_back(std::move(key));
+				commentBefore.push_back(random.unit() < shape.commentDensity);
+				commentAfter.push_back(random.unit() < shape.commentDensity);
+			}
+		}
+		omitted.assign(keys.size(), false);
+
+		// keys no longer moves, so its strings can back the schema
+		for (const auto& key : keys) {
+			if (schema.empty() || schema.back().name != key.section) {
+				schema.push_back({key.section, {}});
+				schema.back().items.reserve(static_cast<size_t>(shape.keysPerSection));
+			}
+			const ValidationRules::Rule* rule = nullptr;
+			if (key.type == ConfigLib::ValueType::Int || key.type == ConfigLib::ValueType::Double) {
+				rule = &ValidationRules::greaterThanOrEqualToZero;
+			} else if (key.type == ConfigLib::ValueType::String) {
+				rule = stringRule.get();
+			}
+			schema.back().items.push_back({key.name.c_str(), ConfigLib::valueTypeName(key.type),
+				defaultFor(key.type), "generated", rule});
+		}
+	}
+
+	std::string IniGenerator::generate() const {
+		std::string contents = "# Synthetic benchmark input\n";
+		const std::string* section = nullptr;
+		for (size_t i = 0; i < keys.size(); ++i) {
+			if (omitted[i]) continue;
+			const GeneratedKey& key = keys[i];
+			if (!section || *section != key.section) {
+				contents += "\n[" + key.section + "]\n";
+				section = &key.section;
+			}
+			if (commentBefore[i]) contents += "# " + key.name + ": " + ConfigLib::valueTypeName(key.type) + "\n";
+			contents += key.name + " = " + key.value;
+			if (commentAfter[i]) contents += "   # generated";
+			contents += "\n";
+		}
+		return contents;
+	}
+
+} // namespace Bench
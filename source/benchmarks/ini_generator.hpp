@@ -0,0 +1,98 @@
+#ifndef INI_GENERATOR_H
+#define INI_GENERATOR_H
+
+#include "config_library/config_reader.hpp"
+#include "config_library/config_schema.hpp"
+#include "config_library/validation_rules.hpp"
+#include "config_library/value_type.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Bench {
+
+    // Shape of a synthetic config file.
+    struct IniShape {
+        int sections = 100;
+        int keysPerSection = 50;
+        // Relative weights of the value types given to keys; a type of weight 0 is never used.
+        int intWeight = 1;
+        int doubleWeight = 1;
+        int stringWeight = 1;
+        int vectorWeight = 1;
+        int vectorLength = 4;
+        // Chance, from 0 to 1, that a key is preceded by a comment line, and independently that
+        // its value carries a trailing comment.
+        double commentDensity = 0.1;
+        uint64_t seed = 1;
+    };
+
+    struct GeneratedKey {
+        std::string section;
+        std::string name;
+        ConfigLib::ValueType type;
+        std::string value;   // as written to the file
+    };
+
+    // Synthetic INI files and the schema that declares them. Keys and values are drawn from a
+    // generator of its own rather than <random>, so a shape and seed give the same bytes with
+    // every standard library. Every int and double key is declared with the rule
+    // greaterThanOrEqualToZero and every string key with an InList rule its values all pass,
+    // so a load validates each key and rejects none.
+    class IniGenerator {
+    public:
+        explicit IniGenerator(const IniShape& shape);
+
+        IniGenerator(const IniGenerator&) = delete;
+        IniGenerator& operator=(const IniGenerator&) = delete;
+
+        const IniShape& getShape() const { return shape; }
+        // In file order.
+        const std::vector<GeneratedKey>& getKeys() const { return keys; }
+        // Its items point into the generator, which must outlive every reader given it.
+        const std::vector<ConfigLib::ConfigGen::ConfigSection>& getSchema() const { return schema; }
+        const ValidationRules::Rule& getStringRule() const { return *stringRule; }
+
+        std::string generate() const;
+
+        // Edits for the next generate(). The schema is unchanged: it still declares an omitted
+        // key, and a section whose keys are all omitted loses its header as well.
+        void setValue(size_t index, std::string value) { keys[index].value = std::move(value); }
+        void omit(size_t index, bool omitted = true) { this->omitted[index] = omitted; }
+
+    private:
+        IniShape shape;
+        std::vector<GeneratedKey> keys;
+        std::vector<bool> commentBefore;
+        std::vector<bool> commentAfter;
+        std::vector<bool> omitted;
+        std::unique_ptr<ValidationRules::Rule> stringRule;
+        std::vector<ConfigLib::ConfigGen::ConfigSection> schema;
+    };
+
+    // A reader of the file at path, declared by schema, or by a generator's schema, in which
+    // case the generator must outlive the reader.
+    class GeneratedConfig : public ConfigLib::ConfigReader {
+    public:
+        GeneratedConfig(const IniGenerator& generator, std::string path)
+            : path(std::move(path)), schema(&generator.getSchema()) {}
+        GeneratedConfig(std::vector<ConfigLib::ConfigGen::ConfigSection> sections, std::string path)
+            : path(std::move(path)), ownSchema(std::move(sections)), schema(&ownSchema) {}
+
+        std::string getConfigFilePath() const override { return path; }
+        std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override { return *schema; }
+
+        // loadConfig(): the file again, into the current values, with the schema index as it is.
+        void loadFile() { loadConfig(); }
+
+    private:
+        std::string path;
+        std::vector<ConfigLib::ConfigGen::ConfigSection> ownSchema;
+        const std::vector<ConfigLib::ConfigGen::ConfigSection>* schema;
+    };
+
+} // namespace Bench
+
+#endif // INI_GENERATOR_H
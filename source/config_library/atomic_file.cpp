@@ -0,0 +1,104 @@
+#include "atomic_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ConfigLib {
+
+	namespace {
+#ifdef _WIN32
+		void writeAndFlush(const std::string& path, std::string_view contents) {
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Unable to create " + path);
+			size_t written = 0;
+			bool ok = true;
+			while (ok && written < contents.size()) {
+				DWORD chunk = 0;
+				const DWORD request = static_cast<DWORD>(std::min<size_t>(contents.size() - written, 1u << 30));
+				ok = WriteFile(file, contents.data() + written, request, &chunk, nullptr) != 0;
+				written += chunk;
+			}
+			ok = ok && FlushFileBuffers(file) != 0;
+			CloseHandle(file);
+			if (!ok) throw std::runtime_error("Unable to write " + path);
+		}
+
+		void replace(const std::string& from, const std::string& to) {
+			if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+				throw std::runtime_error("Unable to replace " + to);
+			}
+		}
+#else
+		std::runtime_error failure(const std::string& what, const std::string& path) {
+			return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+		}
+
+		void writeAndFlush(const std::string& path, std::string_view contents) {
+			const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (fd < 0) throw failure("Unable to create", path);
+			size_t written = 0;
+			while (written < contents.size()) {
+				const ssize_t chunk = ::write(fd, contents.data() + written, contents.size() - written);
+				if (chunk < 0 && errno == EINTR) continue;
+				if (chunk < 0) {
+					const std::runtime_error error = failure("Unable to write", path);
+					::close(fd);
+					throw error;
+				}
+				written += static_cast<size_t>(chunk);
+			}
+			if (::fsync(fd) != 0) {
+				const std::runtime_error error = failure("Unable to flush", path);
+				::close(fd);
+				throw error;
+			}
+			if (::close(fd) != 0) throw failure("Unable to close", path);
+		}
+
+		void replace(const std::string& from, const std::string& to) {
+			if (std::rename(from.c_str(), to.c_str()) != 0) throw failure("Unable to replace", to);
+			// The rename itself is durable only once the directory is flushed too
+			const std::filesystem::path parent = std::filesystem::path(to).parent_path();
+			const int directory = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY);
+			if (directory >= 0) {
+				::fsync(directory);
+				::close(directory);
+			}
+		}
+#endif
+	}
+
+	void writeFileAtomically(const std::string& path, std::string_view contents) {
+		// Writers racing on the same file each use their own temporary
+		const std::string temporary = path + ".tmp" + std::to_string(std::random_device()());
+		try {
+			writeAndFlush(temporary, contents);
+			std::error_code error;
+			const auto status = std::filesystem::status(path, error);
+			if (!error && std::filesystem::exists(status)) {
+				std::filesystem::permissions(temporary, status.permissions(), error);
+			}
+			replace(temporary, path);
+		} catch (...) {
+			std::remove(temporary.c_str());
+			throw;
+		}
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,17 @@
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <string>
+#include <string_view>
+
+namespace ConfigLib {
+
+// Replaces the file at path with contents so that a crash at any point leaves either the old
+// or the new file, never a mix: contents go to a temporary file next to it in one write, which
+// is flushed to disk and then renamed over path. An existing file's permissions carry over.
+// Throws std::runtime_error on failure, leaving path untouched.
+void writeFileAtomically(const std::string& path, std::string_view contents);
+
+} // namespace ConfigLib
+
+#endif // ATOMIC_FILE_H
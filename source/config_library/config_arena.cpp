@@ -0,0 +1,13 @@
+#include "config_arena.hpp"
+
+namespace ConfigLib {
+
+	ConfigArena::ConfigArena(size_t initialSize)
+		: blocks(initialSize > 0 ? initialSize : 4096, std::pmr::new_delete_resource()) {}
+
+	void* ConfigArena::do_allocate(size_t bytes, size_t alignment) {
+		allocated += bytes;
+		return blocks.allocate(bytes, alignment);
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,30 @@
+#ifndef CONFIG_ARENA_H
+#define CONFIG_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace ConfigLib {
+
+// Memory resource backing one generation of parsed config. Allocation bumps a pointer
+// through large blocks and deallocation does nothing; everything is returned at once when
+// the arena is destroyed. The bytes handed out are counted, so that the next generation
+// can start with a single block of about the right size.
+class ConfigArena : public std::pmr::memory_resource {
+public:
+    explicit ConfigArena(size_t initialSize = 0);
+
+    size_t bytesAllocated() const { return allocated; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::monotonic_buffer_resource blocks;
+    size_t allocated = 0;
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_ARENA_H
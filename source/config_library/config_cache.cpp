@@ -0,0 +1,289 @@
+#include "config_cache.hpp"
+#include "config_reader.hpp"
+#include "config_log.hpp"
+#include "hash_bytes.hpp"
+#include "mapped_file.hpp"
+#include "schema_index.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+namespace ConfigLib {
+
+	namespace {
+		const char kMagic[8] = {'C', 'F', 'G', 'C', 'A', 'C', 'H', 'E'};
+		// Bumped whenever the layout changes
+		const uint32_t kVersion = 1;
+		// Reads back differently on a machine of the other byte order
+		const uint32_t kByteOrderMark = 0x01020304u;
+
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t byteOrder;
+			uint64_t fileSize;
+			int64_t modified;
+			uint64_t contentHash;
+			uint64_t schemaHash;
+			uint32_t pathOffset;      // the INI path, in the data area
+			uint32_t pathLength;
+			uint32_t sectionCount;
+			uint32_t entryCount;
+			uint64_t dataSize;
+			uint64_t bodyHash;        // of everything after the header
+		};
+
+		struct SectionRecord {
+			uint32_t nameOffset;
+			uint32_t nameLength;
+			uint32_t firstEntry;
+			uint32_t entryCount;
+		};
+
+		struct EntryRecord {
+			uint32_t keyOffset;
+			uint32_t keyLength;
+			uint32_t type;            // ValueType
+			uint32_t count;           // string length or list size
+			uint64_t bits;            // int or double bits, or the data offset of a string or list
+		};
+
+		static_assert(sizeof(Header) % 8 == 0 && sizeof(SectionRecord) % 8 == 0 && sizeof(EntryRecord) % 8 == 0,
+			"Cache records must keep the data area 8-byte aligned");
+
+		uint32_t appendText(std::string& data, std::string_view text) {
+			const uint32_t offset = static_cast<uint32_t>(data.size());
+			data.append(text.data(), text.size());
+			return offset;
+		}
+
+		bool inData(uint64_t offset, uint64_t length, uint64_t dataSize) {
+			return offset <= dataSize && length <= dataSize - offset;
+		}
+	}
+
+	std::string ConfigCache::pathFor(const std::string& iniPath) {
+		return iniPath + ".cache";
+	}
+
+	uint64_t ConfigCache::schemaHash(const ConfigGen::SchemaIndex& schema) {
+		uint64_t hash = schema.size();
+		const auto mix = [&hash](std::string_view text) { hash = (hash ^ hashBytes(text)) * 0x9e3779b97f4a7c15ull; };
+		for (const auto& entry : schema.getEntries()) {
+			mix(entry.section);
+			mix(entry.key);
+			mix(valueTypeName(entry.type));
+			mix(entry.defaultValue);
+			mix(entry.validationRule ? entry.validationRule->toString() : std::string());
+		}
+		return hash;
+	}
+
+	bool ConfigCache::describe(const std::string& path, std::string_view contents, uint64_t schemaHash, CacheKey& key) {
+		std::error_code error;
+		const auto modified = std::filesystem::last_write_time(path, error);
+		if (error) return false;
+		key.path = path;
+		key.fileSize = contents.size();
+		key.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+		key.contentHash = hashBytes(contents);
+		key.schemaHash = schemaHash;
+		return true;
+	}
+
+	bool ConfigCache::read(const std::string& cachePath, const CacheKey& key, ConfigGeneration& target) {
+		MappedFile file;
+		if (!file.open(cachePath)) return false;
+		const std::string_view bytes = file.view();
+		if (bytes.size() < sizeof(Header)) return false;
+
+		Header header;
+		std::memcpy(&header, bytes.data(), sizeof(Header));
+		if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+			|| header.byteOrder != kByteOrderMark) {
+			return false;
+		}
+		if (header.fileSize != key.fileSize || header.modified != key.modified
+			|| header.contentHash != key.contentHash || header.schemaHash != key.schemaHash) {
+			CONFIG_LOG_DEBUG("Config cache " << cachePath << " is stale");
+			return false;
+		}
+
+		const uint64_t tablesSize = uint64_t(header.sectionCount) * sizeof(SectionRecord)
+			+ uint64_t(header.entryCount) * sizeof(EntryRecord);
+		if (bytes.size() - sizeof(Header) != tablesSize + header.dataSize
+			|| hashBytes(bytes.substr(sizeof(Header))) != header.bodyHash) {
+			CONFIG_LOG_WARN("Config cache " << cachePath << " is damaged, ignoring it");
+			return false;
+		}
+
+		// The mapping is page-aligned and every table is a multiple of 8 bytes long
+		const char* base = bytes.data() + sizeof(Header);
+		const auto* sections = reinterpret_cast<const SectionRecord*>(base);
+		const auto* entries = reinterpret_cast<const EntryRecord*>(sections + header.sectionCount);
+		const char* data = reinterpret_cast<const char*>(entries + header.entryCount);
+		const auto text = [data](uint64_t offset, uint64_t length) { return std::string_view(data + offset, length); };
+
+		if (!inData(header.pathOffset, header.pathLength, header.dataSize)
+			|| text(header.pathOffset, header.pathLength) != key.path) {
+			return false;
+		}
+
+		// Check every record before touching target
+		for (uint32_t s = 0; s < header.sectionCount; ++s) {
+			const SectionRecord& section = sections[s];
+			if (!inData(section.nameOffset, section.nameLength, header.dataSize)
+				|| section.firstEntry > header.entryCount || section.entryCount > header.entryCount - section.firstEntry) {
+				return false;
+			}
+		}
+		for (uint32_t e = 0; e < header.entryCount; ++e) {
+			const EntryRecord& entry = entries[e];
+			if (!inData(entry.keyOffset, entry.keyLength, header.dataSize)) return false;
+			switch (static_cast<ValueType>(entry.type)) {
+				case ValueType::Int:
+				case ValueType::Double:
+					break;
+				case ValueType::String:
+					if (!inData(entry.bits, entry.count, header.dataSize)) return false;
+					break;
+				case ValueType::DoubleVector:
+					if (entry.bits % 8 != 0 || entry.count > header.dataSize / 8
+						|| !inData(entry.bits, uint64_t(entry.count) * 8, header.dataSize)) {
+						return false;
+					}
+					break;
+				default:
+					return false;
+			}
+		}
+
+		for (uint32_t s = 0; s < header.sectionCount; ++s) {
+			const SectionRecord& record = sections[s];
+			ConfigSection& section = target.getOrAddSection(text(record.nameOffset, record.nameLength));
+			section.reserve(section.getEntries().size() + record.entryCount);
+			std::pmr::memory_resource* resource = section.resource();
+			for (uint32_t e = record.firstEntry; e < record.firstEntry + record.entryCount; ++e) {
+				const EntryRecord& entry = entries[e];
+				StoredValue& value = section.findOrAddEntry(text(entry.keyOffset, entry.keyLength)).value;
+				switch (static_cast<ValueType>(entry.type)) {
+					case ValueType::Int:
+						value.set(static_cast<int>(static_cast<int64_t>(entry.bits)), resource);
+						break;
+					case ValueType::Double: {
+						double number;
+						std::memcpy(&number, &entry.bits, sizeof(number));
+						value.set(number, resource);
+						break;
+					}
+					case ValueType::String:
+						value.set(text(entry.bits, entry.count), resource);
+						break;
+					case ValueType::DoubleVector:
+						value.set(reinterpret_cast<const double*>(data + entry.bits), entry.count, resource);
+						break;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool ConfigCache::write(const std::string& cachePath, const CacheKey& key, const ConfigGeneration& source) {
+		std::vector<SectionRecord> sections;
+		std::vector<EntryRecord> entries;
+		std::string data;
+
+		Header header = {};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.byteOrder = kByteOrderMark;
+		header.fileSize = key.fileSize;
+		header.modified = key.modified;
+		header.contentHash = key.contentHash;
+		header.schemaHash = key.schemaHash;
+		header.pathOffset = appendText(data, key.path);
+		header.pathLength = static_cast<uint32_t>(key.path.size());
+
+		for (const auto& section : source.getSections()) {
+			SectionRecord record = {};
+			record.nameOffset = appendText(data, section.getName());
+			record.nameLength = static_cast<uint32_t>(section.getName().size());
+			record.firstEntry = static_cast<uint32_t>(entries.size());
+			for (const auto& entry : section.getEntries()) {
+				// Rules are not cached; the reader sets them from the schema after loading
+				if (entry.value.empty()) continue;
+				// The cache holds values, and an array file may change without the config file
+				if (entry.value.isExternal()) {
+					CONFIG_LOG_DEBUG("Not caching " << key.path << ", which refers to array files");
+					return false;
+				}
+				EntryRecord out = {};
+				out.keyOffset = appendText(data, entry.key);
+				out.keyLength = static_cast<uint32_t>(entry.key.size());
+				out.type = static_cast<uint32_t>(entry.value.type());
+				if (const int* number = entry.value.get<int>()) {
+					out.bits = static_cast<uint64_t>(static_cast<int64_t>(*number));
+				} else if (const double* number = entry.value.get<double>()) {
+					std::memcpy(&out.bits, number, sizeof(*number));
+				} else if (const std::pmr::string* str = entry.value.get<std::string>()) {
+					out.bits = appendText(data, *str);
+					out.count = static_cast<uint32_t>(str->size());
+				} else if (const DoubleList* list = entry.value.get<std::vector<double>>()) {
+					data.resize((data.size() + 7) & ~size_t(7), '\0');
+					out.bits = data.size();
+					out.count = static_cast<uint32_t>(list->size());
+					data.append(reinterpret_cast<const char*>(list->data()), list->size() * sizeof(double));
+				}
+				entries.push_back(out);
+			}
+			record.entryCount = static_cast<uint32_t>(entries.size()) - record.firstEntry;
+			if (record.entryCount) sections.push_back(record);
+		}
+		if (data.size() > UINT32_MAX) {
+			CONFIG_LOG_WARN("Config too large to cache: " << key.path);
+			return false;
+		}
+
+		header.sectionCount = static_cast<uint32_t>(sections.size());
+		header.entryCount = static_cast<uint32_t>(entries.size());
+		header.dataSize = data.size();
+
+		std::string body;
+		body.reserve(sections.size() * sizeof(SectionRecord) + entries.size() * sizeof(EntryRecord) + data.size());
+		body.append(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(SectionRecord));
+		body.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(EntryRecord));
+		body += data;
+		header.bodyHash = hashBytes(body);
+
+		// Processes compiling the same cache at the same time each write their own temporary
+		const std::string temporary = cachePath + ".tmp" + std::to_string(std::random_device()());
+		{
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			if (!out.is_open()) {
+				CONFIG_LOG_WARN("Unable to write config cache: " << temporary);
+				return false;
+			}
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(body.data(), static_cast<std::streamsize>(body.size()));
+			out.close();
+			if (!out) {
+				CONFIG_LOG_WARN("Unable to write config cache: " << temporary);
+				std::remove(temporary.c_str());
+				return false;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(temporary, cachePath, error);
+		if (error) {
+			CONFIG_LOG_WARN("Unable to replace config cache " << cachePath << ": " << error.message());
+			std::remove(temporary.c_str());
+			return false;
+		}
+		return true;
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,55 @@
+#ifndef CONFIG_CACHE_H
+#define CONFIG_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ConfigLib {
+
+class ConfigGeneration;
+namespace ConfigGen {
+    class SchemaIndex;
+}
+
+// Identity of the text a cache was compiled from. A cache is only used for the exact file,
+// contents and schema it was written for.
+struct CacheKey {
+    std::string path;
+    uint64_t fileSize = 0;
+    int64_t modified = 0;        // last write time, in the file clock's ticks
+    uint64_t contentHash = 0;
+    uint64_t schemaHash = 0;
+};
+
+// Compiled form of a loaded config file: the parsed, validated and typed values in one flat
+// file, read back through a memory mapping without tokenizing or validating anything.
+// Layout, all little-endian with native alignment:
+//   header | section table | entry table | data
+// Entries hold ints and doubles inline; strings and double lists are offsets into the data
+// area, lists aligned to 8 bytes. The header carries the CacheKey and a hash of everything
+// after it, so a stale, truncated or damaged cache is rejected rather than trusted.
+class ConfigCache {
+public:
+    // Where the cache for an INI file lives: next to it, as <file>.cache.
+    static std::string pathFor(const std::string& iniPath);
+
+    // Everything in the schema that decides which values a load produces: section and key
+    // names, types, defaults and validation rules.
+    static uint64_t schemaHash(const ConfigGen::SchemaIndex& schema);
+
+    // Describes the file at path, whose contents are given. Returns false if it cannot be stat'ed.
+    static bool describe(const std::string& path, std::string_view contents, uint64_t schemaHash, CacheKey& key);
+
+    // Adds the cached values to target if the cache at cachePath was compiled for exactly key.
+    // Returns false, leaving target untouched, if the cache is missing, stale or damaged.
+    static bool read(const std::string& cachePath, const CacheKey& key, ConfigGeneration& target);
+
+    // Writes source's values to cachePath through a temporary file and a rename, so that
+    // concurrent readers see either the old cache or the new one. Returns false on failure.
+    static bool write(const std::string& cachePath, const CacheKey& key, const ConfigGeneration& source);
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_CACHE_H
@@ -0,0 +1,218 @@
+#include "config_codegen.hpp"
+#include "number_codec.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+namespace ConfigLib {
+	namespace ConfigGen {
+
+		namespace {
+			const char* const kKeywords[] = {
+				"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case",
+				"catch", "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "const_cast",
+				"consteval", "constexpr", "constinit", "continue", "co_await", "co_return", "co_yield", "decltype",
+				"default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+				"false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace",
+				"new", "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected",
+				"public", "register", "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+				"static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw",
+				"true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+				"volatile", "wchar_t", "while", "xor", "xor_eq"
+			};
+
+			// Members that every generated struct declares next to the section members
+			const char* const kReservedMembers[] = {"fields", "fieldCount", "forEachField", "load", "save"};
+
+			struct Field {
+				const ConfigItem* item;
+				ValueType type;
+				std::string member;
+			};
+
+			struct Group {
+				std::string name;
+				std::string member;
+				std::vector<Field> fields;
+			};
+
+			std::string quote(const std::string& text) {
+				std::string out = "\"";
+				for (char c : text) {
+					switch (c) {
+						case '"': out += "\\\""; break;
+						case '\\': out += "\\\\"; break;
+						case '\n': out += "\\n"; break;
+						case '\t': out += "\\t"; break;
+						default: out += c; break;
+					}
+				}
+				return out + "\"";
+			}
+
+			std::string doubleLiteral(double value) {
+				if (std::isnan(value)) return "std::numeric_limits<double>::quiet_NaN()";
+				if (std::isinf(value)) return value > 0 ? "std::numeric_limits<double>::infinity()" : "-std::numeric_limits<double>::infinity()";
+				std::string text = NumberCodec::formatDouble(value);
+				// Keep it a double literal, so that braced initializers never narrow
+				if (text.find_first_of(".eE") == std::string::npos) text += ".0";
+				return text;
+			}
+
+			// The member's type and its default as a C++ initializer
+			std::pair<const char*, std::string> declaration(const Field& field, const std::string& where) {
+				const std::string text = field.item->defaultValue;
+				switch (field.type) {
+					case ValueType::Int: {
+						int value;
+						if (!NumberCodec::parseInt(text, value)) break;
+						// INT_MIN has no literal of type int
+						return {"int", value == std::numeric_limits<int>::min() ? "-2147483647 - 1" : NumberCodec::formatInt(value)};
+					}
+					case ValueType::Double: {
+						double value;
+						if (!NumberCodec::parseDouble(text, value)) break;
+						return {"double", doubleLiteral(value)};
+					}
+					case ValueType::DoubleVector: {
+						std::vector<double> values;
+						if (!NumberCodec::parseDoubleList(text, values)) break;
+						std::string list = "{";
+						for (size_t i = 0; i < values.size(); ++i) list += (i ? ", " : "") + doubleLiteral(values[i]);
+						return {"std::vector<double>", list + "}"};
+					}
+					case ValueType::String:
+						return {"std::string", quote(text)};
+				}
+				throw std::invalid_argument("Default value of " + where + " is not a valid " + valueTypeName(field.type) + ": " + text);
+			}
+
+			void checkUnique(std::set<std::string>& used, const std::string& identifier, const std::string& where) {
+				if (!used.insert(identifier).second) {
+					throw std::invalid_argument("The identifier " + identifier + " of " + where + " is reserved or already used by another name");
+				}
+			}
+		}
+
+		std::string identifierFor(const std::string& name) {
+			std::string out;
+			for (char c : name) out += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+			if (out.empty() || std::isdigit(static_cast<unsigned char>(out[0]))) out.insert(0, "_");
+			for (const char* keyword : kKeywords) {
+				if (out == keyword) return out + "_";
+			}
+			return out;
+		}
+
+		std::string generateStruct(const std::string& structName, const std::vector<ConfigSection>& sections,
+		                           const std::string& origin) {
+			if (identifierFor(structName) != structName) {
+				throw std::invalid_argument("Not a valid struct name: " + structName);
+			}
+			if (!validateConfig(sections)) {
+				throw std::invalid_argument("Invalid config schema for " + structName);
+			}
+
+			std::vector<Group> groups;
+			// A member may not share the name of the struct that declares it either
+			std::set<std::string> sectionMembers(std::begin(kReservedMembers), std::end(kReservedMembers));
+			sectionMembers.insert(structName);
+			size_t fieldCount = 0;
+			for (const auto& section : sections) {
+				auto group = std::find_if(groups.begin(), groups.end(), [&section](const Group& g) { return g.name == section.name; });
+				if (group == groups.end()) {
+					groups.push_back({section.name, identifierFor(section.name), {}});
+					// Members and the nested struct types share the outer struct's scope
+					checkUnique(sectionMembers, groups.back().member, "section " + section.name);
+					checkUnique(sectionMembers, groups.back().member + "Section", "section " + section.name);
+					group = groups.end() - 1;
+				}
+				for (const auto& item : section.items) {
+					group->fields.push_back({&item, parseValueType(item.type), identifierFor(item.name)});
+					++fieldCount;
+				}
+			}
+
+			const std::string guard = [&structName] {
+				std::string upper;
+				for (char c : structName) upper += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+				return upper + "_GENERATED_H";
+			}();
+
+			std::string out;
+			out += "// Generated by config_generate_struct() from " + origin + "; do not edit.\n";
+			out += "#ifndef " + guard + "\n#define " + guard + "\n\n";
+			out += "#include \"config_struct.hpp\"\n#include <cstddef>\n#include <limits>\n#include <string>\n#include <vector>\n\n";
+			out += "struct " + structName + " {\n";
+			for (const auto& group : groups) {
+				std::set<std::string> members{group.member + "Section"};
+				out += "    struct " + group.member + "Section {\n";
+				for (const auto& field : group.fields) {
+					const std::string where = group.name + "." + field.item->name;
+					checkUnique(members, field.member, where);
+					const auto decl = declaration(field, where);
+					out += "        " + std::string(decl.first) + " " + field.member + " = " + decl.second + ";\n";
+				}
+				out += "    };\n";
+				out += "    " + group.member + "Section " + group.member + ";\n\n";
+			}
+
+			out += "    static constexpr std::size_t fieldCount = " + std::to_string(fieldCount) + ";\n";
+			out += "    static constexpr ConfigLib::ConfigGen::FieldInfo fields[fieldCount] = {\n";
+			for (const auto& group : groups) {
+				for (const auto& field : group.fields) {
+					out += "        {" + quote(group.name) + ", " + quote(field.item->name) + ", ConfigLib::ValueType::";
+					switch (field.type) {
+						case ValueType::Int: out += "Int"; break;
+						case ValueType::Double: out += "Double"; break;
+						case ValueType::String: out += "String"; break;
+						case ValueType::DoubleVector: out += "DoubleVector"; break;
+					}
+					out += ", " + quote(field.item->defaultValue) + ", " + quote(field.item->description) + "},\n";
+				}
+			}
+			out += "    };\n\n";
+
+			// Both overloads visit the members in the order of fields
+			for (const char* qualifier : {"", " const"}) {
+				out += "    // Calls visit(const FieldInfo&, member) for every member, in schema order.\n";
+				out += "    template<typename Visitor>\n";
+				out += std::string("    void forEachField(Visitor&& visit)") + qualifier + " {\n";
+				size_t index = 0;
+				for (const auto& group : groups) {
+					for (const auto& field : group.fields) {
+						out += "        visit(fields[" + std::to_string(index++) + "], " + group.member + "." + field.member + ");\n";
+					}
+				}
+				out += "    }\n\n";
+			}
+
+			out += "    // Every member read from one generation of reader, in a single pass. Keys without a value\n";
+			out += "    // keep their defaults. Throws std::runtime_error if a value has another type or fails its rule.\n";
+			out += "    static " + structName + " load(const ConfigLib::ConfigReader& reader) {\n";
+			out += "        " + structName + " config;\n";
+			out += "        ConfigLib::ConfigGen::StructLoader loader(reader);\n";
+			out += "        config.forEachField([&loader](const ConfigLib::ConfigGen::FieldInfo& field, auto& value) { loader.read(field, value); });\n";
+			out += "        loader.finish();\n";
+			out += "        return config;\n";
+			out += "    }\n\n";
+			out += "    // Writes every member back through ConfigReader::setValue, which applies the validation rules.\n";
+			out += "    // Lists still equal to the array file they were loaded from keep their @path reference.\n";
+			out += "    void save(ConfigLib::ConfigReader& reader) const {\n";
+			out += "        ConfigLib::ConfigGen::StructSaver saver(reader);\n";
+			out += "        forEachField([&saver](const ConfigLib::ConfigGen::FieldInfo& field, const auto& value) {\n";
+			out += "            saver.write(field, value);\n";
+			out += "        });\n";
+			out += "    }\n";
+			out += "};\n\n";
+			out += "#endif // " + guard + "\n";
+			return out;
+		}
+
+	}
+} // namespace ConfigLib
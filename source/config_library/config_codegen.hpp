@@ -0,0 +1,27 @@
+#ifndef CONFIG_CODEGEN_H
+#define CONFIG_CODEGEN_H
+
+#include "config_schema.hpp"
+#include <string>
+#include <vector>
+
+namespace ConfigLib {
+namespace ConfigGen {
+
+// Text of a header declaring structName with one nested struct per section and one typed
+// member per key, initialized to the key's default, together with a FieldInfo table, forEachField(),
+// load() and save(). Sections declared more than once are merged. origin is quoted in the header
+// comment. Throws std::invalid_argument if the schema fails validateConfig(), a default does not
+// parse as its type, two names map to the same C++ identifier, or a section maps to one of the
+// struct's own members (fields, fieldCount, forEachField, load, save) or to structName.
+std::string generateStruct(const std::string& structName, const std::vector<ConfigSection>& sections,
+                           const std::string& origin);
+
+// name with every character that cannot appear in an identifier replaced by '_', and a
+// trailing '_' on C++ keywords, including the alternative operator tokens such as and_eq.
+std::string identifierFor(const std::string& name);
+
+} // namespace ConfigGen
+} // namespace ConfigLib
+
+#endif // CONFIG_CODEGEN_H
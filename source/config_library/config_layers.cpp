@@ -0,0 +1,264 @@
+#include "config_layers.hpp"
+#include "config_log.hpp"
+#include "ini_stream.hpp"
+#include "mapped_file.hpp"
+#include <cctype>
+#include <memory_resource>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+extern char** environ;
+#endif
+
+namespace ConfigLib {
+
+	namespace {
+		// Upper case, with every character other than a letter or digit as '_'
+		std::string environmentName(std::string_view text) {
+			std::string name(text);
+			for (char& c : name) {
+				const unsigned char u = static_cast<unsigned char>(c);
+				c = std::isalnum(u) ? static_cast<char>(std::toupper(u)) : '_';
+			}
+			return name;
+		}
+
+		char** environmentBlock() {
+#ifdef _WIN32
+			return _environ;
+#else
+			return environ;
+#endif
+		}
+	}
+
+	ConfigLayer ConfigLayer::defaults() {
+		return ConfigLayer(Kind::Defaults, "defaults");
+	}
+
+	ConfigLayer ConfigLayer::file(std::string path) {
+		return ConfigLayer(Kind::File, std::move(path));
+	}
+
+	ConfigLayer ConfigLayer::environment(std::string prefix) {
+		return ConfigLayer(Kind::Environment, std::move(prefix));
+	}
+
+	ConfigLayer ConfigLayer::arguments(int argc, const char* const* argv) {
+		ConfigLayer layer(Kind::Arguments, "arguments");
+		for (int i = 0; i < argc; ++i) {
+			std::string_view argument = argv[i];
+			if (argument.substr(0, 2) != "--") continue;
+			argument.remove_prefix(2);
+			const size_t equals = argument.find('=');
+			if (equals == std::string_view::npos) continue;
+			const size_t dot = argument.rfind('.', equals);
+			if (dot == std::string_view::npos || dot == 0 || dot + 1 == equals) continue;
+			layer.assignments.push_back({std::string(argument.substr(0, dot)), std::string(argument.substr(dot + 1, equals - dot - 1)),
+				std::string(argument.substr(equals + 1))});
+		}
+		return layer;
+	}
+
+	ConfigLayer ConfigLayer::values(std::string name, std::vector<Value> values) {
+		ConfigLayer layer(Kind::Values, std::move(name));
+		layer.assignments = std::move(values);
+		return layer;
+	}
+
+	LayeredConfig& LayeredConfig::add(ConfigLayer layer) {
+		layers.push_back({std::move(layer), Texts()});
+		return *this;
+	}
+
+	LayeredConfig::Texts LayeredConfig::read(const ConfigLayer& layer) const {
+		const ConfigGen::SchemaIndex& schema = *reader.schema;
+		Texts texts;
+		switch (layer.getKind()) {
+			case ConfigLayer::Kind::Defaults:
+				texts.reserve(schema.size());
+				for (const auto& entry : schema.getEntries()) texts.emplace(&entry, entry.defaultValue);
+				break;
+			case ConfigLayer::Kind::File: {
+				MappedFile file;
+				if (!file.open(layer.getName())) {
+					CONFIG_LOG_DEBUG("Layer file " << layer.getName() << " not found; it sets nothing");
+					break;
+				}
+				// As in the loader: keys outside the schema are ignored, and the last occurrence wins
+				IniStreamReader stream(file.view());
+				const ConfigGen::SchemaIndex::KeyTable* sectionKeys = nullptr;
+				for (IniEvent event; stream.next(event);) {
+					if (event.kind == IniEvent::Kind::Section) {
+						sectionKeys = schema.findSection(event.section);
+					} else if (event.kind == IniEvent::Kind::KeyValue && sectionKeys) {
+						if (const ConfigGen::SchemaEntry* entry = ConfigGen::SchemaIndex::find(sectionKeys, event.key)) {
+							texts[entry].assign(event.value.data(), event.value.size());
+						}
+					}
+				}
+				break;
+			}
+			case ConfigLayer::Kind::Environment: {
+				const std::string& prefix = layer.getName();
+				std::unordered_map<std::string, const ConfigGen::SchemaEntry*> names;
+				for (const auto& entry : schema.getEntries()) {
+					names.emplace(environmentName(entry.section) + "__" + environmentName(entry.key), &entry);
+				}
+				for (char** variable = environmentBlock(); variable && *variable; ++variable) {
+					const std::string_view text = *variable;
+					const size_t equals = text.find('=');
+					if (equals == std::string_view::npos || equals <= prefix.size() || text.compare(0, prefix.size(), prefix) != 0) continue;
+					const auto found = names.find(environmentName(text.substr(prefix.size(), equals - prefix.size())));
+					if (found == names.end()) {
+						CONFIG_LOG_DEBUG("Environment variable " << text.substr(0, equals) << " names no key of the schema");
+						continue;
+					}
+					texts[found->second].assign(text.substr(equals + 1));
+				}
+				break;
+			}
+			case ConfigLayer::Kind::Arguments:
+			case ConfigLayer::Kind::Values:
+				for (const auto& value : layer.getValues()) {
+					const ConfigGen::SchemaEntry* entry = schema.find(value.section, value.key);
+					if (!entry) {
+						CONFIG_LOG_WARN("Layer " << layer.getName() << " sets " << value.section << "." << value.key << ", which is not in the schema");
+						continue;
+					}
+					texts[entry] = value.text;
+				}
+				break;
+		}
+		return texts;
+	}
+
+	void LayeredConfig::resolve(const ConfigGen::SchemaEntry& entry) {
+		LoadProfile* const profile = LoadProfile::current();
+		rejected.erase(&entry);
+		StoredValue value;
+		size_t origin = kNoLayer;
+		for (size_t i = layers.size(); i-- > 0;) {
+			const auto found = layers[i].texts.find(&entry);
+			if (found == layers[i].texts.end()) continue;
+			const std::string& text = found->second;
+			std::string reason;
+			if (!value.parse(entry.type, text, std::pmr::new_delete_resource())) {
+				if (profile) profile->countParseError();
+				reason = std::string("Does not parse as ") + valueTypeName(entry.type);
+			} else if (!value.satisfies(entry.check)) {
+				if (profile) profile->countValidationFailure();
+				reason = entry.check.rule->toString();
+			} else {
+				origin = i;
+				break;
+			}
+			rejected[&entry].push_back({entry.section, entry.key, text, reason + " (layer " + layers[i].source.getName() + ")"});
+		}
+
+		if (origin == kNoLayer) {
+			value.clear();
+			origins.erase(&entry);
+		} else {
+			origins[&entry] = origin;
+		}
+		const bool defaulted = origin == kNoLayer || layers[origin].source.getKind() == ConfigLayer::Kind::Defaults;
+		if (profile && defaulted && rejected.count(&entry)) profile->countDefault();
+		resolved.push_back({&entry, std::move(value)});
+	}
+
+	void LayeredConfig::load() {
+		LoadProfile load(reader.statsCollector, "layers", LoadPhase::Schema);
+		LoadProfile* const profile = LoadProfile::current();
+		if (reader.filepath.empty()) reader.filepath = reader.getConfigFilePath();
+		if (reader.schema->empty()) reader.buildSchemaIndex();
+
+		{
+			SpanScope span(profile, "read layers", LoadPhase::FileIO);
+			for (auto& layer : layers) layer.texts = read(layer.source);
+		}
+
+		origins.clear();
+		rejected.clear();
+		resolved.clear();
+		{
+			SpanScope span(profile, "resolve", LoadPhase::Validation);
+			resolved.reserve(reader.schema->size());
+			for (const auto& entry : reader.schema->getEntries()) resolve(entry);
+		}
+		reader.applyLayers(*this, true);
+		resolved.clear();
+		if (!rejected.empty()) {
+			CONFIG_LOG_WARN(rejected.size() << " keys of " << reader.filepath << " have layer values that were passed over");
+		}
+	}
+
+	ConfigChangeSet LayeredConfig::reloadLayer(size_t index) {
+		if (index >= layers.size()) throw std::out_of_range("No such layer");
+		LoadProfile load(reader.statsCollector, "reloadLayer", LoadPhase::FileIO);
+		Texts before = std::move(layers[index].texts);
+		layers[index].texts = read(layers[index].source);
+		return update(index, before);
+	}
+
+	ConfigChangeSet LayeredConfig::setLayer(size_t index, ConfigLayer layer) {
+		if (index >= layers.size()) throw std::out_of_range("No such layer");
+		LoadProfile load(reader.statsCollector, "setLayer", LoadPhase::FileIO);
+		Texts before = std::move(layers[index].texts);
+		layers[index].source = std::move(layer);
+		layers[index].texts = read(layers[index].source);
+		return update(index, before);
+	}
+
+	ConfigChangeSet LayeredConfig::update(size_t index, const Texts& before) {
+		PhaseScope phase(LoadProfile::current(), LoadPhase::Validation);
+		const Texts& after = layers[index].texts;
+		resolved.clear();
+		const auto changed = [&](const ConfigGen::SchemaEntry* entry) {
+			// A valid value from a layer above hides this layer's entirely
+			const auto origin = origins.find(entry);
+			if (origin != origins.end() && origin->second > index) return;
+			resolve(*entry);
+		};
+		for (const auto& text : after) {
+			const auto old = before.find(text.first);
+			if (old == before.end() || old->second != text.second) changed(text.first);
+		}
+		for (const auto& text : before) {
+			if (!after.count(text.first)) changed(text.first);
+		}
+
+		try {
+			ConfigChangeSet changes = reader.applyLayers(*this, false);
+			resolved.clear();
+			return changes;
+		} catch (...) {
+			// The reader rejected the values before writing any: the old text is resolved again,
+			// so that origins match the reader and the next reload sees the change once more
+			std::vector<const ConfigGen::SchemaEntry*> entries;
+			for (const auto& value : resolved) entries.push_back(value.entry);
+			layers[index].texts = before;
+			for (const auto* entry : entries) resolve(*entry);
+			resolved.clear();
+			throw;
+		}
+	}
+
+	const ConfigLayer* LayeredConfig::getOrigin(std::string_view section, std::string_view key) const {
+		const auto origin = origins.find(reader.schema->find(section, key));
+		return origin != origins.end() ? &layers[origin->second].source : nullptr;
+	}
+
+	std::vector<ConfigViolation> LayeredConfig::getViolations() const {
+		std::vector<ConfigViolation> violations;
+		if (rejected.empty()) return violations;
+		for (const auto& entry : reader.schema->getEntries()) {
+			const auto found = rejected.find(&entry);
+			if (found != rejected.end()) violations.insert(violations.end(), found->second.begin(), found->second.end());
+		}
+		return violations;
+	}
+
+} // namespace ConfigLib
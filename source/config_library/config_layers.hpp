@@ -0,0 +1,129 @@
+#ifndef CONFIG_LAYERS_H
+#define CONFIG_LAYERS_H
+
+#include "config_reader.hpp"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ConfigLib {
+
+// One source of values for a LayeredConfig. A layer only describes where its values come
+// from; they are read, as text, by LayeredConfig.
+class ConfigLayer {
+public:
+    enum class Kind { Defaults, File, Environment, Arguments, Values };
+
+    // A value given for Section.key, as text.
+    struct Value {
+        std::string section;
+        std::string key;
+        std::string text;
+    };
+
+    // The defaults the schema declares.
+    static ConfigLayer defaults();
+    // An INI file, read again by LayeredConfig::reloadLayer(). A missing file sets nothing.
+    static ConfigLayer file(std::string path);
+    // Environment variables named <prefix><SECTION>__<KEY>, e.g. CFG_SIMULATION__NUM_STEPS.
+    // Section and key match ignoring case, with every character other than a letter or digit
+    // read as '_'.
+    static ConfigLayer environment(std::string prefix = "CFG_");
+    // Command-line arguments of the form --Section.key=value, split at the last '.' before the
+    // '='. Other arguments are skipped, so argv can be passed as it is.
+    static ConfigLayer arguments(int argc, const char* const* argv);
+    // Values given in code.
+    static ConfigLayer values(std::string name, std::vector<Value> values);
+
+    Kind getKind() const { return kind; }
+    // The file's path, the environment prefix, or the name given; "defaults" or "arguments" otherwise.
+    const std::string& getName() const { return name; }
+    // Of Arguments and Values layers.
+    const std::vector<Value>& getValues() const { return assignments; }
+
+private:
+    ConfigLayer(Kind kind, std::string name) : kind(kind), name(std::move(name)) {}
+
+    Kind kind;
+    std::string name;
+    std::vector<Value> assignments;
+};
+
+// Values from an ordered list of layers, each overriding those before it, flattened into one
+// reader. For every key of the schema the last layer that sets it to a valid value wins; a
+// value that does not parse or breaks its key's rule is recorded as a violation and the layer
+// below is tried instead. The result is published to the reader as ordinary values, so reads
+// never look at layers, e.g.
+//   LayeredConfig layers(config);
+//   layers.add(ConfigLayer::defaults()).add(ConfigLayer::file("site.ini"))
+//         .add(ConfigLayer::file("scenario.ini")).add(ConfigLayer::environment())
+//         .add(ConfigLayer::arguments(argc, argv));
+//   layers.load();
+//   double volatility = config.getValue<double>("Simulation", "volatility");
+// load() takes the place of the reader's initialize(), which must not be called on it after,
+// as it rebuilds the schema the layers refer to. Values set through the reader stay until
+// the next load() or change to the key's layers. Not thread-safe; the reader is, as usual.
+class LayeredConfig {
+public:
+    explicit LayeredConfig(ConfigReader& reader) : reader(reader) {}
+
+    LayeredConfig(const LayeredConfig&) = delete;
+    LayeredConfig& operator=(const LayeredConfig&) = delete;
+
+    // Later layers override earlier ones. Takes effect at the next load().
+    LayeredConfig& add(ConfigLayer layer);
+    size_t size() const { return layers.size(); }
+    const ConfigLayer& getLayer(size_t index) const { return layers[index].source; }
+
+    // Reads every layer and replaces all of the reader's values with the flattened result, as
+    // one write.
+    void load();
+    // Reads one layer again, such as a file that changed or the environment, and resolves only
+    // the keys whose text in that layer changed and that no layer above it overrides. Returns
+    // the values that changed. Throws std::runtime_error, with no value changed, if one would
+    // turn a list bound by a handle into an array file reference or back.
+    ConfigChangeSet reloadLayer(size_t index);
+    // Replaces one layer, such as the arguments, and resolves its keys as reloadLayer() does.
+    ConfigChangeSet setLayer(size_t index, ConfigLayer layer);
+
+    // The layer the key's value came from, or null if no layer gave it a valid value.
+    const ConfigLayer* getOrigin(std::string_view section, std::string_view key) const;
+    // Values that were passed over for a lower layer's, in schema order.
+    std::vector<ConfigViolation> getViolations() const;
+
+private:
+    friend class ConfigReader;
+
+    static constexpr size_t kNoLayer = static_cast<size_t>(-1);
+
+    using Texts = std::unordered_map<const ConfigGen::SchemaEntry*, std::string>;
+
+    struct Layer {
+        ConfigLayer source;
+        Texts texts;        // the layer's value of each schema key it sets
+    };
+
+    struct Resolved {
+        const ConfigGen::SchemaEntry* entry;
+        StoredValue value;  // empty if no layer gives one
+    };
+
+    Texts read(const ConfigLayer& layer) const;
+    // Resolves entry from the top layer down, replacing its origin and violations.
+    void resolve(const ConfigGen::SchemaEntry& entry);
+    // Re-resolves the keys whose text differs between before and layer index, then publishes them.
+    ConfigChangeSet update(size_t index, const Texts& before);
+
+    ConfigReader& reader;
+    std::vector<Layer> layers;
+    std::unordered_map<const ConfigGen::SchemaEntry*, size_t> origins;
+    std::unordered_map<const ConfigGen::SchemaEntry*, std::vector<ConfigViolation>> rejected;
+    // Handed to the reader by load() and update()
+    std::vector<Resolved> resolved;
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_LAYERS_H
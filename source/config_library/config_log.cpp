@@ -0,0 +1,128 @@
+#include "config_log.hpp"
+#include <atomic>
+#include <iostream>
+
+namespace ConfigLib {
+	namespace Log {
+
+		namespace {
+			std::atomic<int> runtimeLevel(static_cast<int>(Level::Warn));
+			std::mutex sinkMutex;
+
+			std::shared_ptr<Sink>& currentSink() {
+				static std::shared_ptr<Sink> sink = std::make_shared<StreamSink>(std::cerr);
+				return sink;
+			}
+		}
+
+		const char* levelName(Level level) {
+			switch (level) {
+				case Level::Trace: return "TRACE";
+				case Level::Debug: return "DEBUG";
+				case Level::Info: return "INFO";
+				case Level::Warn: return "WARN";
+				case Level::Error: return "ERROR";
+				case Level::Off: break;
+			}
+			return "OFF";
+		}
+
+		void StreamSink::write(Level level, const std::string& message) {
+			std::lock_guard<std::mutex> lock(mutex);
+			stream << "[" << levelName(level) << "] " << message << '\n';
+		}
+
+		void StreamSink::flush() {
+			std::lock_guard<std::mutex> lock(mutex);
+			stream.flush();
+		}
+
+		AsyncSink::AsyncSink(std::shared_ptr<Sink> target, size_t maxBatch)
+			: target(std::move(target)), maxBatch(maxBatch == 0 ? 1 : maxBatch) {
+			worker = std::thread(&AsyncSink::run, this);
+		}
+
+		AsyncSink::~AsyncSink() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wake.notify_one();
+			worker.join();
+		}
+
+		void AsyncSink::write(Level level, const std::string& message) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				queue.push_back(Record{level, message});
+			}
+			wake.notify_one();
+		}
+
+		void AsyncSink::flush() {
+			std::unique_lock<std::mutex> lock(mutex);
+			drained.wait(lock, [this] { return queue.empty() && inFlight == 0; });
+			lock.unlock();
+			if (target) target->flush();
+		}
+
+		void AsyncSink::run() {
+			std::vector<Record> batch;
+			batch.reserve(maxBatch);
+			std::unique_lock<std::mutex> lock(mutex);
+			for (;;) {
+				wake.wait(lock, [this] { return stopping || !queue.empty(); });
+				if (queue.empty() && stopping) break;
+
+				while (!queue.empty() && batch.size() < maxBatch) {
+					batch.push_back(std::move(queue.front()));
+					queue.pop_front();
+				}
+				inFlight = batch.size();
+				lock.unlock();
+
+				if (target) {
+					for (const auto& record : batch) {
+						target->write(record.level, record.message);
+					}
+				}
+				batch.clear();
+
+				lock.lock();
+				inFlight = 0;
+				if (queue.empty()) drained.notify_all();
+			}
+			lock.unlock();
+			if (target) target->flush();
+		}
+
+		void setLevel(Level level) {
+			runtimeLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+		}
+
+		Level getLevel() {
+			return static_cast<Level>(runtimeLevel.load(std::memory_order_relaxed));
+		}
+
+		bool isEnabled(Level level) {
+			return static_cast<int>(level) >= CONFIG_LOG_MIN_LEVEL
+				&& static_cast<int>(level) >= runtimeLevel.load(std::memory_order_relaxed);
+		}
+
+		void setSink(std::shared_ptr<Sink> sink) {
+			std::lock_guard<std::mutex> lock(sinkMutex);
+			currentSink() = std::move(sink);
+		}
+
+		std::shared_ptr<Sink> getSink() {
+			std::lock_guard<std::mutex> lock(sinkMutex);
+			return currentSink();
+		}
+
+		void write(Level level, const std::string& message) {
+			std::shared_ptr<Sink> sink = getSink();
+			if (sink) sink->write(level, message);
+		}
+
+	}
+} // namespace ConfigLib
@@ -0,0 +1,147 @@
+#ifndef CONFIG_LOG_H
+#define CONFIG_LOG_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Numeric log levels, usable from the preprocessor.
+#define CONFIG_LOG_LEVEL_TRACE 0
+#define CONFIG_LOG_LEVEL_DEBUG 1
+#define CONFIG_LOG_LEVEL_INFO  2
+#define CONFIG_LOG_LEVEL_WARN  3
+#define CONFIG_LOG_LEVEL_ERROR 4
+#define CONFIG_LOG_LEVEL_OFF   5
+
+// Lowest level compiled into the library. Anything below it expands to nothing.
+// Set through the CONFIG_LOG_LEVEL CMake cache variable.
+#ifndef CONFIG_LOG_MIN_LEVEL
+#define CONFIG_LOG_MIN_LEVEL CONFIG_LOG_LEVEL_WARN
+#endif
+
+namespace ConfigLib {
+namespace Log {
+
+    enum class Level {
+        Trace = CONFIG_LOG_LEVEL_TRACE,
+        Debug = CONFIG_LOG_LEVEL_DEBUG,
+        Info = CONFIG_LOG_LEVEL_INFO,
+        Warn = CONFIG_LOG_LEVEL_WARN,
+        Error = CONFIG_LOG_LEVEL_ERROR,
+        Off = CONFIG_LOG_LEVEL_OFF
+    };
+
+    const char* levelName(Level level);
+
+    class Sink {
+    public:
+        virtual ~Sink() = default;
+        virtual void write(Level level, const std::string& message) = 0;
+        virtual void flush() {}
+    };
+
+    // Writes one line per message to a stream. Only flushes when asked to.
+    class StreamSink : public Sink {
+    public:
+        explicit StreamSink(std::ostream& stream) : stream(stream) {}
+        void write(Level level, const std::string& message) override;
+        void flush() override;
+
+    private:
+        std::ostream& stream;
+        std::mutex mutex;
+    };
+
+    // Queues messages and hands them to another sink in batches from a background thread,
+    // so the thread that logs never waits on I/O.
+    class AsyncSink : public Sink {
+    public:
+        explicit AsyncSink(std::shared_ptr<Sink> target, size_t maxBatch = 256);
+        ~AsyncSink() override;
+
+        AsyncSink(const AsyncSink&) = delete;
+        AsyncSink& operator=(const AsyncSink&) = delete;
+
+        void write(Level level, const std::string& message) override;
+        // Blocks until everything queued so far has reached the target sink.
+        void flush() override;
+
+    private:
+        struct Record {
+            Level level;
+            std::string message;
+        };
+
+        void run();
+
+        std::shared_ptr<Sink> target;
+        size_t maxBatch;
+        std::deque<Record> queue;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable drained;
+        size_t inFlight = 0;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+    // Runtime threshold, checked after the compile-time one. Defaults to Warn.
+    void setLevel(Level level);
+    Level getLevel();
+    bool isEnabled(Level level);
+
+    // The default sink writes to std::cerr. Passing nullptr discards all messages.
+    void setSink(std::shared_ptr<Sink> sink);
+    std::shared_ptr<Sink> getSink();
+
+    void write(Level level, const std::string& message);
+
+} // namespace Log
+} // namespace ConfigLib
+
+#define CONFIG_LOG_AT(level, expr) \
+    do { \
+        if (::ConfigLib::Log::isEnabled(level)) { \
+            std::ostringstream config_log_stream_; \
+            config_log_stream_ << expr; \
+            ::ConfigLib::Log::write(level, config_log_stream_.str()); \
+        } \
+    } while (0)
+
+#if CONFIG_LOG_MIN_LEVEL <= CONFIG_LOG_LEVEL_TRACE
+#define CONFIG_LOG_TRACE(expr) CONFIG_LOG_AT(::ConfigLib::Log::Level::Trace, expr)
+#else
+#define CONFIG_LOG_TRACE(expr) ((void)0)
+#endif
+
+#if CONFIG_LOG_MIN_LEVEL <= CONFIG_LOG_LEVEL_DEBUG
+#define CONFIG_LOG_DEBUG(expr) CONFIG_LOG_AT(::ConfigLib::Log::Level::Debug, expr)
+#else
+#define CONFIG_LOG_DEBUG(expr) ((void)0)
+#endif
+
+#if CONFIG_LOG_MIN_LEVEL <= CONFIG_LOG_LEVEL_INFO
+#define CONFIG_LOG_INFO(expr) CONFIG_LOG_AT(::ConfigLib::Log::Level::Info, expr)
+#else
+#define CONFIG_LOG_INFO(expr) ((void)0)
+#endif
+
+#if CONFIG_LOG_MIN_LEVEL <= CONFIG_LOG_LEVEL_WARN
+#define CONFIG_LOG_WARN(expr) CONFIG_LOG_AT(::ConfigLib::Log::Level::Warn, expr)
+#else
+#define CONFIG_LOG_WARN(expr) ((void)0)
+#endif
+
+#if CONFIG_LOG_MIN_LEVEL <= CONFIG_LOG_LEVEL_ERROR
+#define CONFIG_LOG_ERROR(expr) CONFIG_LOG_AT(::ConfigLib::Log::Level::Error, expr)
+#else
+#define CONFIG_LOG_ERROR(expr) ((void)0)
+#endif
+
+#endif // CONFIG_LOG_H
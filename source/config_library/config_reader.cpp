@@ -1,24 +1,57 @@
 #include "config_reader.hpp"
+#include "atomic_file.hpp"
+#include "config_cache.hpp"
+#include "config_layers.hpp"
+#include "config_log.hpp"
+#include "config_transaction.hpp"
+#include "hash_bytes.hpp"
+#include "ini_stream.hpp"
+#include "ini_tokenizer.hpp"
+#include "mapped_file.hpp"
+#include "number_codec.hpp"
+#include "structural_index.hpp"
+#include "work_stealing_pool.hpp"
 #include <fstream>
-#include <sstream>
-#include <typeinfo>
-#include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
 
 
 namespace ConfigLib {
 	namespace ConfigGen {
-		// This function can be used for compile-time checks if needed
-		constexpr bool validateConfigStructure() {
-			// Add any compile-time checks here
-			return true;
-		}
-	
-		// Runtime validation of the configuration
 		bool validateConfig(const std::vector<ConfigSection>& sections) {
-			// Add runtime checks here
-			return true;
+			bool valid = true;
+			std::unordered_map<std::string, std::vector<std::string_view>> declared;
+			for (const auto& section : sections) {
+				if (section.name.empty()) {
+					CONFIG_LOG_ERROR("Config schema has a section without a name");
+					valid = false;
+				}
+				std::vector<std::string_view>& keys = declared[section.name];
+				for (const auto& item : section.items) {
+					if (!item.name || !*item.name || !item.type || !item.defaultValue || !item.description) {
+						CONFIG_LOG_ERROR("Config schema item in section " << section.name << " has a missing field");
+						valid = false;
+						continue;
+					}
+					const ValueType type = parseValueType(item.type);
+					// parseValueType() falls back to string for names it does not know
+					if (type == ValueType::String && std::strcmp(item.type, "string") != 0) {
+						CONFIG_LOG_ERROR("Unknown type " << item.type << " for " << section.name << "." << item.name);
+						valid = false;
+					}
+					if (std::find(keys.begin(), keys.end(), std::string_view(item.name)) != keys.end()) {
+						CONFIG_LOG_ERROR("Key declared twice: " << section.name << "." << item.name);
+						valid = false;
+					}
+					keys.push_back(item.name);
+				}
+			}
+			return valid;
 		}
 	
 		std::string generateConfig(const std::vector<ConfigSection>& sections) {
@@ -105,13 +138,28 @@ namespace ConfigLib {
 	void TypedConfigValue<T>::setValue(const T& val) { value = val; }
 	
 	template<typename T>
-	std::string TypedConfigValue<T>::toString() const { return std::to_string(value); }
+	std::shared_ptr<ConfigValue> TypedConfigValue<T>::clone() const { return std::make_shared<TypedConfigValue<T>>(value); }
 	
-	template<typename T>
-	void TypedConfigValue<T>::fromString(const std::string& str) { value = static_cast<T>(std::stod(str)); }
+	// Numbers go through NumberCodec: locale-independent, and doubles keep full precision
+	template<>
+	std::string TypedConfigValue<int>::toString() const { return NumberCodec::formatInt(value); }
 	
-	template<typename T>
-	std::shared_ptr<ConfigValue> TypedConfigValue<T>::clone() const { return std::make_shared<TypedConfigValue<T>>(value); }
+	template<>
+	void TypedConfigValue<int>::fromString(const std::string& str) {
+		if (!NumberCodec::parseInt(str, value)) {
+			throw std::invalid_argument("Invalid integer: " + str);
+		}
+	}
+	
+	template<>
+	std::string TypedConfigValue<double>::toString() const { return NumberCodec::formatDouble(value); }
+	
+	template<>
+	void TypedConfigValue<double>::fromString(const std::string& str) {
+		if (!NumberCodec::parseDouble(str, value)) {
+			throw std::invalid_argument("Invalid number: " + str);
+		}
+	}
 	
 	// Specialization for std::string
 	template<>
@@ -131,21 +179,13 @@ namespace ConfigLib {
 	
 	template<>
 	std::string TypedConfigValue<std::vector<double>>::toString() const {
-		std::ostringstream oss;
-		for (size_t i = 0; i < value.size(); ++i) {
-			if (i > 0) oss << ",";
-			oss << value[i];
-		}
-		return oss.str();
+		return NumberCodec::formatDoubleList(value);
 	}
 	
 	template<>
 	void TypedConfigValue<std::vector<double>>::fromString(const std::string& str) {
-		value.clear();
-		std::istringstream iss(str);
-		std::string item;
-		while (std::getline(iss, item, ',')) {
-			value.push_back(std::stod(item));
+		if (!NumberCodec::parseDoubleList(str, value)) {
+			throw std::invalid_argument("Invalid number list: " + str);
 		}
 	}
 	
@@ -154,100 +194,152 @@ namespace ConfigLib {
 		return std::make_shared<TypedConfigValue<std::vector<double>>>(value);
 	}
 	
+	const ConfigEntry* ConfigSection::findEntry(std::string_view key) const {
+		if (slots.empty()) return nullptr;
+		const size_t mask = slots.size() - 1;
+		for (size_t i = hashBytes(key) & mask;; i = (i + 1) & mask) {
+			const uint32_t slot = slots[i];
+			if (slot == kEmptySlot) return nullptr;
+			if (entries[slot].key == key) return &entries[slot];
+		}
+	}
+	
+	ConfigEntry* ConfigSection::findEntry(std::string_view key) {
+		return const_cast<ConfigEntry*>(static_cast<const ConfigSection*>(this)->findEntry(key));
+	}
+	
+	void ConfigSection::insertSlot(uint32_t index) {
+		const size_t mask = slots.size() - 1;
+		size_t i = hashBytes(entries[index].key) & mask;
+		while (slots[i] != kEmptySlot) i = (i + 1) & mask;
+		slots[i] = index;
+	}
+	
+	void ConfigSection::reserve(size_t count) {
+		size_t size = 16;
+		while (size < count * 2) size *= 2;
+		if (size <= slots.size()) return;
+		slots.assign(size, kEmptySlot);
+		for (uint32_t i = 0; i < entries.size(); ++i) insertSlot(i);
+	}
+	
+	ConfigEntry& ConfigSection::findOrAddEntry(std::string_view key) {
+		if (ConfigEntry* entry = findEntry(key)) return *entry;
+		
+		entries.emplace_back();
+		entries.back().key.assign(key.data(), key.size());
+		const uint32_t index = static_cast<uint32_t>(entries.size() - 1);
+		if (entries.size() * 2 > slots.size()) {
+			slots.assign(std::max<size_t>(16, slots.size() * 2), kEmptySlot);
+			for (uint32_t i = 0; i <= index; ++i) insertSlot(i);
+		} else {
+			insertSlot(index);
+		}
+		return entries.back();
+	}
+	
 	template<typename T>
 	void ConfigSection::setValue(const std::string& key, const T& value) {
-		std::cout << "ConfigSection::setValue called for key: " << key << " with type: " << typeid(T).name() << std::endl;
+		CONFIG_LOG_TRACE("ConfigSection::setValue called for key: " << key << " with type: " << valueTypeName(ValueTypeOf<T>::value));
 		try {
-			auto newValue = std::make_shared<TypedConfigValue<T>>(value);
-			
 			// Apply validation rule if it exists
-			auto rule_it = validationRules.find(key);
-			if (rule_it != validationRules.end() && rule_it->second) {
-				if (!(*rule_it->second)(*newValue)) {
-					std::cerr << "Validation failed for key: " << key << ". Using default value." << std::endl;
-					return;
-				}
+			ConfigEntry* entry = findEntry(key);
+			if (entry && !entry->check(value)) {
+				CONFIG_LOG_WARN("Validation failed for key: " << key << ". Using default value.");
+				return;
 			}
 			
-			values[key] = newValue;
-			std::cout << "Value set for key: " << key << std::endl;
+			assignValue(entry ? *entry : findOrAddEntry(key), value);
+			CONFIG_LOG_TRACE("Value set for key: " << key);
 		} catch (const std::exception& e) {
-			std::cerr << "Exception in ConfigSection::setValue: " << e.what() << std::endl;
+			CONFIG_LOG_ERROR("Exception in ConfigSection::setValue: " << e.what());
 			throw;
 		} catch (...) {
-			std::cerr << "Unknown exception in ConfigSection::setValue" << std::endl;
+			CONFIG_LOG_ERROR("Unknown exception in ConfigSection::setValue");
 			throw;
 		}
 	}
 	
 	void ConfigSection::setValue(const std::string& key, const std::string& value) {
-		std::cout << "ConfigSection::setValue called for key: " << key << " with type: string" << std::endl;
+		CONFIG_LOG_TRACE("ConfigSection::setValue called for key: " << key << " with type: string");
 		try {
-			if (values.find(key) != values.end()) {
-				values[key]->fromString(value);
-			} else {
-				auto newValue = std::make_shared<TypedConfigValue<std::string>>(value);
-				values[key] = newValue;
-			}
+			// Existing values keep their type; new keys are stored as strings
+			ConfigEntry* entry = findEntry(key);
+			const ValueType type = entry && !entry->value.empty() ? entry->value.type() : ValueType::String;
 			
-			// Apply validation rule if it exists
-			auto rule_it = validationRules.find(key);
-			if (rule_it != validationRules.end() && rule_it->second) {
-				if (!(*rule_it->second)(*values[key])) {
-					throw std::runtime_error("Validation failed for key: " + key);
-				}
+			// Parsed and checked on the side, so that a rejected value leaves the stored one as it was
+			StoredValue parsed;
+			if (!parsed.parse(type, value, std::pmr::new_delete_resource())) {
+				throw std::invalid_argument(std::string("Invalid ") + valueTypeName(type) + " for key " + key + ": " + value);
+			}
+			if (entry && !parsed.satisfies(entry->check)) {
+				throw std::runtime_error("Validation failed for key: " + key);
 			}
 			
-			std::cout << "Value set for key: " << key << std::endl;
+			assignStored(entry ? *entry : findOrAddEntry(key), parsed);
+			CONFIG_LOG_TRACE("Value set for key: " << key);
 		} catch (const std::exception& e) {
-			std::cerr << "Exception in ConfigSection::setValue: " << e.what() << std::endl;
+			CONFIG_LOG_ERROR("Exception in ConfigSection::setValue: " << e.what());
 			throw;
 		} catch (...) {
-			std::cerr << "Unknown exception in ConfigSection::setValue" << std::endl;
+			CONFIG_LOG_ERROR("Unknown exception in ConfigSection::setValue");
 			throw;
 		}
 	}
 	
 	// Specialization for vector<double>
 	void ConfigSection::setValue(const std::string& key, const std::vector<double>& value) {
-		std::cout << "ConfigSection::setValue called for key: " << key << " with type: vector<double>" << std::endl;
+		CONFIG_LOG_TRACE("ConfigSection::setValue called for key: " << key << " with type: vector<double>");
 		try {
-			auto newValue = std::make_shared<TypedConfigValue<std::vector<double>>>(value);
-			
 			// Apply validation rule if it exists
-			auto rule_it = validationRules.find(key);
-			if (rule_it != validationRules.end() && rule_it->second) {
-				if (!(*rule_it->second)(*newValue)) {
-					throw std::runtime_error("Validation failed for key: " + key);
-				}
+			ConfigEntry* entry = findEntry(key);
+			if (entry && !entry->check(value)) {
+				throw std::runtime_error("Validation failed for key: " + key);
 			}
 			
-			values[key] = newValue;
-			std::cout << "Value set for key: " << key << std::endl;
+			assignValue(entry ? *entry : findOrAddEntry(key), value);
+			CONFIG_LOG_TRACE("Value set for key: " << key);
 		} catch (const std::exception& e) {
-			std::cerr << "Exception in ConfigSection::setValue: " << e.what() << std::endl;
+			CONFIG_LOG_ERROR("Exception in ConfigSection::setValue: " << e.what());
 			throw;
 		} catch (...) {
-			std::cerr << "Unknown exception in ConfigSection::setValue" << std::endl;
+			CONFIG_LOG_ERROR("Unknown exception in ConfigSection::setValue");
 			throw;
 		}
 	}
 	
+	template<typename T>
+	void ConfigSection::assignValue(ConfigEntry& entry, const T& value) {
+		// A bound handle points at the held object, which must keep its type
+		if (entry.bound.load(std::memory_order_relaxed) && !entry.value.get<T>()) {
+			throw std::runtime_error("Type mismatch for bound key: " + std::string(entry.key));
+		}
+		entry.value.set(value, resource());
+	}
+	
+	bool ConfigSection::keepsBoundType(const ConfigEntry& entry, const StoredValue& value) {
+		return !entry.bound.load(std::memory_order_relaxed) || entry.value.empty()
+			|| (entry.value.type() == value.type() && entry.value.isExternal() == value.isExternal());
+	}
+	
+	void ConfigSection::assignStored(ConfigEntry& entry, const StoredValue& value) {
+		if (!keepsBoundType(entry, value)) {
+			throw std::runtime_error("Type mismatch for bound key: " + std::string(entry.key));
+		}
+		entry.value.assign(value, resource());
+	}
+	
 	template<typename T>
 	T ConfigSection::getValue(const std::string& key) const {
-		std::cout << "ConfigSection::getValue called for key: " << key << " with expected type: " << typeid(T).name() << std::endl;
-		auto it = values.find(key);
-		if (it != values.end()) {
-			std::cout << "Key found in ConfigSection" << std::endl;
-			auto typed_value = std::dynamic_pointer_cast<TypedConfigValue<T>>(it->second);
-			if (typed_value) {
-				std::cout << "Successfully cast to TypedConfigValue<" << typeid(T).name() << ">" << std::endl;
-				return typed_value->getValue();
-			} else {
-				std::cout << "Failed to cast to TypedConfigValue<" << typeid(T).name() << ">" << std::endl;
+		CONFIG_LOG_TRACE("ConfigSection::getValue called for key: " << key << " with expected type: " << valueTypeName(ValueTypeOf<T>::value));
+		if (const ConfigEntry* entry = findEntry(key)) {
+			CONFIG_LOG_TRACE("Key found in ConfigSection");
+			if (const StoredType<T>* value = entry->value.get<T>()) {
+				return *value;
 			}
+			CONFIG_LOG_TRACE("Stored value is not of type " << valueTypeName(ValueTypeOf<T>::value));
 		} else {
-			std::cout << "Key not found in ConfigSection" << std::endl;
+			CONFIG_LOG_TRACE("Key not found in ConfigSection");
 		}
 		throw std::runtime_error("Key not found or type mismatch: " + key);
 	}
@@ -255,309 +347,1404 @@ namespace ConfigLib {
 	// Specialization for std::string to avoid unnecessary conversion
 	template<>
 	std::string ConfigSection::getValue<std::string>(const std::string& key) const {
-		std::cout << "ConfigSection::getValue<std::string> called for key: " << key << std::endl;
-		auto it = values.find(key);
-		if (it != values.end()) {
-			auto string_value = std::dynamic_pointer_cast<TypedConfigValue<std::string>>(it->second);
-			if (string_value) {
-				return string_value->getValue();
+		CONFIG_LOG_TRACE("ConfigSection::getValue<std::string> called for key: " << key);
+		if (const ConfigEntry* entry = findEntry(key)) {
+			if (const std::pmr::string* value = entry->value.get<std::string>()) {
+				return std::string(value->data(), value->size());
 			}
 		}
 		throw std::runtime_error("Key not found: " + key);
 	}
 	
-	// Specialization for std::vector<double>
+	// Specialization for std::vector<double>: lists stored as text are parsed on read
 	template<>
 	std::vector<double> ConfigSection::getValue<std::vector<double>>(const std::string& key) const {
-		std::cout << "ConfigSection::getValue<std::vector<double>> called for key: " << key << std::endl;
-		auto it = values.find(key);
-		if (it != values.end()) {
-			auto string_value = std::dynamic_pointer_cast<TypedConfigValue<std::string>>(it->second);
-			if (string_value) {
+		CONFIG_LOG_TRACE("ConfigSection::getValue<std::vector<double>> called for key: " << key);
+		if (const ConfigEntry* entry = findEntry(key)) {
+			if (const DoubleList* value = entry->value.get<std::vector<double>>()) {
+				return std::vector<double>(value->begin(), value->end());
+			}
+			if (entry->value.isExternal()) {
+				const DoubleSpan values = entry->value.getArray();
+				return std::vector<double>(values.begin(), values.end());
+			}
+			if (const std::pmr::string* text = entry->value.get<std::string>()) {
 				std::vector<double> result;
-				std::istringstream iss(string_value->getValue());
-				std::string token;
-				while (std::getline(iss, token, ',')) {
-					result.push_back(std::stod(token));
+				if (NumberCodec::parseDoubleList(*text, result)) {
+					return result;
 				}
-				return result;
 			}
 		}
 		throw std::runtime_error("Key not found or invalid format: " + key);
 	}
 	
+	template<typename T>
+	ConfigHandle<T> ConfigSection::bind(const std::string& key) const {
+		const ConfigEntry* entry = findEntry(key);
+		if (!entry || entry->value.empty()) {
+			throw std::runtime_error("Key not found: " + key);
+		}
+		const StoredType<T>* value = entry->value.get<T>();
+		if (!value) {
+			throw std::runtime_error("Type mismatch binding key: " + key);
+		}
+		entry->bound.store(true, std::memory_order_relaxed);
+		return ConfigHandle<T>(value);
+	}
+	
+	void ConfigSection::setArrayReference(std::string_view key, std::string_view path) {
+		StoredValue reference;
+		reference.setExternal(path);
+		assignStored(findOrAddEntry(key), reference);
+	}
+	
+	DoubleSpan ConfigSection::getArray(const std::string& key) const {
+		const ConfigEntry* entry = findEntry(key);
+		if (!entry || entry->value.empty() || entry->value.type() != ValueType::DoubleVector) {
+			throw std::runtime_error("Key not found or not a list: " + key);
+		}
+		return entry->value.getArray();
+	}
+	
 	bool ConfigSection::hasKey(const std::string& key) const {
-		return values.find(key) != values.end();
+		const ConfigEntry* entry = findEntry(key);
+		return entry && !entry->value.empty();
 	}
 	
 	void ConfigSection::setValidationRule(const std::string& key, const ValidationRules::Rule* rule) {
-        validationRules[key] = rule;
+        ConfigEntry& entry = findOrAddEntry(key);
+        // The declared type is not known here; bind to the stored one
+        entry.check = rule ? rule->bind(entry.value.empty() ? ValueType::String : entry.value.type()) : ValidationRules::Check();
     }
 	
-	const std::unordered_map<std::string, std::shared_ptr<ConfigValue>>& ConfigSection::getValues() const {
-		return values;
+	void ConfigSection::copyEntries(const ConfigSection& other) {
+		// Entries keep their positions, so the slot table carries over unchanged
+		for (const auto& entry : other.entries) {
+			entries.emplace_back();
+			ConfigEntry& copy = entries.back();
+			copy.key.assign(entry.key.data(), entry.key.size());
+			copy.value.assign(entry.value, resource());
+			copy.check = entry.check;
+		}
+		slots.assign(other.slots.begin(), other.slots.end());
+	}
+	
+	ConfigGeneration::ConfigGeneration(bool useArena, size_t sizeHint)
+		: arena(useArena ? std::make_unique<ConfigArena>(sizeHint) : nullptr),
+		  sections(arena ? static_cast<std::pmr::memory_resource*>(arena.get()) : std::pmr::new_delete_resource()),
+		  index(sections.get_allocator().resource()),
+		  keyEntries(sections.get_allocator().resource()) {}
+	
+	ConfigSection& ConfigGeneration::getOrAddSection(std::string_view name) {
+		if (ConfigSection* section = findSection(name)) return *section;
+		sections.emplace_back(name);
+		ConfigSection& added = sections.back();
+		index.emplace(std::string_view(added.getName()), &added);
+		return added;
 	}
 	
-	ConfigReader::ConfigReader() : filepath("") {
-		std::cout << "ConfigReader constructor started" << std::endl;
+	const ConfigSection* ConfigGeneration::findSection(std::string_view name) const {
+		auto it = index.find(name);
+		return it != index.end() ? it->second : nullptr;
+	}
+	
+	ConfigSection* ConfigGeneration::findSection(std::string_view name) {
+		auto it = index.find(name);
+		return it != index.end() ? it->second : nullptr;
+	}
+	
+	namespace {
+		// Stored values in the form getValue returns them
+		int copyOut(int value) { return value; }
+		double copyOut(double value) { return value; }
+		std::string copyOut(const std::pmr::string& value) { return std::string(value.data(), value.size()); }
+		std::vector<double> copyOut(const DoubleList& value) { return std::vector<double>(value.begin(), value.end()); }
+	}
+	
+	template<typename T>
+	T ConfigGeneration::getValue(const std::string& section, const std::string& key) const {
+		// Keys of the schema holding a T; anything else takes the general path, with its conversions and errors
+		if (const ConfigEntry* entry = findBoundEntry(section, key)) {
+			if (const StoredType<T>* value = entry->value.get<T>()) return copyOut(*value);
+		}
+		if (const ConfigSection* sect = findSection(section)) {
+			return sect->getValue<T>(key);
+		}
+		throw std::runtime_error("Section not found: " + section);
+	}
+	
+	bool ConfigGeneration::hasValue(const std::string& section, const std::string& key) const {
+		if (const ConfigEntry* entry = findBoundEntry(section, key)) return !entry->value.empty();
+		const ConfigSection* sect = findSection(section);
+		return sect && sect->hasKey(key);
+	}
+	
+	const StoredValue* ConfigGeneration::findValue(std::string_view section, std::string_view key) const {
+		const ConfigEntry* entry = findBoundEntry(section, key);
+		if (!entry) {
+			const ConfigSection* sect = findSection(section);
+			entry = sect ? sect->findEntry(key) : nullptr;
+		}
+		return entry && !entry->value.empty() ? &entry->value : nullptr;
+	}
+	
+	template<typename T>
+	T ConfigGeneration::getValue(ConfigGen::KeyId<T> id) const {
+		if (id.index >= keyEntries.size()) {
+			throw std::logic_error("Key id " + std::to_string(id.index) + " is outside the bound schema");
+		}
+		const ConfigEntry* entry = keyEntries[id.index];
+		if (const StoredType<T>* value = entry->value.get<T>()) {
+			return copyOut(*value);
+		}
+		if constexpr (std::is_same_v<T, std::vector<double>>) {
+			if (entry->value.isExternal()) {
+				const DoubleSpan values = entry->value.getArray();
+				return std::vector<double>(values.begin(), values.end());
+			}
+		}
+		throw std::runtime_error("Key not found or type mismatch: " + std::string(entry->key));
+	}
+	
+	DoubleSpan ConfigGeneration::getArray(const std::string& section, const std::string& key) const {
+		if (const ConfigEntry* entry = findBoundEntry(section, key)) {
+			if (!entry->value.empty() && entry->value.type() == ValueType::DoubleVector) return entry->value.getArray();
+		}
+		if (const ConfigSection* sect = findSection(section)) {
+			return sect->getArray(key);
+		}
+		throw std::runtime_error("Section not found: " + section);
+	}
+	
+	void ConfigGeneration::bindSchema(std::shared_ptr<const ConfigGen::SchemaIndex> schema) {
+		keyEntries.clear();
+		keyEntries.reserve(schema->size());
+		for (const auto& key : schema->getEntries()) {
+			keyEntries.push_back(&getOrAddSection(key.section).findOrAddEntry(key.key));
+		}
+		boundSchema = std::move(schema);
+	}
+	
+	std::unique_ptr<ConfigGeneration> ConfigGeneration::clone(bool useArena) const {
+		const size_t sizeHint = getArenaBytes() + getArenaBytes() / 8;
+		auto copy = std::make_unique<ConfigGeneration>(useArena, sizeHint);
+		for (const auto& section : sections) {
+			copy->getOrAddSection(section.getName()).copyEntries(section);
+		}
+		return copy;
+	}
+	
+	ConfigSnapshot::ConfigSnapshot(ConfigSnapshot&& other) noexcept
+		: generation(other.generation), slot(other.slot) {
+		other.generation = nullptr;
+		other.slot = nullptr;
+	}
+	
+	ConfigSnapshot& ConfigSnapshot::operator=(ConfigSnapshot&& other) noexcept {
+		if (this != &other) {
+			if (slot) HazardPointers::release(slot);
+			generation = other.generation;
+			slot = other.slot;
+			other.generation = nullptr;
+			other.slot = nullptr;
+		}
+		return *this;
+	}
+	
+	ConfigSnapshot::~ConfigSnapshot() {
+		if (slot) HazardPointers::release(slot);
+	}
+	
+	template<typename T>
+	ConfigHandle<T> ConfigSnapshot::bind(const std::string& section, const std::string& key) const {
+		const ConfigSection* sect = generation->findSection(section);
+		if (!sect) {
+			throw std::runtime_error("Section not found: " + section);
+		}
+		return sect->bind<T>(key);
+	}
+	
+	// Serializes writers and decides where a write lands: on the current generation itself or,
+	// in snapshot mode, on a private copy that is published only once the write has completed.
+	// A scope that is not committed leaves the published generation untouched.
+	class ConfigReader::WriteScope {
+	public:
+		enum class Source { Current, Empty };
+	
+		explicit WriteScope(ConfigReader& reader, Source source = Source::Current)
+			: reader(reader), lock(reader.writeMutex) {
+			ConfigGeneration* live = reader.current.load(std::memory_order_acquire);
+			if (source == Source::Empty) {
+				// Size the new arena after the current generation, plus some room for growth
+				const size_t sizeHint = live->getArenaBytes() + live->getArenaBytes() / 8;
+				fresh = std::make_unique<ConfigGeneration>(reader.arenaEnabled, sizeHint);
+			} else if (reader.isSnapshotMode()) {
+				fresh = live->clone(reader.arenaEnabled);
+			}
+			target = fresh ? fresh.get() : live;
+		}
+	
+		ConfigGeneration& generation() { return *target; }
+	
+		void commit() {
+			// Fresh and cloned generations start unbound, and so does the very first one
+			if ((reader.keyIdsEnabled || reader.schemaLookupEnabled) && !target->isSchemaBound()) target->bindSchema(reader.schema);
+			if (fresh) reader.publish(std::move(fresh));
+		}
+	
+	private:
+		ConfigReader& reader;
+		std::lock_guard<std::mutex> lock;
+		std::unique_ptr<ConfigGeneration> fresh;
+		ConfigGeneration* target;
+	};
+	
+	ConfigReader::ConfigReader() : filepath(""), current(new ConfigGeneration(true)) {
+		CONFIG_LOG_TRACE("ConfigReader constructor started");
 		//initialize();
-		std::cout << "ConfigReader constructor finished" << std::endl;
+		CONFIG_LOG_TRACE("ConfigReader constructor finished");
+	}
+	
+	ConfigReader::~ConfigReader() {
+		delete current.load();
+	}
+	
+	void ConfigReader::setSnapshotMode(bool enabled) {
+		std::lock_guard<std::mutex> lock(writeMutex);
+		snapshotMode.store(enabled, std::memory_order_relaxed);
+	}
+	
+	bool ConfigReader::hasBoundValues() const {
+		std::lock_guard<std::mutex> lock(writeMutex);
+		for (const auto& section : current.load(std::memory_order_relaxed)->getSections()) {
+			for (const auto& entry : section.getEntries()) {
+				if (entry.bound.load(std::memory_order_relaxed)) return true;
+			}
+		}
+		return false;
+	}
+	
+	std::vector<std::string> ConfigReader::getArrayFiles() const {
+		std::lock_guard<std::mutex> lock(writeMutex);
+		std::vector<std::string> paths;
+		for (const auto& section : current.load(std::memory_order_relaxed)->getSections()) {
+			for (const auto& entry : section.getEntries()) {
+				const ExternalArray* array = entry.value.getExternal();
+				if (array && std::find(paths.begin(), paths.end(), array->getPath()) == paths.end()) paths.push_back(array->getPath());
+			}
+		}
+		return paths;
+	}
+	
+	ConfigSnapshot ConfigReader::snapshot() const {
+		HazardPointers::Slot* slot = HazardPointers::acquire();
+		const ConfigGeneration* generation = HazardPointers::protect(current, slot);
+		return ConfigSnapshot(generation, slot);
+	}
+	
+	void ConfigReader::publish(std::unique_ptr<ConfigGeneration> next) {
+		retired.emplace_back(current.exchange(next.release(), std::memory_order_seq_cst));
+	
+		std::vector<const void*> pinned;
+		HazardPointers::collectProtected(pinned);
+		retired.erase(std::remove_if(retired.begin(), retired.end(), [&pinned](const std::unique_ptr<ConfigGeneration>& generation) {
+			return !std::binary_search(pinned.begin(), pinned.end(), static_cast<const void*>(generation.get()));
+		}), retired.end());
 	}
 	
 	void ConfigReader::initialize() {
-		std::cout << "ConfigReader::initialize started" << std::endl;
+		CONFIG_LOG_DEBUG("ConfigReader::initialize started");
+		LoadProfile load(statsCollector, "initialize", LoadPhase::Schema);
+		LoadProfile* const profile = LoadProfile::current();
 		try {
-			std::cout << "Calling getConfigFilePath()" << std::endl;
+			CONFIG_LOG_DEBUG("Calling getConfigFilePath()");
 			filepath = getConfigFilePath();
-			std::cout << "Config file path: " << filepath << std::endl;
+			CONFIG_LOG_DEBUG("Config file path: " << filepath);
+			
+			{
+				SpanScope span(profile, "schema index", LoadPhase::Schema);
+				buildSchemaIndex();
+			}
 	
 			// Check if the file exists, if not, generate it
-			std::ifstream file(filepath);
-			if (!file.is_open()) {
-				std::cout << "Config file not found. Generating new file." << std::endl;
-				generateConfigFile(*this);
+			{
+				PhaseScope phase(profile, LoadPhase::FileIO);
+				std::ifstream file(filepath);
+				if (!file.is_open()) {
+					CONFIG_LOG_INFO("Config file not found. Generating new file.");
+					generateConfigFile(*this);
+				}
 			}
-			file.close();
 	
-			std::cout << "Calling loadConfig()" << std::endl;
-			loadConfig();
-			std::cout << "Config loaded" << std::endl;
+			// A fresh generation, since the one the constructor made predates setArenaEnabled()
+			WriteScope scope(*this, WriteScope::Source::Empty);
+			CONFIG_LOG_DEBUG("Calling loadConfig()");
+			if (cacheEnabled) {
+				loadConfigCached(scope.generation());
+			} else {
+				loadConfig(scope.generation());
+			}
+			CONFIG_LOG_DEBUG("Config loaded");
 			
-			std::cout << "Setting validation rules" << std::endl;
-			setValidationRules();
-			std::cout << "Validation rules set" << std::endl;
+			SpanScope span(profile, "finish", LoadPhase::Finish);
+			CONFIG_LOG_DEBUG("Setting validation rules");
+			setValidationRules(scope.generation());
+			carryOverRules(scope.generation());
+			CONFIG_LOG_DEBUG("Validation rules set");
+			scope.commit();
 		} catch (const std::exception& e) {
-			std::cerr << "Exception in ConfigReader::initialize: " << e.what() << std::endl;
+			CONFIG_LOG_ERROR("Exception in ConfigReader::initialize: " << e.what());
 			throw;
 		} catch (...) {
-			std::cerr << "Unknown exception in ConfigReader::initialize" << std::endl;
+			CONFIG_LOG_ERROR("Unknown exception in ConfigReader::initialize");
 			throw;
 		}
-		std::cout << "ConfigReader::initialize finished" << std::endl;
+		CONFIG_LOG_DEBUG("ConfigReader::initialize finished");
 	}
 	
 	
 	template<typename T>
 	T ConfigReader::getValue(const std::string& section, const std::string& key) const {
-		std::cout << "Attempting to get value for section: " << section << ", key: " << key << std::endl;
-		auto sect_it = sections.find(section);
-		if (sect_it != sections.end()) {
-			std::cout << "Section found" << std::endl;
-			return sect_it->second.getValue<T>(key);
+		CONFIG_LOG_TRACE("Attempting to get value for section: " << section << ", key: " << key);
+		statsCollector.countRead(section, key);
+		if (isSnapshotMode()) {
+			return snapshot().getValue<T>(section, key);
 		}
-		std::cout << "Section not found" << std::endl;
-		throw std::runtime_error("Section not found: " + section);
+		return current.load(std::memory_order_acquire)->getValue<T>(section, key);
+	}
+	
+	template<typename T>
+	T ConfigReader::getValue(ConfigGen::KeyId<T> id) const {
+		// Names come from the generation's own schema, which a concurrent initialize() leaves alone
+		const auto read = [this, id](const ConfigGeneration& generation) {
+			const ConfigGen::SchemaIndex* bound = generation.getBoundSchema();
+			if (statsCollector.isCountingReads() && bound && id.index < bound->size()) {
+				const ConfigGen::SchemaEntry& entry = bound->getEntries()[id.index];
+				statsCollector.countRead(entry.section, entry.key);
+			}
+			return generation.getValue(id);
+		};
+		if (isSnapshotMode()) {
+			const ConfigSnapshot pinned = snapshot();
+			return read(pinned.getGeneration());
+		}
+		return read(*current.load(std::memory_order_acquire));
+	}
+	
+	// Only used for binding, which would leave handles pointing into generations that a later
+	// write retires when in snapshot mode
+	const ConfigSection& ConfigReader::findSection(const std::string& section) const {
+		if (isSnapshotMode()) {
+			throw std::logic_error("Bind through a ConfigSnapshot when snapshot mode is enabled");
+		}
+		const ConfigSection* sect = current.load(std::memory_order_acquire)->findSection(section);
+		if (!sect) {
+			throw std::runtime_error("Section not found: " + section);
+		}
+		return *sect;
+	}
+	
+	template<typename T>
+	ConfigHandle<T> ConfigReader::bind(const std::string& section, const std::string& key) const {
+		return findSection(section).bind<T>(key);
 	}
 	
 	template<typename T>
 	void ConfigReader::setValue(const std::string& section, const std::string& key, const T& value) {
-		sections[section].setValue(key, value);
+		WriteScope scope(*this);
+		scope.generation().getOrAddSection(section).setValue(key, value);
+		recordWrite(section, key);
+		scope.commit();
 	}
 	
 	void ConfigReader::setValue(const std::string& section, const std::string& key, const std::string& value) {
-		sections[section].setValue(key, value);
+		WriteScope scope(*this);
+		scope.generation().getOrAddSection(section).setValue(key, value);
+		recordWrite(section, key);
+		scope.commit();
 	}
 	
 	void ConfigReader::setValue(const std::string& section, const std::string& key, const std::vector<double>& value) {
-		sections[section].setValue(key, value);
+		WriteScope scope(*this);
+		scope.generation().getOrAddSection(section).setValue(key, value);
+		recordWrite(section, key);
+		scope.commit();
 	}
 	
 	template<>
 	void ConfigReader::setValue<std::string>(const std::string& section, const std::string& key, const std::string& value) {
-		auto& sectionObj = sections[section];
-		auto it = sectionObj.getValues().find(key);
-		if (it != sectionObj.getValues().end()) {
-			it->second->fromString(value);
-		} else {
-			sectionObj.setValue(key, value);
-		}
+		WriteScope scope(*this);
+		scope.generation().getOrAddSection(section).setValue(key, value);
+		recordWrite(section, key);
+		scope.commit();
 	}
 	
 	bool ConfigReader::hasValue(const std::string& section, const std::string& key) const {
-		auto sect_it = sections.find(section);
-		if (sect_it != sections.end()) {
-			return sect_it->second.hasKey(key);
+		if (isSnapshotMode()) {
+			return snapshot().hasValue(section, key);
 		}
-		return false;
+		return current.load(std::memory_order_acquire)->hasValue(section, key);
+	}
+	
+	DoubleSpan ConfigReader::getArray(const std::string& section, const std::string& key) const {
+		// A view into the current generation would dangle once a write retires it
+		if (isSnapshotMode()) {
+			throw std::logic_error("Read arrays through a ConfigSnapshot when snapshot mode is enabled");
+		}
+		statsCollector.countRead(section, key);
+		return current.load(std::memory_order_acquire)->getArray(section, key);
 	}
 	
 	
+	ConfigTransaction ConfigReader::begin() {
+		return ConfigTransaction(*this);
+	}
+	
+	void ConfigReader::commitTransaction(ConfigTransaction& transaction) {
+		if (transaction.empty() && transaction.requirements.empty()) return;
+		if (schema->empty()) buildSchemaIndex();
+		WriteScope scope(*this);
+		ConfigGeneration& target = scope.generation();
+		std::vector<ConfigViolation> violations;
+		
+		// Every staged value on its own: type, then rule. Strings become the key's type here.
+		// Batches usually write runs of keys of one section, which are looked up once.
+		const std::string* lastSection = nullptr;
+		const ConfigGen::SchemaIndex::KeyTable* sectionKeys = nullptr;
+		const ConfigSection* section = nullptr;
+		for (auto& staged : transaction.staged) {
+			if (!lastSection || *lastSection != staged.section) {
+				lastSection = &staged.section;
+				sectionKeys = schema->findSection(staged.section);
+				section = target.findSection(staged.section);
+			}
+			const ConfigGen::SchemaEntry* declared = ConfigGen::SchemaIndex::find(sectionKeys, staged.key);
+			const ConfigEntry* current = section ? section->findEntry(staged.key) : nullptr;
+			const bool stored = current && !current->value.empty();
+			const ValueType type = declared ? declared->type : stored ? current->value.type() : staged.value.type();
+			const auto reject = [&](std::string reason) {
+				violations.push_back({staged.section, staged.key, staged.value.toString(), std::move(reason)});
+			};
+			
+			if (staged.text && type != ValueType::String) {
+				StoredValue parsed;
+				if (!parsed.parse(type, *staged.value.get<std::string>(), std::pmr::new_delete_resource())) {
+					reject(std::string("Does not parse as ") + valueTypeName(type));
+					continue;
+				}
+				staged.value = std::move(parsed);
+			}
+			staged.text = false;
+			if (staged.value.type() != type) {
+				reject(std::string("Must be of type ") + valueTypeName(type));
+				continue;
+			}
+			// A bound handle points at the stored object, which must keep its type and stay inline
+			// or external as it is; assignStored() below would otherwise throw halfway through
+			if (stored && !ConfigSection::keepsBoundType(*current, staged.value)) {
+				reject("Type mismatch for bound key");
+				continue;
+			}
+			const ValidationRules::Check& check = current ? current->check : declared ? declared->check : ValidationRules::Check();
+			if (!staged.value.satisfies(check)) reject(check.rule->toString());
+		}
+		
+		// Cross-key checks see the batch as a whole, and only a batch whose values are all valid
+		if (violations.empty()) {
+			const ConfigTransaction::View view(transaction, target);
+			for (const auto& requirement : transaction.requirements) {
+				try {
+					if (requirement.check(view)) continue;
+					violations.push_back({std::string(), std::string(), std::string(), requirement.description});
+				} catch (const std::exception& e) {
+					violations.push_back({std::string(), std::string(), std::string(), requirement.description + ": " + e.what()});
+				}
+			}
+		}
+		
+		if (!violations.empty()) {
+			CONFIG_LOG_WARN("Transaction of " << transaction.size() << " values rejected: " << violations.size() << " failed checks");
+			throw ConfigTransactionError(std::move(violations));
+		}
+		
+		ConfigSection* written = nullptr;
+		for (const auto& staged : transaction.staged) {
+			if (!written || std::string_view(written->getName()) != staged.section) written = &target.getOrAddSection(staged.section);
+			written->assignStored(written->findOrAddEntry(staged.key), staged.value);
+			recordWrite(staged.section, staged.key);
+		}
+		scope.commit();
+		CONFIG_LOG_DEBUG("Transaction of " << transaction.size() << " values committed");
+	}
+	
 	void ConfigReader::setValidationRule(const std::string& section, const std::string& key, const ValidationRules::Rule* rule) {
-        sections[section].setValidationRule(key, rule);
+        WriteScope scope(*this);
+        scope.generation().getOrAddSection(section).setValidationRule(key, rule);
+        scope.commit();
     }
 	
 	void ConfigReader::setValidationRules() {
-        auto configSections = getConfigSections();
-        for (const auto& section : configSections) {
-            for (const auto& item : section.items) {
-                if (item.validationRule) {
-                    setValidationRule(section.name, item.name, item.validationRule);
-                }
-            }
-        }
-    }
+		WriteScope scope(*this);
+		setValidationRules(scope.generation());
+		scope.commit();
+	}
 	
-void ConfigReader::loadConfig() {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "Unable to open file: " << filepath << std::endl;
-        return;
-    }
-
-    std::string current_section;
-    std::string line;
-    while (std::getline(file, line)) {
-		line = trim(line);
-		if (line.empty() || line[0] == '#') continue;
-
-        if (line[0] == '[' && line.back() == ']') {
-			current_section = line.substr(1, line.size() - 2);
-		} else {
-            auto pos = line.find('=');
-			if (pos != std::string::npos) {
-				std::string key = trim(line.substr(0, pos));
-				std::string value = line.substr(pos + 1);
-				
-				// Remove comments from the value
-				size_t commentPos = value.find('#');
-				if (commentPos != std::string::npos) {
-					value = value.substr(0, commentPos);
+	void ConfigReader::setValidationRules(ConfigGeneration& target) {
+		if (schema->empty()) buildSchemaIndex();
+		for (const auto& entry : schema->getEntries()) {
+			if (entry.validationRule) {
+				target.getOrAddSection(entry.section).findOrAddEntry(entry.key).check = entry.check;
+			}
+		}
+	}
+	
+	void ConfigReader::reload() {
+		CONFIG_LOG_DEBUG("ConfigReader::reload started");
+		LoadProfile load(statsCollector, "reload", LoadPhase::FileIO);
+		WriteScope scope(*this, WriteScope::Source::Empty);
+		ConfigGeneration& target = scope.generation();
+		loadConfig(target);
+		SpanScope span(LoadProfile::current(), "finish", LoadPhase::Finish);
+		setValidationRules(target);
+		carryOverRules(target);
+		// The previous generation is released here, or once the last snapshot of it is gone
+		scope.commit();
+		CONFIG_LOG_DEBUG("ConfigReader::reload finished");
+	}
+	
+	void ConfigReader::carryOverRules(ConfigGeneration& target) {
+		for (const auto& section : current.load(std::memory_order_acquire)->getSections()) {
+			for (const auto& entry : section.getEntries()) {
+				if (!entry.check.rule) continue;
+				target.getOrAddSection(section.getName()).findOrAddEntry(entry.key).check = entry.check;
+			}
+		}
+	}
+	
+	namespace {
+		// Whether a list of section refers to an array file rewritten or replaced since it was
+		// loaded, which makes the section's unchanged text a new value all the same
+		bool referencesChangedArray(const ConfigSection* section) {
+			if (!section) return false;
+			for (const auto& entry : section->getEntries()) {
+				const ExternalArray* array = entry.value.getExternal();
+				if (array && array->hasChanged()) return true;
+			}
+			return false;
+		}
+	
+		// The text of one section, from its header up to the next header. A section whose header
+		// appears more than once has one block per occurrence.
+		struct SectionText {
+			std::string_view name;
+			std::vector<std::string_view> blocks;
+			uint64_t fingerprint = 0;
+		};
+	
+		// Finds the lines whose first non-blank character is '[' through a StructuralIndex of the
+		// buffer, built a window at a time, so that the lines in between are never visited.
+		class HeaderScanner {
+		public:
+			explicit HeaderScanner(std::string_view buffer) : buffer(buffer) {}
+			
+			// Start of the first such line at or after from, which must be a line start, or npos
+			size_t next(size_t from) {
+				if (from < windowBegin || from >= windowEnd) refill(from);
+				while (from < buffer.size()) {
+					const size_t relative = from - windowBegin;
+					for (size_t block = relative / StructuralIndex::kBlockSize; block < blocks.size(); ++block) {
+						uint64_t mask = blocks[block].brackets;
+						if (block == relative / StructuralIndex::kBlockSize) mask &= ~uint64_t(0) << (relative % StructuralIndex::kBlockSize);
+						while (mask) {
+							const size_t bracket = windowBegin + block * StructuralIndex::kBlockSize + StructuralIndex::lowestBit(mask);
+							mask &= mask - 1;
+							size_t lineStart = bracket;
+							while (lineStart > 0 && (buffer[lineStart - 1] == ' ' || buffer[lineStart - 1] == '\t')) --lineStart;
+							if (lineStart == 0 || buffer[lineStart - 1] == '\n') return lineStart;
+						}
+					}
+					from = windowEnd;
+					if (from < buffer.size()) refill(from);
 				}
-				value = trim(value);
-				
-                if (!current_section.empty()) {
-                    auto configSections = getConfigSections();
-                    for (const auto& section : configSections) {
-                        if (section.name == current_section) {
-                            for (const auto& item : section.items) {
-                                if (item.name == key) {
-                                    try {
-                                        if (std::string(item.type) == "double") {
-                                            double doubleValue = std::stod(value);
-                                            if (!item.validationRule || (*item.validationRule)(TypedConfigValue<double>(doubleValue))) {
-                                                setValue(current_section, key, doubleValue);
-                                            } else {
-                                                std::cerr << "Validation failed for " << current_section << "." << key 
-                                                          << ". Using default value." << std::endl;
-                                                useDefaultValue(current_section, key, item);
-                                            }
-                                        } else if (std::string(item.type) == "int") {
-                                            int intValue = std::stoi(value);
-                                            if (!item.validationRule || (*item.validationRule)(TypedConfigValue<int>(intValue))) {
-                                                setValue(current_section, key, intValue);
-                                            } else {
-                                                std::cerr << "Validation failed for " << current_section << "." << key 
-                                                          << ". Using default value." << std::endl;
-                                                useDefaultValue(current_section, key, item);
-                                            }
-                                        } else if (std::string(item.type) == "vector<double>") {
-											std::vector<double> vec;
-											// remove any comments from the value string
-											std::string cleanValue = value.substr(0, value.find('#'));
-											cleanValue = trim(cleanValue);  // Trim any trailing spaces after removing comment
-										
-											std::istringstream iss(cleanValue);
-											std::string token;
-											bool parseError = false;
-											while (std::getline(iss, token, ',')) {
-												token = trim(token);
-												if (token.empty()) continue; // Skip empty elements
-												try {
-													size_t pos;
-													double num = std::stod(token, &pos);
-													if (pos != token.length()) {
-														throw std::invalid_argument("Invalid characters in number");
-													}
-													vec.push_back(num);
-												} catch (const std::exception& e) {
-													std::cerr << "Error parsing vector element '" << token << "': " << e.what() << std::endl;
-													parseError = true;
-													break;
-												}
-											}
-											if (!parseError && (!item.validationRule || (*item.validationRule)(TypedConfigValue<std::vector<double>>(vec)))) {
-												setValue(current_section, key, vec);
-											} else {
-												std::cerr << "Validation failed or parse error for " << current_section << "." << key 
-														<< ". Using default value." << std::endl;
-												useDefaultValue(current_section, key, item);
-											}
-										} else {
-                                            if (!item.validationRule || (*item.validationRule)(TypedConfigValue<std::string>(value))) {
-                                                setValue(current_section, key, value);
-                                            } else {
-                                                std::cerr << "Validation failed for " << current_section << "." << key 
-                                                          << ". Using default value." << std::endl;
-                                                useDefaultValue(current_section, key, item);
-                                            }
-                                        }
-                                    } catch (const std::exception& e) {
-                                        std::cerr << "Error processing " << current_section << "." << key 
-                                                  << ": " << e.what() << ". Using default value." << std::endl;
-                                        useDefaultValue(current_section, key, item);
-                                    }
-                                    break;
-                                }
-                            }
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
+				return std::string_view::npos;
+			}
+			
+		private:
+			// Sized, like the tokenizer's, so that a window and its bitmaps stay in cache
+			static constexpr size_t kWindowSize = 64 * 1024;
+			
+			void refill(size_t from) {
+				windowBegin = from;
+				windowEnd = std::min(buffer.size(), from + kWindowSize);
+				StructuralIndex::build(buffer.substr(windowBegin, windowEnd - windowBegin), blocks);
+			}
+			
+			std::string_view buffer;
+			std::vector<StructuralIndex::Block> blocks;
+			size_t windowBegin = 0;
+			size_t windowEnd = 0;
+		};
+		
+		// Length of the line starting at offset, without its '\n'
+		size_t lineLength(std::string_view buffer, size_t offset) {
+			const char* begin = buffer.data() + offset;
+			const char* newline = static_cast<const char*>(std::memchr(begin, '\n', buffer.size() - offset));
+			return newline ? static_cast<size_t>(newline - begin) : buffer.size() - offset;
+		}
 	
-	void ConfigReader::setValueWithValidation(const std::string& section, const std::string& key, const std::string& value) {
-		auto configSections = getConfigSections();
-		for (const auto& configSection : configSections) {
-			if (configSection.name == section) {
-				for (const auto& item : configSection.items) {
-					if (item.name == key) {
-						if (std::string(item.type) == "double") {
-							double doubleValue = std::stod(value);
-							setValue(section, key, doubleValue);
-						} else if (std::string(item.type) == "int") {
-							int intValue = std::stoi(value);
-							setValue(section, key, intValue);
-						} else if (std::string(item.type) == "vector<double>") {
-							std::vector<double> vec;
-							std::istringstream iss(value);
-							std::string token;
-							while (std::getline(iss, token, ',')) {
-								vec.push_back(std::stod(token));
-							}
-							setValue(section, key, vec);
+		// Only the lines HeaderScanner picks out are classified, so splitting a file costs little
+		// more than indexing its brackets. Text before the first header is dropped, as the loader
+		// ignores it.
+		std::vector<SectionText> splitSections(std::string_view buffer) {
+			std::vector<SectionText> sections;
+			std::unordered_map<std::string_view, size_t> byName;
+			size_t open = 0;
+			size_t blockBegin = std::string_view::npos;
+			HeaderScanner scanner(buffer);
+			IniToken token;
+	
+			for (size_t offset = scanner.next(0); offset != std::string_view::npos;) {
+				const size_t length = lineLength(buffer, offset);
+				IniTokenizer::classify(buffer.substr(offset, length), token);
+				if (token.kind == IniToken::Kind::Section) {
+					if (blockBegin != std::string_view::npos) {
+						sections[open].blocks.push_back(buffer.substr(blockBegin, offset - blockBegin));
+					}
+					const auto inserted = byName.emplace(token.name, sections.size());
+					if (inserted.second) sections.push_back({token.name, {}, 0});
+					open = inserted.first->second;
+					blockBegin = offset;
+				}
+				const size_t next = offset + length + 1;
+				offset = next < buffer.size() ? scanner.next(next) : std::string_view::npos;
+			}
+			if (blockBegin != std::string_view::npos) {
+				sections[open].blocks.push_back(buffer.substr(blockBegin));
+			}
+	
+			for (auto& section : sections) {
+				uint64_t fingerprint = section.blocks.size();
+				for (const auto& block : section.blocks) {
+					fingerprint = (fingerprint ^ hashBytes(block)) * 0x9e3779b97f4a7c15ull;
+				}
+				section.fingerprint = fingerprint;
+			}
+			return sections;
+		}
+	
+		// Start of the first section header line at or after from, or the end of the buffer
+		size_t nextSectionStart(HeaderScanner& scanner, std::string_view buffer, size_t from) {
+			if (from > 0 && from < buffer.size() && buffer[from - 1] != '\n') {
+				const size_t newline = buffer.find('\n', from);
+				from = newline == std::string_view::npos ? buffer.size() : newline + 1;
+			}
+			IniToken token;
+			while (from < buffer.size()) {
+				from = scanner.next(from);
+				if (from == std::string_view::npos) break;
+				const size_t length = lineLength(buffer, from);
+				IniTokenizer::classify(buffer.substr(from, length), token);
+				if (token.kind == IniToken::Kind::Section) return from;
+				from += length + 1;
+			}
+			return buffer.size();
+		}
+	
+		// Up to count pieces of about equal size, each after the first starting at a section
+		// header, so that no section is split. Only the text around each cut is looked at.
+		std::vector<std::string_view> splitAtSections(std::string_view buffer, size_t count) {
+			std::vector<std::string_view> chunks;
+			const size_t step = buffer.size() / std::max<size_t>(count, 1);
+			HeaderScanner scanner(buffer);
+			size_t begin = 0;
+			while (begin < buffer.size()) {
+				const size_t end = nextSectionStart(scanner, buffer, std::max(begin + step, begin + 1));
+				chunks.push_back(buffer.substr(begin, end - begin));
+				begin = end;
+			}
+			return chunks;
+		}
+	
+		void recordChange(ConfigChangeSet& changes, ConfigKeyChange::Kind kind, std::string_view section,
+						  std::string_view key, const StoredValue* oldValue, const StoredValue* newValue) {
+			changes.changes.push_back({kind, std::string(section), std::string(key), StoredValue(), StoredValue()});
+			ConfigKeyChange& change = changes.changes.back();
+			if (oldValue) change.oldValue.assign(*oldValue, std::pmr::new_delete_resource());
+			if (newValue) change.newValue.assign(*newValue, std::pmr::new_delete_resource());
+		}
+	}
+	
+	void ConfigReader::recordFingerprints(std::string_view buffer) {
+		sectionFingerprints.clear();
+		for (const auto& section : splitSections(buffer)) {
+			sectionFingerprints.emplace(std::string(section.name), section.fingerprint);
+		}
+	}
+	
+	ConfigChangeSet ConfigReader::reloadIncremental() {
+		CONFIG_LOG_DEBUG("ConfigReader::reloadIncremental started");
+		LoadProfile load(statsCollector, "reloadIncremental", LoadPhase::FileIO);
+		LoadProfile* const profile = LoadProfile::current();
+		ConfigChangeSet changes;
+		// Read rather than mapped: this runs on the watcher's thread, and an editor truncating the
+		// file in place would fault a mapping with SIGBUS
+		MappedFile file;
+		if (!file.read(filepath)) {
+			CONFIG_LOG_WARN("Unable to open file: " << filepath << ". Keeping current values.");
+			return changes;
+		}
+		if (schema->empty()) {
+			PhaseScope phase(profile, LoadPhase::Schema);
+			buildSchemaIndex();
+		}
+	
+		WriteScope scope(*this);
+		ConfigGeneration& target = scope.generation();
+		std::vector<SectionText> sections;
+		{
+			SpanScope span(profile, "fingerprint", LoadPhase::FileIO);
+			sections = splitSections(file.view());
+		}
+	
+		// Changed sections are parsed on their own, then merged key by key
+		ConfigGeneration parsed(arenaEnabled);
+		std::vector<ConfigViolation> violations;
+		std::unordered_map<std::string_view, uint64_t> fingerprints;
+		std::unordered_set<std::string_view> reparsed;
+		std::vector<std::string_view> changed;
+		for (const auto& text : sections) {
+			fingerprints.emplace(text.name, text.fingerprint);
+			const auto known = sectionFingerprints.find(std::string(text.name));
+			if (known != sectionFingerprints.end() && known->second == text.fingerprint
+				&& !referencesChangedArray(target.findSection(text.name))) {
+				++changes.sectionsSkipped;
+				continue;
+			}
+			++changes.sectionsParsed;
+			if (reparsed.insert(text.name).second) changed.push_back(text.name);
+			for (const auto& block : text.blocks) loadFromBuffer(parsed, block, violations);
+		}
+	
+		// Outside snapshot mode the merge writes to the live generation, so a value that cannot
+		// be stored must be found before anything is, not halfway through
+		for (const auto name : changed) {
+			const ConfigSection* fresh = parsed.findSection(name);
+			const ConfigSection* live = target.findSection(name);
+			if (!fresh || !live) continue;
+			for (const auto& entry : fresh->getEntries()) {
+				if (entry.value.empty()) continue;
+				const ConfigEntry* current = live->findEntry(entry.key);
+				if (current && !ConfigSection::keepsBoundType(*current, entry.value)) {
+					throw std::runtime_error("Type mismatch for bound key: " + std::string(name) + "." + std::string(entry.key));
+				}
+			}
+		}
+	
+		PhaseScope store(profile, LoadPhase::Store);
+		for (const auto name : changed) {
+			const ConfigSection* fresh = parsed.findSection(name);
+			ConfigSection* live = target.findSection(name);
+			if (fresh) {
+				if (!live) live = &target.getOrAddSection(name);
+				for (const auto& entry : fresh->getEntries()) {
+					if (entry.value.empty()) continue;
+					ConfigEntry& current = live->findOrAddEntry(entry.key);
+					if (current.value.empty()) {
+						recordChange(changes, ConfigKeyChange::Kind::Added, name, entry.key, nullptr, &entry.value);
+					} else if (current.value != entry.value) {
+						recordChange(changes, ConfigKeyChange::Kind::Modified, name, entry.key, &current.value, &entry.value);
+					} else {
+						continue;
+					}
+					live->assignStored(current, entry.value);
+				}
+			}
+			if (live) {
+				for (auto& entry : live->entries) {
+					if (entry.value.empty()) continue;
+					const ConfigEntry* replacement = fresh ? fresh->findEntry(entry.key) : nullptr;
+					if (replacement && !replacement->value.empty()) continue;
+					recordChange(changes, ConfigKeyChange::Kind::Removed, name, entry.key, &entry.value, nullptr);
+					entry.value.clear();
+				}
+			}
+		}
+	
+		// Sections that are no longer in the file lose all their values, as they would on reload()
+		PhaseScope finish(profile, LoadPhase::Finish);
+		for (const auto& section : target.getSections()) {
+			if (fingerprints.count(std::string_view(section.getName()))) continue;
+			ConfigSection& live = *target.findSection(section.getName());
+			for (auto& entry : live.entries) {
+				if (entry.value.empty()) continue;
+				recordChange(changes, ConfigKeyChange::Kind::Removed, live.getName(), entry.key, &entry.value, nullptr);
+				entry.value.clear();
+			}
+		}
+	
+		sectionFingerprints.clear();
+		for (const auto& text : sections) sectionFingerprints.emplace(std::string(text.name), text.fingerprint);
+		// Sections written since the last load were parsed again, so the file's values stand
+		unsavedKeys.clear();
+		// Violations in the sections left alone still stand
+		loadViolations.erase(std::remove_if(loadViolations.begin(), loadViolations.end(), [&](const ConfigViolation& violation) {
+			const auto known = fingerprints.find(violation.section);
+			return known == fingerprints.end() || reparsed.count(known->first);
+		}), loadViolations.end());
+		loadViolations.insert(loadViolations.end(), violations.begin(), violations.end());
+		// Without changes there is nothing to publish, and in snapshot mode the copy is dropped
+		if (!changes.empty()) scope.commit();
+		CONFIG_LOG_DEBUG("ConfigReader::reloadIncremental finished: " << changes.changes.size() << " changes, "
+			<< changes.sectionsParsed << " sections parsed, " << changes.sectionsSkipped << " skipped");
+		return changes;
+	}
+	
+	ConfigChangeSet ConfigReader::applyLayers(LayeredConfig& layers, bool replace) {
+		ConfigChangeSet changes;
+		WriteScope scope(*this, replace ? WriteScope::Source::Empty : WriteScope::Source::Current);
+		ConfigGeneration& target = scope.generation();
+		PhaseScope phase(LoadProfile::current(), LoadPhase::Store);
+		
+		// Outside snapshot mode the values are written to the live generation, so one that cannot
+		// be stored must be found before anything is, not halfway through
+		if (!replace) {
+			const ConfigSection* live = nullptr;
+			for (const auto& resolved : layers.resolved) {
+				const ConfigGen::SchemaEntry& entry = *resolved.entry;
+				if (resolved.value.empty()) continue;
+				if (!live || std::string_view(live->getName()) != entry.section) live = target.findSection(entry.section);
+				const ConfigEntry* current = live ? live->findEntry(entry.key) : nullptr;
+				if (current && !ConfigSection::keepsBoundType(*current, resolved.value)) {
+					throw std::runtime_error("Type mismatch for bound key: " + entry.section + "." + entry.key);
+				}
+			}
+		}
+		
+		ConfigSection* section = nullptr;
+		for (const auto& resolved : layers.resolved) {
+			const ConfigGen::SchemaEntry& entry = *resolved.entry;
+			if (replace && resolved.value.empty()) continue;
+			if (!section || std::string_view(section->getName()) != entry.section) section = &target.getOrAddSection(entry.section);
+			ConfigEntry& stored = section->findOrAddEntry(entry.key);
+			if (replace) {
+				section->assignStored(stored, resolved.value);
+				continue;
+			}
+			if (stored.value == resolved.value) continue;
+			if (resolved.value.empty()) {
+				recordChange(changes, ConfigKeyChange::Kind::Removed, entry.section, entry.key, &stored.value, nullptr);
+				stored.value.clear();
+				continue;
+			}
+			recordChange(changes, stored.value.empty() ? ConfigKeyChange::Kind::Added : ConfigKeyChange::Kind::Modified,
+				entry.section, entry.key, stored.value.empty() ? nullptr : &stored.value, &resolved.value);
+			section->assignStored(stored, resolved.value);
+		}
+		
+		loadViolations = layers.getViolations();
+		if (replace) {
+			setValidationRules(target);
+			carryOverRules(target);
+			sectionFingerprints.clear();
+			unsavedKeys.clear();
+		}
+		if (replace || !changes.empty()) scope.commit();
+		return changes;
+	}
+	
+	std::vector<ConfigViolation> ConfigReader::validate() const {
+		const ConfigSnapshot pinned = snapshot();
+		std::vector<ConfigViolation> violations;
+		for (const auto& section : pinned.getGeneration().getSections()) {
+			const ConfigGen::SchemaIndex::KeyTable* keys = schema->findSection(section.getName());
+			for (const auto& entry : section.getEntries()) {
+				if (entry.value.empty()) continue;
+				const ConfigGen::SchemaEntry* declared = ConfigGen::SchemaIndex::find(keys, entry.key);
+				std::string reason;
+				if (declared && entry.value.type() != declared->type) {
+					reason = std::string("Must be of type ") + valueTypeName(declared->type);
+				} else if (!entry.value.satisfies(entry.check)) {
+					reason = entry.check.rule->toString();
+				} else {
+					continue;
+				}
+				violations.push_back({std::string(section.getName()), std::string(entry.key), entry.value.toString(), std::move(reason)});
+			}
+		}
+		return violations;
+	}
+	
+	std::vector<ConfigViolation> ConfigReader::getLoadViolations() const {
+		std::lock_guard<std::mutex> lock(writeMutex);
+		return loadViolations;
+	}
+	
+	void ConfigReader::buildSchemaIndex() {
+		const std::vector<ConfigGen::ConfigSection> sections = getConfigSections();
+		if (!ConfigGen::validateConfig(sections)) {
+			CONFIG_LOG_WARN("Config schema of " << filepath << " has errors; see above");
+		}
+		// Generations bound to the previous index keep it alive for as long as they are read
+		auto index = std::make_shared<ConfigGen::SchemaIndex>();
+		index->build(sections);
+		schema = std::move(index);
+	}
+	
+	void ConfigReader::loadConfig() {
+		LoadProfile load(statsCollector, "loadConfig", LoadPhase::FileIO);
+		WriteScope scope(*this);
+		loadConfig(scope.generation());
+		PhaseScope finish(LoadProfile::current(), LoadPhase::Finish);
+		scope.commit();
+	}
+	
+	void ConfigReader::loadConfig(ConfigGeneration& target) {
+		LoadProfile* const profile = LoadProfile::current();
+		loadViolations.clear();
+		unsavedKeys.clear();
+		MappedFile file;
+		{
+			SpanScope span(profile, "open file", LoadPhase::FileIO);
+			if (!file.open(filepath)) {
+				CONFIG_LOG_WARN("Unable to open file: " << filepath);
+				sectionFingerprints.clear();
+				return;
+			}
+		}
+		loadFromBuffer(target, file.view(), loadViolations);
+		SpanScope span(profile, "fingerprint", LoadPhase::FileIO);
+		recordFingerprints(file.view());
+	}
+	
+	void ConfigReader::loadConfigCached(ConfigGeneration& target) {
+		LoadProfile* const profile = LoadProfile::current();
+		loadViolations.clear();
+		unsavedKeys.clear();
+		MappedFile file;
+		{
+			SpanScope span(profile, "open file", LoadPhase::FileIO);
+			if (!file.open(filepath)) {
+				CONFIG_LOG_WARN("Unable to open file: " << filepath);
+				sectionFingerprints.clear();
+				return;
+			}
+		}
+		
+		CacheKey key;
+		bool described = false;
+		const std::string cachePath = ConfigCache::pathFor(filepath);
+		{
+			SpanScope span(profile, "read cache", LoadPhase::FileIO);
+			described = ConfigCache::describe(filepath, file.view(), ConfigCache::schemaHash(*schema), key);
+			if (described && ConfigCache::read(cachePath, key, target)) {
+				// Section fingerprints are not cached, so the first incremental reload parses every section
+				sectionFingerprints.clear();
+				CONFIG_LOG_DEBUG("Loaded " << filepath << " from " << cachePath);
+				return;
+			}
+		}
+		
+		loadFromBuffer(target, file.view(), loadViolations);
+		SpanScope span(profile, "fingerprint", LoadPhase::FileIO);
+		recordFingerprints(file.view());
+		// Violations are not cached, so a file with any is parsed on every start to report them again
+		if (described && loadViolations.empty()) ConfigCache::write(cachePath, key, target);
+	}
+	
+	void ConfigReader::loadFromBuffer(std::string_view buffer) {
+		LoadProfile load(statsCollector, "loadFromBuffer", LoadPhase::Tokenize);
+		WriteScope scope(*this);
+		sectionFingerprints.clear();
+		loadViolations.clear();
+		// The buffer's values are not in the config file until saved
+		std::vector<const ConfigGen::SchemaEntry*> keys;
+		loadFromBuffer(scope.generation(), buffer, loadViolations, &keys);
+		for (const ConfigGen::SchemaEntry* entry : keys) unsavedKeys[entry->section].insert(entry->key);
+		PhaseScope finish(LoadProfile::current(), LoadPhase::Finish);
+		scope.commit();
+	}
+	
+	void ConfigReader::loadFromBuffer(ConfigGeneration& target, std::string_view buffer, std::vector<ConfigViolation>& violations,
+	                                  std::vector<const ConfigGen::SchemaEntry*>* keys) {
+		LoadProfile* const profile = LoadProfile::current();
+		if (schema->empty()) {
+			PhaseScope phase(profile, LoadPhase::Schema);
+			buildSchemaIndex();
+		}
+		const size_t firstViolation = violations.size();
+		
+		const unsigned threads = parseThreads ? parseThreads : std::max(1u, std::thread::hardware_concurrency());
+		{
+			SpanScope span(profile, "parse", LoadPhase::Tokenize);
+			// A reader loaded on a pool, as by ConfigRepository::loadAll(), already has its thread
+			if (buffer.size() >= parallelParseThreshold && threads > 1 && target.getSections().empty()
+				&& !WorkStealingPool::isRunningTask()) {
+				parseParallel(target, buffer, threads, violations, keys);
+			} else {
+				parseBuffer(target, buffer, violations, keys);
+			}
+		}
+		
+		if (violations.size() > firstViolation) {
+			CONFIG_LOG_WARN(violations.size() - firstViolation << " invalid values in " << filepath << " replaced by their defaults");
+			for (size_t i = firstViolation; i < violations.size(); ++i) {
+				CONFIG_LOG_DEBUG("Invalid value for " << violations[i].section << "." << violations[i].key << ": '"
+					<< violations[i].value << "' (" << violations[i].reason << ")");
+			}
+		}
+	}
+	
+	void ConfigReader::parseParallel(ConfigGeneration& target, std::string_view buffer, unsigned threads, std::vector<ConfigViolation>& violations,
+	                                 std::vector<const ConfigGen::SchemaEntry*>* keys) {
+		// A few chunks per thread let the pool even out sections of uneven cost
+		const size_t count = std::min<size_t>(size_t(threads) * 4, buffer.size() / kMinParseChunk);
+		const std::vector<std::string_view> chunks = splitAtSections(buffer, count);
+		if (chunks.size() < 2) {
+			parseBuffer(target, buffer, violations, keys);
+			return;
+		}
+		CONFIG_LOG_DEBUG("Parsing " << filepath << " in " << chunks.size() << " chunks on " << threads << " threads");
+		
+		std::vector<std::unique_ptr<ConfigGeneration>> parsed(chunks.size());
+		std::vector<std::vector<ConfigViolation>> rejected(chunks.size());
+		std::vector<std::vector<const ConfigGen::SchemaEntry*>> chunkKeys(keys ? chunks.size() : 0);
+		LoadProfile* const profile = LoadProfile::current();
+		WorkStealingPool pool(threads);
+		pool.run(chunks.size(), [&](size_t i) {
+			LoadProfile chunk(profile, "parse chunk", LoadPhase::Tokenize);
+			parsed[i] = std::make_unique<ConfigGeneration>(arenaEnabled, chunks[i].size());
+			parseBuffer(*parsed[i], chunks[i], rejected[i], keys ? &chunkKeys[i] : nullptr);
+		});
+		
+		// Merged in file order: sections are added in the order their first key appears, and a
+		// key written by several chunks ends up with the last chunk's value, as in a serial parse
+		SpanScope span(profile, "merge", LoadPhase::Store);
+		for (size_t i = 0; i < chunks.size(); ++i) {
+			for (const auto& section : parsed[i]->getSections()) {
+				ConfigSection& merged = target.getOrAddSection(section.getName());
+				if (merged.getEntries().empty()) {
+					merged.copyEntries(section);
+					continue;
+				}
+				for (const auto& entry : section.getEntries()) {
+					merged.assignStored(merged.findOrAddEntry(entry.key), entry.value);
+				}
+			}
+			parsed[i].reset();
+			violations.insert(violations.end(), std::make_move_iterator(rejected[i].begin()), std::make_move_iterator(rejected[i].end()));
+			if (keys) keys->insert(keys->end(), chunkKeys[i].begin(), chunkKeys[i].end());
+		}
+	}
+	
+	void ConfigReader::parseBuffer(ConfigGeneration& target, std::string_view buffer, std::vector<ConfigViolation>& violations,
+	                               std::vector<const ConfigGen::SchemaEntry*>* keys) {
+		IniStreamReader reader(buffer);
+		IniEvent event;
+		const ConfigGen::SchemaIndex::KeyTable* sectionKeys = nullptr;
+		// Looked up on the first schema key of each section, so that unknown sections stay absent
+		ConfigSection* targetSection = nullptr;
+		// Reused for every string value, so that its buffer is allocated once per load
+		std::string stringValue;
+		// Null unless statistics are on; every use is then a single untaken branch
+		LoadProfile* const profile = LoadProfile::current();
+		const auto enter = [profile](LoadPhase phase) {
+			if (profile) profile->enter(phase);
+		};
+		
+		while (reader.next(event)) {
+			if (event.kind == IniEvent::Kind::Section) {
+				sectionKeys = schema->findSection(event.section);
+				targetSection = nullptr;
+				continue;
+			}
+			if (event.kind == IniEvent::Kind::Error && profile) profile->countParseError();
+			if (event.kind != IniEvent::Kind::KeyValue || !sectionKeys) continue;
+			
+			// Keys that are not part of the schema are ignored
+			const ConfigGen::SchemaEntry* entry = ConfigGen::SchemaIndex::find(sectionKeys, event.key);
+			if (!entry) continue;
+			if (keys) keys->push_back(entry);
+			
+			// Stored values are keyed by the schema's own strings, so nothing is copied out of the buffer for them
+			const std::string& section = entry->section;
+			const std::string& key = entry->key;
+			const std::string_view value = event.value;
+			if (!targetSection) targetSection = &target.getOrAddSection(section);
+			
+			// Invalid values are recorded and replaced by the default
+			const auto reject = [&](std::string reason) {
+				enter(LoadPhase::Defaults);
+				if (profile) profile->countDefault();
+				violations.push_back({section, key, std::string(value), std::move(reason)});
+				useDefaultValue(*targetSection, *entry);
+			};
+			const auto rejectText = [&](const char* reason) {
+				if (profile) profile->countParseError();
+				reject(reason);
+			};
+			const auto rejectByRule = [&] {
+				if (profile) profile->countValidationFailure();
+				reject(entry->check.rule->toString());
+			};
+			
+			try {
+				switch (entry->type) {
+					case ValueType::Double: {
+						double doubleValue;
+						enter(LoadPhase::NumberParse);
+						if (!NumberCodec::parseDouble(value, doubleValue)) {
+							rejectText("Invalid number");
+							break;
+						}
+						enter(LoadPhase::Validation);
+						if (entry->check(doubleValue)) {
+							enter(LoadPhase::Store);
+							targetSection->setValue(key, doubleValue);
+						} else {
+							rejectByRule();
+						}
+						break;
+					}
+					case ValueType::Int: {
+						int intValue;
+						enter(LoadPhase::NumberParse);
+						if (!NumberCodec::parseInt(value, intValue)) {
+							rejectText("Invalid integer");
+							break;
+						}
+						enter(LoadPhase::Validation);
+						if (entry->check(intValue)) {
+							enter(LoadPhase::Store);
+							targetSection->setValue(key, intValue);
+						} else {
+							rejectByRule();
+						}
+						break;
+					}
+					case ValueType::DoubleVector: {
+						// An array file is only referred to here; its values are read when first used
+						const std::string_view arrayPath = ExternalArray::referencedPath(value);
+						if (!arrayPath.empty()) {
+							enter(LoadPhase::Store);
+							targetSection->setArrayReference(key, arrayPath);
+							break;
+						}
+						std::vector<double> vec;
+						enter(LoadPhase::NumberParse);
+						if (!NumberCodec::parseDoubleList(value, vec)) {
+							rejectText("Invalid number list");
+							break;
+						}
+						enter(LoadPhase::Validation);
+						if (entry->check(vec.data(), vec.size())) {
+							enter(LoadPhase::Store);
+							targetSection->setValue(key, vec);
 						} else {
-							setValue(section, key, value);
+							rejectByRule();
 						}
-						return;
+						break;
+					}
+					case ValueType::String: {
+						enter(LoadPhase::Validation);
+						if (entry->check(value)) {
+							enter(LoadPhase::Store);
+							stringValue.assign(value.data(), value.size());
+							targetSection->setValue(key, stringValue);
+						} else {
+							rejectByRule();
+						}
+						break;
 					}
 				}
+			} catch (const std::exception& e) {
+				reject(e.what());
 			}
+			enter(LoadPhase::Tokenize);
 		}
-		throw std::runtime_error("Key not found in configuration");
 	}
 	
-	void ConfigReader::useDefaultValue(const std::string& section, const std::string& key, const ConfigGen::ConfigItem& item) {
-		setValueWithValidation(section, key, item.defaultValue);
+	void ConfigReader::setValueWithValidation(const std::string& section, const std::string& key, const std::string& value) {
+		if (schema->empty()) buildSchemaIndex();
+		const ConfigGen::SchemaEntry* entry = schema->find(section, key);
+		if (!entry) {
+			throw std::runtime_error("Key not found in configuration");
+		}
+		WriteScope scope(*this);
+		setValueWithValidation(scope.generation().getOrAddSection(section), *entry, value);
+		recordWrite(section, key);
+		scope.commit();
 	}
 	
-	void ConfigReader::saveConfig() const {
-		std::ofstream file(filepath);
-		if (!file.is_open()) {
-			throw std::runtime_error("Unable to open file for writing: " + filepath);
+	void ConfigReader::setValueWithValidation(ConfigSection& target, const ConfigGen::SchemaEntry& entry, const std::string& value) {
+		switch (entry.type) {
+			case ValueType::Double: {
+				double doubleValue;
+				if (!NumberCodec::parseDouble(value, doubleValue)) {
+					throw std::invalid_argument("Invalid number for " + entry.section + "." + entry.key + ": " + value);
+				}
+				target.setValue(entry.key, doubleValue);
+				break;
+			}
+			case ValueType::Int: {
+				int intValue;
+				if (!NumberCodec::parseInt(value, intValue)) {
+					throw std::invalid_argument("Invalid integer for " + entry.section + "." + entry.key + ": " + value);
+				}
+				target.setValue(entry.key, intValue);
+				break;
+			}
+			case ValueType::DoubleVector: {
+				const std::string_view arrayPath = ExternalArray::referencedPath(value);
+				if (!arrayPath.empty()) {
+					target.setArrayReference(entry.key, arrayPath);
+					break;
+				}
+				std::vector<double> vec;
+				if (!NumberCodec::parseDoubleList(value, vec)) {
+					throw std::invalid_argument("Invalid number list for " + entry.section + "." + entry.key + ": " + value);
+				}
+				target.setValue(entry.key, vec);
+				break;
+			}
+			case ValueType::String:
+				target.setValue(entry.key, value);
+				break;
 		}
+	}
 	
-		for (const auto& section : sections) {
-			file << "[" << section.first << "]\n";
-			for (const auto& value : section.second.getValues()) {
-				file << value.first << " = " << value.second->toString() << "\n";
+	void ConfigReader::useDefaultValue(ConfigSection& target, const ConfigGen::SchemaEntry& entry) {
+		setValueWithValidation(target, entry, entry.defaultValue);
+	}
+	
+	namespace {
+		// Where the unsaved keys of one section are in the file being saved over
+		struct SaveTarget {
+			// Text of each key's last value in the file; a null view if the file lacks the key
+			std::unordered_map<std::string, std::string_view> values;
+			// Just after the last key line, or the header, of the section's last occurrence
+			size_t insertAt = std::string_view::npos;
+		};
+	
+		// One change to the file's text; lines inserts whole lines, which must start a line
+		struct Edit {
+			size_t offset;
+			size_t length;
+			std::string text;
+			bool lines;
+		};
+	
+		// Only lines starting with '[' and the lines of sections with unsaved keys are classified,
+		// so locating a few keys in a large file costs little more than finding its newlines.
+		void locateKeys(std::string_view file, std::unordered_map<std::string, SaveTarget>& targets) {
+			SaveTarget* open = nullptr;
+			IniToken token;
+			for (size_t offset = 0; offset < file.size();) {
+				const char* begin = file.data() + offset;
+				const size_t remaining = file.size() - offset;
+				const char* newline = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+				const size_t length = newline ? static_cast<size_t>(newline - begin) : remaining;
+				const std::string_view line(begin, length);
+				const size_t next = offset + length + (newline ? 1 : 0);
+				offset = next;
+	
+				size_t first = 0;
+				while (first < length && (begin[first] == ' ' || begin[first] == '\t')) ++first;
+				if (first < length && begin[first] == '[') {
+					IniTokenizer::classify(line, token);
+					if (token.kind == IniToken::Kind::Section) {
+						const auto found = targets.find(std::string(token.name));
+						open = found != targets.end() ? &found->second : nullptr;
+						if (open) open->insertAt = next;
+						continue;
+					}
+				}
+				if (!open) continue;
+				IniTokenizer::classify(line, token);
+				if (token.kind != IniToken::Kind::KeyValue) continue;
+				open->insertAt = next;
+				const auto found = open->values.find(std::string(token.key));
+				if (found != open->values.end()) found->second = token.value;
 			}
-			file << "\n";
 		}
 	}
 	
+	void ConfigReader::saveConfig() const {
+		std::lock_guard<std::mutex> lock(writeMutex);
+		const ConfigSnapshot pinned = snapshot();
+		const ConfigGeneration& generation = pinned.getGeneration();
+	
+		MappedFile file;
+		std::string contents;
+		if (!file.open(filepath)) {
+			// No layout to keep: every value is written, in stored order
+			for (const auto& section : generation.getSections()) {
+				contents += "[" + std::string(section.getName()) + "]\n";
+				for (const auto& entry : section.getEntries()) {
+					if (entry.value.empty()) continue;
+					contents += std::string(entry.key) + " = " + entry.value.toString() + "\n";
+				}
+				contents += "\n";
+			}
+		} else {
+			if (unsavedKeys.empty()) return;
+			const std::string_view text = file.view();
+			std::unordered_map<std::string, SaveTarget> targets;
+			for (const auto& unsaved : unsavedKeys) {
+				SaveTarget& target = targets[unsaved.first];
+				for (const auto& key : unsaved.second) target.values.emplace(key, std::string_view());
+			}
+			locateKeys(text, targets);
+	
+			// Only unsaved values are formatted; keys and sections the file lacks are added in stored order
+			std::vector<Edit> edits;
+			std::string appended;
+			for (const auto& section : generation.getSections()) {
+				const auto target = targets.find(std::string(section.getName()));
+				if (target == targets.end()) continue;
+				std::string added;
+				for (const auto& entry : section.getEntries()) {
+					if (entry.value.empty()) continue;
+					const auto located = target->second.values.find(std::string(entry.key));
+					if (located == target->second.values.end()) continue;
+					const std::string value = entry.value.toString();
+					if (!located->second.data()) {
+						added += std::string(entry.key) + " = " + value + "\n";
+						continue;
+					}
+					const size_t offset = static_cast<size_t>(located->second.data() - text.data());
+					// "key =" gets the space that "key = value" would have
+					const bool spaced = located->second.empty() && offset > 0 && text[offset - 1] == '=';
+					edits.push_back({offset, located->second.size(), spaced ? " " + value : value, false});
+				}
+				if (added.empty()) continue;
+				if (target->second.insertAt != std::string_view::npos) {
+					edits.push_back({target->second.insertAt, 0, std::move(added), true});
+				} else {
+					appended += "\n[" + target->first + "]\n" + added;
+				}
+			}
+			if (!appended.empty()) edits.push_back({text.size(), 0, std::move(appended), true});
+			std::stable_sort(edits.begin(), edits.end(), [](const Edit& a, const Edit& b) { return a.offset < b.offset; });
+	
+			size_t growth = 0;
+			for (const auto& edit : edits) growth += edit.text.size() + 1;
+			contents.reserve(text.size() + growth);
+			size_t copied = 0;
+			for (const auto& edit : edits) {
+				contents.append(text.data() + copied, edit.offset - copied);
+				// Only the end of a file can lack a final newline
+				if (edit.lines && !contents.empty() && contents.back() != '\n') contents += '\n';
+				contents += edit.text;
+				copied = edit.offset + edit.length;
+			}
+			contents.append(text.data() + copied, text.size() - copied);
+			file.close();
+		}
+	
+		writeFileAtomically(filepath, contents);
+		unsavedKeys.clear();
+	}
+	
 	std::string ConfigReader::trim(const std::string& str) {
 		const auto strBegin = str.find_first_not_of(" \t");
 		if (strBegin == std::string::npos) return "";
@@ -572,7 +1759,7 @@ void ConfigReader::loadConfig() {
 		
 		// TODO (IHT): Update to boost::filesystem::exists(filePath)
 		if (file.is_open()) {
-			std::cout << "Configuration file already exists. Skipping generation." << std::endl;
+			CONFIG_LOG_INFO("Configuration file already exists. Skipping generation.");
 			return;
 		}
 		
@@ -595,9 +1782,6 @@ void ConfigReader::loadConfig() {
 		}
 	}
 	
-	// Compile-time check
-	static_assert(ConfigGen::validateConfigStructure(), "Invalid configuration structure detected at compile-time");
-	
 	// Explicit template instantiations
 	template class TypedConfigValue<int>;
 	template class TypedConfigValue<double>; 
@@ -620,6 +1804,36 @@ void ConfigReader::loadConfig() {
 	template std::string ConfigReader::getValue<std::string>(const std::string&, const std::string&) const;
 	template std::vector<double> ConfigReader::getValue<std::vector<double>>(const std::string&, const std::string&) const;
 	
+	template ConfigHandle<int> ConfigSection::bind<int>(const std::string&) const;
+	template ConfigHandle<double> ConfigSection::bind<double>(const std::string&) const;
+	template ConfigHandle<std::string> ConfigSection::bind<std::string>(const std::string&) const;
+	template ConfigHandle<std::vector<double>> ConfigSection::bind<std::vector<double>>(const std::string&) const;
+	
+	template ConfigHandle<int> ConfigReader::bind<int>(const std::string&, const std::string&) const;
+	template ConfigHandle<double> ConfigReader::bind<double>(const std::string&, const std::string&) const;
+	template ConfigHandle<std::string> ConfigReader::bind<std::string>(const std::string&, const std::string&) const;
+	template ConfigHandle<std::vector<double>> ConfigReader::bind<std::vector<double>>(const std::string&, const std::string&) const;
+	
+	template int ConfigGeneration::getValue<int>(const std::string&, const std::string&) const;
+	template double ConfigGeneration::getValue<double>(const std::string&, const std::string&) const;
+	template std::string ConfigGeneration::getValue<std::string>(const std::string&, const std::string&) const;
+	template std::vector<double> ConfigGeneration::getValue<std::vector<double>>(const std::string&, const std::string&) const;
+	
+	template int ConfigGeneration::getValue<int>(ConfigGen::KeyId<int>) const;
+	template double ConfigGeneration::getValue<double>(ConfigGen::KeyId<double>) const;
+	template std::string ConfigGeneration::getValue<std::string>(ConfigGen::KeyId<std::string>) const;
+	template std::vector<double> ConfigGeneration::getValue<std::vector<double>>(ConfigGen::KeyId<std::vector<double>>) const;
+	
+	template int ConfigReader::getValue<int>(ConfigGen::KeyId<int>) const;
+	template double ConfigReader::getValue<double>(ConfigGen::KeyId<double>) const;
+	template std::string ConfigReader::getValue<std::string>(ConfigGen::KeyId<std::string>) const;
+	template std::vector<double> ConfigReader::getValue<std::vector<double>>(ConfigGen::KeyId<std::vector<double>>) const;
+	
+	template ConfigHandle<int> ConfigSnapshot::bind<int>(const std::string&, const std::string&) const;
+	template ConfigHandle<double> ConfigSnapshot::bind<double>(const std::string&, const std::string&) const;
+	template ConfigHandle<std::string> ConfigSnapshot::bind<std::string>(const std::string&, const std::string&) const;
+	template ConfigHandle<std::vector<double>> ConfigSnapshot::bind<std::vector<double>>(const std::string&, const std::string&) const;
+	
 	template void ConfigReader::setValue<int>(const std::string&, const std::string&, const int&);
 	template void ConfigReader::setValue<double>(const std::string&, const std::string&, const double&);
 	template void ConfigReader::setValue<std::string>(const std::string&, const std::string&, const std::string&);
@@ -2,31 +2,34 @@
 #define CONFIG_READER_H
 
 #include "validation_rules.hpp"
+#include "config_schema.hpp"
+#include "schema_index.hpp"
+#include "stored_value.hpp"
+#include "config_arena.hpp"
+#include "config_stats.hpp"
+#include "hazard_pointers.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <vector>
 #include <functional>
+#include <tuple>
 
 namespace ConfigLib {
    namespace ConfigGen {
-       struct ConfigItem {
-           const char* name;
-           const char* type;
-           const char* defaultValue;
-           const char* description;
-           const ValidationRules::Rule* validationRule;
-       };
-
-       struct ConfigSection {
-           std::string name;
-           std::vector<ConfigItem> items;
-       };
-
-       bool validateConfig(const std::vector<ConfigSection>& sections);
-       std::string generateConfig(const std::vector<ConfigSection>& sections);
+       class StructLoader;
    }
 
+   class ConfigTransaction;
+   class LayeredConfig;
+
    class ConfigValue {
    public:
        virtual ~ConfigValue() = default;
@@ -51,8 +54,56 @@ namespace ConfigLib {
 
    //using ValidationRule = std::function<bool(const ConfigValue&)>;
 
+// Typed reference to one stored value, resolved and type-checked once by bind().
+// get() is a single pointer dereference. Writes to the key (setValue, loadConfig) update the
+// stored value in place, so the handle keeps observing the current value. Binding fixes the
+// key's type: writing a value of a different type to it afterwards throws. A handle must not
+// outlive the reader it was bound from, nor be used after ConfigReader::reload(). Handles bound
+// through a ConfigSnapshot see that snapshot's values and live as long as it does.
+// Strings and lists are viewed as they are stored, as std::pmr::string and DoubleList; lists held
+// in an ExternalArray cannot be bound, and are read through getArray().
+template<typename T>
+class ConfigHandle {
+public:
+    using value_type = StoredType<T>;
+
+    ConfigHandle() = default;
+
+    const value_type& get() const { return *value; }
+    const value_type& operator*() const { return *value; }
+    const value_type* operator->() const { return value; }
+    explicit operator bool() const { return value != nullptr; }
+
+private:
+    friend class ConfigSection;
+    explicit ConfigHandle(const value_type* value) : value(value) {}
+
+    const value_type* value = nullptr;
+};
+
+// One key of a section, with its value and validation rule side by side.
+struct ConfigEntry {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    explicit ConfigEntry(const allocator_type& allocator) : key(allocator) {}
+
+    std::pmr::string key;
+    StoredValue value;                                  // empty if only a rule has been set
+    ValidationRules::Check check;                       // the key's rule, bound; passes if there is none
+    mutable std::atomic<bool> bound{false};             // a ConfigHandle points at the value
+};
+
+// Keys, values and the lookup table of a section all allocate from the allocator the section
+// was constructed with.
 class ConfigSection {
 public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    ConfigSection() : ConfigSection(allocator_type()) {}
+    explicit ConfigSection(const allocator_type& allocator) : ConfigSection(std::string_view(), allocator) {}
+    ConfigSection(std::string_view name, const allocator_type& allocator)
+        : name(name, allocator), entries(allocator), slots(allocator) {}
+
     template<typename T>
     void setValue(const std::string& key, const T& value);
 
@@ -61,26 +112,204 @@ public:
 
     template<typename T>
     T getValue(const std::string& key) const;
+    // The list stored under key, inline or in an ExternalArray, viewed without a copy. The view
+    // is valid until the key is written again. Throws std::runtime_error if the key holds no
+    // list, or if its array file cannot be read.
+    DoubleSpan getArray(const std::string& key) const;
+
+    template<typename T>
+    ConfigHandle<T> bind(const std::string& key) const;
 
     bool hasKey(const std::string& key) const;
     void setValidationRule(const std::string& key, const ValidationRules::Rule* rule);
-    const std::unordered_map<std::string, std::shared_ptr<ConfigValue>>& getValues() const;
+    const std::pmr::string& getName() const { return name; }
+    // All entries in insertion order, including rule-only entries whose value is empty.
+    const std::pmr::deque<ConfigEntry>& getEntries() const { return entries; }
+
+private:
+    friend class ConfigReader;
+    friend class ConfigGeneration;
+    friend class ConfigCache;
+    friend class ConfigGen::StructLoader;
+
+    // Replaces this (empty) section's entries with copies of other's.
+    void copyEntries(const ConfigSection& other);
+    const ConfigEntry* findEntry(std::string_view key) const;
+    ConfigEntry* findEntry(std::string_view key);
+    ConfigEntry& findOrAddEntry(std::string_view key);
+    // Sizes the lookup table for count entries, so that adding up to that many never rehashes.
+    void reserve(size_t count);
+    // Copies value into entry, which may be empty; the type of a bound entry must not change.
+    void assignStored(ConfigEntry& entry, const StoredValue& value);
+    // Whether assignStored() accepts value for entry.
+    static bool keepsBoundType(const ConfigEntry& entry, const StoredValue& value);
+    // Stores a reference to the ExternalArray at path.
+    void setArrayReference(std::string_view key, std::string_view path);
+    void insertSlot(uint32_t index);
+    std::pmr::memory_resource* resource() const { return entries.get_allocator().resource(); }
+
+    template<typename T>
+    void assignValue(ConfigEntry& entry, const T& value);
+
+    static constexpr uint32_t kEmptySlot = 0xffffffffu;
+
+    std::pmr::string name;
+    // A deque never moves its elements when growing, which keeps bound handles valid
+    std::pmr::deque<ConfigEntry> entries;
+    // Open-addressing hash table of indexes into entries, linear probing, at most half full
+    std::pmr::vector<uint32_t> slots;
+};
+
+// Everything parsed by one load. With an arena, all sections, keys and values allocate from a
+// pool owned by the generation, so dropping a generation hands its memory back to the system
+// in a few large blocks instead of one free per key.
+class ConfigGeneration {
+public:
+    // sizeHint is the expected number of bytes, typically those of the generation being replaced
+    explicit ConfigGeneration(bool useArena, size_t sizeHint = 0);
+    ConfigGeneration(const ConfigGeneration&) = delete;
+    ConfigGeneration& operator=(const ConfigGeneration&) = delete;
+
+    ConfigSection& getOrAddSection(std::string_view name);
+    const ConfigSection* findSection(std::string_view name) const;
+    ConfigSection* findSection(std::string_view name);
+
+    // Throws std::runtime_error if the section or key is missing or holds another type.
+    template<typename T>
+    T getValue(const std::string& section, const std::string& key) const;
+    bool hasValue(const std::string& section, const std::string& key) const;
+    // The stored value, or null if the section or key is missing or only has a rule.
+    const StoredValue* findValue(std::string_view section, std::string_view key) const;
+    // Reads a key by its position in the schema, with no hashing or string comparison. Throws
+    // std::runtime_error if the key has no value of type T, std::logic_error if the generation
+    // was not bound to a schema that long.
+    template<typename T>
+    T getValue(ConfigGen::KeyId<T> id) const;
+    // As ConfigSection::getArray().
+    DoubleSpan getArray(const std::string& section, const std::string& key) const;
+
+    // Adds an entry, empty if need be, for every key of schema and records it in schema order,
+    // so that the i-th schema entry can be read through KeyId i. Entries are never removed, which
+    // keeps the table valid for the life of the generation. Lookups by name then find keys of the
+    // schema through its perfect hash and the table; the generation shares ownership of schema,
+    // so a reader rebuilding its index never pulls it from under a snapshot.
+    void bindSchema(std::shared_ptr<const ConfigGen::SchemaIndex> schema);
+    bool isSchemaBound() const { return !keyEntries.empty(); }
+    const ConfigGen::SchemaIndex* getBoundSchema() const { return boundSchema.get(); }
+
+    // Deep copy, sized after this generation's arena.
+    std::unique_ptr<ConfigGeneration> clone(bool useArena) const;
+
+    const std::pmr::deque<ConfigSection>& getSections() const { return sections; }
+    size_t getArenaBytes() const { return arena ? arena->bytesAllocated() : 0; }
 
 private:
-    std::unordered_map<std::string, std::shared_ptr<ConfigValue>> values;
-    std::unordered_map<std::string, const ValidationRules::Rule*> validationRules;
+    // Declared first so that it outlives everything allocated from it
+    std::unique_ptr<ConfigArena> arena;
+    std::pmr::deque<ConfigSection> sections;
+    // Keys view the names stored in sections
+    std::pmr::unordered_map<std::string_view, ConfigSection*> index;
+    // The entry of a key of the bound schema, or null for other keys and unbound generations
+    const ConfigEntry* findBoundEntry(std::string_view section, std::string_view key) const {
+        if (!boundSchema) return nullptr;
+        const uint32_t position = boundSchema->findPosition(section, key);
+        return position < keyEntries.size() ? keyEntries[position] : nullptr;
+    }
+
+    // Entries of the bound schema's keys, indexed by KeyId
+    std::pmr::vector<const ConfigEntry*> keyEntries;
+    std::shared_ptr<const ConfigGen::SchemaIndex> boundSchema;
+};
+
+// A pinned, immutable generation of a reader in snapshot mode. Pinning and reading take no
+// locks; the generation is reclaimed only after the last snapshot of it is gone. A snapshot
+// must not outlive its reader.
+class ConfigSnapshot {
+public:
+    ConfigSnapshot() = default;
+    ConfigSnapshot(ConfigSnapshot&& other) noexcept;
+    ConfigSnapshot& operator=(ConfigSnapshot&& other) noexcept;
+    ConfigSnapshot(const ConfigSnapshot&) = delete;
+    ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+    ~ConfigSnapshot();
+
+    template<typename T>
+    T getValue(const std::string& section, const std::string& key) const {
+        return generation->getValue<T>(section, key);
+    }
+    template<typename T>
+    T getValue(ConfigGen::KeyId<T> id) const {
+        return generation->getValue(id);
+    }
+    bool hasValue(const std::string& section, const std::string& key) const {
+        return generation->hasValue(section, key);
+    }
+    // A view of the list, valid as long as the snapshot; see ConfigSection::getArray().
+    DoubleSpan getArray(const std::string& section, const std::string& key) const {
+        return generation->getArray(section, key);
+    }
+
+    template<typename T>
+    ConfigHandle<T> bind(const std::string& section, const std::string& key) const;
+
+    const ConfigGeneration& getGeneration() const { return *generation; }
+    explicit operator bool() const { return generation != nullptr; }
+
+private:
+    friend class ConfigReader;
+    ConfigSnapshot(const ConfigGeneration* generation, HazardPointers::Slot* slot)
+        : generation(generation), slot(slot) {}
+
+    const ConfigGeneration* generation = nullptr;
+    HazardPointers::Slot* slot = nullptr;
+};
+
+// One key whose value differs between two loads. oldValue is empty for an added key and
+// newValue for a removed one.
+struct ConfigKeyChange {
+    enum class Kind { Added, Removed, Modified };
+
+    Kind kind;
+    std::string section;
+    std::string key;
+    StoredValue oldValue;
+    StoredValue newValue;
+};
+
+// Outcome of ConfigReader::reloadIncremental(), and of changes to one layer of a LayeredConfig.
+struct ConfigChangeSet {
+    std::vector<ConfigKeyChange> changes;   // in file order within each section
+    size_t sectionsParsed = 0;
+    size_t sectionsSkipped = 0;
+
+    bool empty() const { return changes.empty(); }
+};
+
+// A value that failed to parse, holds another type than declared or breaks its validation rule.
+struct ConfigViolation {
+    std::string section;
+    std::string key;
+    std::string value;      // as written in the file, or as stored
+    std::string reason;     // the rule's description, or what did not parse
 };
 
 class ConfigReader {
+    template<typename T>
+    struct KeyOf { using type = std::string; };
+
 public:
     ConfigReader();
-    virtual ~ConfigReader() = default;
+    virtual ~ConfigReader();
 
 	void initialize();
 
     template<typename T>
     T getValue(const std::string& section, const std::string& key) const;
 
+    // Key ids come from a compile-time schema; see StaticConfigReader.
+    template<typename T>
+    T getValue(ConfigGen::KeyId<T> id) const;
+
     template<typename T>
     void setValue(const std::string& section, const std::string& key, const T& value);
 
@@ -88,29 +317,213 @@ public:
     void setValue(const std::string& section, const std::string& key, const std::vector<double>& value);
 
     bool hasValue(const std::string& section, const std::string& key) const;
+    // Reads a list without copying it: a view of its stored, aligned values, or of the mapped
+    // file of an ExternalArray, which is only opened on its first read. Valid until the key is
+    // written again or the reader reloaded; like bind(), only available through snapshots in
+    // snapshot mode. Throws std::runtime_error if the key holds no list, or if its array file
+    // cannot be read.
+    DoubleSpan getArray(const std::string& section, const std::string& key) const;
+
+    template<typename T>
+    ConfigHandle<T> bind(const std::string& section, const std::string& key) const;
+
+    // Binds several keys of one section with a single section lookup, e.g.
+    // auto h = reader.bindAll<double, int>("Simulation", "volatility", "num_steps");
+    template<typename... Ts>
+    std::tuple<ConfigHandle<Ts>...> bindAll(const std::string& section, const typename KeyOf<Ts>::type&... keys) const {
+        const ConfigSection& sect = findSection(section);
+        return std::tuple<ConfigHandle<Ts>...>(sect.bind<Ts>(keys)...);
+    }
 
     void setValidationRule(const std::string& section, const std::string& key, const ValidationRules::Rule* rule);
+    // Starts a batch of writes that is validated and applied as a whole; see ConfigTransaction.
+    ConfigTransaction begin();
+    // Writes the values set since the config file was last loaded or saved back into it. Only
+    // those values are formatted; each replaces the text of its key's last occurrence, keys the
+    // file lacks are added to the end of their section, and every other byte, comments and
+    // order included, stays as it was. The file is replaced atomically (see writeFileAtomically),
+    // or written in full if it does not exist. Throws std::runtime_error if it cannot be written.
     void saveConfig() const;
 
+    // Checks every stored value against its declared type and bound rule in one pass over the
+    // current values, and returns what fails.
+    std::vector<ConfigViolation> validate() const;
+    // Values the last load of the config file rejected in favour of their defaults: by
+    // initialize(), reload() or loadFromBuffer(), and for the sections it parsed, reloadIncremental().
+    std::vector<ConfigViolation> getLoadViolations() const;
+
+    // Loads the config file into a new generation and then releases the previous one in full.
+    // Validation rules carry over; handles bound before the reload must be bound again.
+    void reload();
+    // Like reload(), but only the sections whose text changed since the config file was last
+    // loaded are parsed and validated again; the others keep their values. Sections written
+    // through setValue() or loadFromBuffer() since then count as changed, and so do sections
+    // with a list whose array file was rewritten or replaced (see ExternalArray).
+    // Outside snapshot mode the update is applied in place, so handles to modified keys keep
+    // observing the current value; handles to removed keys must not be used. If the file cannot
+    // be opened, nothing changes; if a changed value would change the type of a bound one, it
+    // throws std::runtime_error and nothing changes either.
+    ConfigChangeSet reloadIncremental();
+    // Whether generations created from now on allocate from their own arena (the default) or
+    // straight from the global heap.
+    void setArenaEnabled(bool enabled) { arenaEnabled = enabled; }
+    // Whether generations keep a table of the schema's keys, through which getValue(), hasValue()
+    // and snapshots find a key of the schema by name with one hash of (section, key) and an array
+    // index, instead of a lookup of the section and then of the key (see SchemaIndex). Other keys
+    // take the usual path. Applies from the next write on, and gives every key of the schema an
+    // entry, empty until set. Always on for readers of a compile-time schema. Off by default.
+    void setSchemaLookup(bool enabled) { schemaLookupEnabled = enabled; }
+    // Whether initialize() starts from a compiled cache of the config file when one matches it,
+    // and compiles one when none does (see ConfigCache). Off by default.
+    void setCacheEnabled(bool enabled) { cacheEnabled = enabled; }
+    // Config files of at least this many bytes are split into chunks of whole sections, which
+    // are parsed and validated on threads threads (0: one per hardware thread) and merged in
+    // file order, with exactly the result of a serial parse. Loads into a non-empty generation,
+    // such as loadFromBuffer() in place, and loads that run as a task of a WorkStealingPool,
+    // such as those of ConfigRepository::loadAll(), always parse serially.
+    void setParallelParse(size_t thresholdBytes, unsigned threads = 0) {
+        parallelParseThreshold = thresholdBytes;
+        parseThreads = threads;
+    }
+
+    static constexpr size_t kDefaultParallelParseThreshold = size_t(8) << 20;
+
+    // Snapshot mode makes the reader safe to share between threads. Readers pin an immutable
+    // generation, through snapshot() or implicitly in getValue, without taking locks. Every write
+    // builds a new generation, which is validated in full and then published with an atomic
+    // pointer swap. Enable it before sharing the reader; bind() is then only available through
+    // snapshots, and getSections() must not be used.
+    void setSnapshotMode(bool enabled);
+    bool isSnapshotMode() const { return snapshotMode.load(std::memory_order_relaxed); }
+    ConfigSnapshot snapshot() const;
+    // True if a ConfigHandle was ever bound to a value of the current generation.
+    bool hasBoundValues() const;
+    // Paths of the array files that lists of the current generation refer to, each once.
+    std::vector<std::string> getArrayFiles() const;
+
+    // Loads values from an in-memory INI document, exactly as loadConfig() does for the config file.
+    void loadFromBuffer(std::string_view buffer);
+
+    // Statistics: the time each load spends in each LoadPhase, the values it rejected or
+    // defaulted, and with readSamplePeriod > 0 the keys getValue() reads most, counted one read
+    // in readSamplePeriod on each thread. Off by default, when loads and reads pay one untaken
+    // branch; builds with the CONFIG_STATS CMake option off have no per-key hooks at all.
+    void setStatsEnabled(bool enabled, uint32_t readSamplePeriod = 0) { statsCollector.setEnabled(enabled, readSamplePeriod); }
+    ConfigStats getStats() const { return statsCollector.getStats(); }
+    // The loads recorded, with their phases and parse chunks, as Chrome trace event JSON.
+    std::string exportTrace() const { return statsCollector.exportTrace(); }
+    void resetStats() { statsCollector.reset(); }
+
     virtual std::string getConfigFilePath() const = 0;
     virtual std::vector<ConfigGen::ConfigSection> getConfigSections() const = 0;
     
-    const std::unordered_map<std::string, ConfigSection>& getSections() const { return sections; }
+    const std::pmr::deque<ConfigSection>& getSections() const { return current.load(std::memory_order_acquire)->getSections(); }
+    const ConfigGen::SchemaIndex& getSchemaIndex() const { return *schema; }
 
 protected:
     void loadConfig();
     static std::string trim(const std::string& str);
     void setValidationRules();
+    void buildSchemaIndex();
+    // Binds every generation to the schema on its first write, so that getValue(KeyId) works.
+    // Only valid for readers whose getConfigSections() declares each key once, in KeyId order.
+    void enableKeyIds() { keyIdsEnabled = true; }
     
     std::string filepath;
-    std::unordered_map<std::string, ConfigSection> sections;
+    bool arenaEnabled = true;
+    bool cacheEnabled = false;
+    bool keyIdsEnabled = false;
+    bool schemaLookupEnabled = false;
+    size_t parallelParseThreshold = kDefaultParallelParseThreshold;
+    unsigned parseThreads = 0;
+    // Replaced, never modified, by buildSchemaIndex(); generations bound to it share it
+    std::shared_ptr<const ConfigGen::SchemaIndex> schema = std::make_shared<const ConfigGen::SchemaIndex>();
 	
 private:
-    void useDefaultValue(const std::string& section, const std::string& key, const ConfigGen::ConfigItem& item);
+    class WriteScope;
+    friend class ConfigTransaction;
+    friend class LayeredConfig;
+
+    const ConfigSection& findSection(const std::string& section) const;
+    void loadConfig(ConfigGeneration& target);
+    // loadConfig() through the compiled cache, for a target that is still empty.
+    void loadConfigCached(ConfigGeneration& target);
+    // Adds what the buffer holds to target; rejected values are appended to violations.
+    // With keys, also appends the schema entry of every key the buffer holds, in file order.
+    void loadFromBuffer(ConfigGeneration& target, std::string_view buffer, std::vector<ConfigViolation>& violations,
+                        std::vector<const ConfigGen::SchemaEntry*>* keys = nullptr);
+    // The two ways loadFromBuffer() parses; both leave target, violations and keys exactly alike.
+    void parseBuffer(ConfigGeneration& target, std::string_view buffer, std::vector<ConfigViolation>& violations,
+                     std::vector<const ConfigGen::SchemaEntry*>* keys);
+    void parseParallel(ConfigGeneration& target, std::string_view buffer, unsigned threads, std::vector<ConfigViolation>& violations,
+                       std::vector<const ConfigGen::SchemaEntry*>* keys);
+    void setValidationRules(ConfigGeneration& target);
     void setValueWithValidation(const std::string& section, const std::string& key, const std::string& value);
+    void setValueWithValidation(ConfigSection& target, const ConfigGen::SchemaEntry& entry, const std::string& value);
+    void useDefaultValue(ConfigSection& target, const ConfigGen::SchemaEntry& entry);
+    // Validates and applies everything transaction staged under one write lock, or throws
+    // ConfigTransactionError and changes nothing.
+    void commitTransaction(ConfigTransaction& transaction);
+    // Publishes the values layers resolved under one write: with replace, as the reader's only
+    // values; otherwise each over the key's current value, and returns what changed.
+    ConfigChangeSet applyLayers(LayeredConfig& layers, bool replace);
+    // Gives target the rules of the current generation, including any set by hand.
+    void carryOverRules(ConfigGeneration& target);
+    // Makes next the current generation and frees retired generations no snapshot still pins.
+    // Called with writeMutex held.
+    void publish(std::unique_ptr<ConfigGeneration> next);
+    // Remembers a fingerprint of each section's text in buffer, the file just loaded.
+    void recordFingerprints(std::string_view buffer);
+    // Makes the next incremental reload parse the key's section again, and the next save write
+    // the key back. Called with writeMutex held.
+    void recordWrite(const std::string& section, const std::string& key) {
+        sectionFingerprints.erase(section);
+        unsavedKeys[section].insert(key);
+    }
+
+    // Smallest chunk worth handing to another thread
+    static constexpr size_t kMinParseChunk = 256 * 1024;
+
+    // Owned; replaced only under writeMutex, read by snapshots through hazard pointers
+    std::atomic<ConfigGeneration*> current;
+    std::vector<std::unique_ptr<ConfigGeneration>> retired;
+    mutable std::mutex writeMutex;
+    std::atomic<bool> snapshotMode{false};
+    // Hash of each section's text as of the last load of the config file; guarded by writeMutex
+    std::unordered_map<std::string, uint64_t> sectionFingerprints;
+    // Guarded by writeMutex
+    std::vector<ConfigViolation> loadViolations;
+    // Keys by section whose values the config file does not hold yet; guarded by writeMutex and
+    // cleared by every load and save
+    mutable std::unordered_map<std::string, std::unordered_set<std::string>> unsavedKeys;
+    // Counts reads from const getValue()
+    mutable StatsCollector statsCollector;
 	
 };
 
+// Reader for a schema declared at compile time, e.g.
+//   inline constexpr ConfigGen::Key<int> numSteps{"Simulation", "num_steps", "252", "Time steps per path"};
+//   inline constexpr auto simulationSchema = ConfigGen::makeSchema(numSteps, ...);
+//   class SimulationConfig : public StaticConfigReader<simulationSchema> { ... };
+//   int steps = config.get<numSteps>();
+// The schema is checked by validateConfigStructure() when the class is instantiated, and
+// get<>() of a key outside the schema, or with another type, does not compile.
+template<const auto& Keys>
+class StaticConfigReader : public ConfigReader {
+    static_assert(ConfigGen::validateConfigStructure(Keys), "Invalid configuration structure detected at compile-time");
+
+public:
+    StaticConfigReader() { enableKeyIds(); }
+
+    std::vector<ConfigGen::ConfigSection> getConfigSections() const override { return Keys.toConfigSections(); }
+
+    template<const auto& K>
+    auto get() const {
+        constexpr auto id = Keys.id(K);
+        return getValue(id);
+    }
+};
+
 void generateConfigFile(const ConfigReader& reader);
 } // namespace ConfigLib
 
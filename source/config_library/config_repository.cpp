@@ -0,0 +1,58 @@
+#include "config_repository.hpp"
+#include "config_log.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace ConfigLib {
+
+	namespace {
+		class FileConfigReader : public ConfigReader {
+		public:
+			FileConfigReader(const std::string& path, std::vector<ConfigGen::ConfigSection> sections)
+				: path(path), sections(std::move(sections)) {}
+
+			std::string getConfigFilePath() const override { return path; }
+			std::vector<ConfigGen::ConfigSection> getConfigSections() const override { return sections; }
+
+		private:
+			std::string path;
+			std::vector<ConfigGen::ConfigSection> sections;
+		};
+	}
+
+	void ConfigRepository::add(ConfigReader& reader) {
+		readers.push_back(&reader);
+	}
+
+	void ConfigRepository::add(std::unique_ptr<ConfigReader> reader) {
+		readers.push_back(reader.get());
+		owned.push_back(std::move(reader));
+	}
+
+	ConfigReader& ConfigRepository::add(const std::string& path, std::vector<ConfigGen::ConfigSection> sections) {
+		add(std::make_unique<FileConfigReader>(path, std::move(sections)));
+		return *readers.back();
+	}
+
+	std::vector<ConfigLoadResult> ConfigRepository::loadAll(unsigned threads) {
+		std::vector<ConfigLoadResult> results(readers.size());
+		WorkStealingPool pool(threads);
+		CONFIG_LOG_DEBUG("Loading " << readers.size() << " config files on " << pool.size() << " threads");
+		// Each task writes only its own result slot
+		pool.run(readers.size(), [this, &results](size_t index) {
+			ConfigReader& reader = *readers[index];
+			ConfigLoadResult& result = results[index];
+			try {
+				result.path = reader.getConfigFilePath();
+				reader.initialize();
+				result.loaded = true;
+				result.violations = reader.getLoadViolations();
+			} catch (const std::exception& e) {
+				result.error = e.what();
+			} catch (...) {
+				result.error = "Unknown exception";
+			}
+		});
+		return results;
+	}
+
+} // namespace ConfigLib
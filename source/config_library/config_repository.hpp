@@ -0,0 +1,48 @@
+#ifndef CONFIG_REPOSITORY_H
+#define CONFIG_REPOSITORY_H
+
+#include "config_reader.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ConfigLib {
+
+// Outcome of loading one reader of a ConfigRepository.
+struct ConfigLoadResult {
+    std::string path;
+    bool loaded = false;
+    std::string error;                          // what initialize() threw, if it did
+    std::vector<ConfigViolation> violations;    // values replaced by their defaults
+};
+
+// A set of independent config files, loaded together. loadAll() runs each reader's
+// initialize() on a WorkStealingPool, so reading, parsing and validating the files overlap.
+// Readers share no state, so every reader ends up exactly as a serial initialize() would
+// leave it, and the results come back in the order the readers were added whatever the
+// number of threads. Each file is then parsed on its own thread, never split further (see
+// ConfigReader::setParallelParse()).
+// Readers must not have been initialized yet, nor be used by others while loadAll() runs.
+class ConfigRepository {
+public:
+    // Not owned; the reader must outlive the repository.
+    void add(ConfigReader& reader);
+    void add(std::unique_ptr<ConfigReader> reader);
+    // A file described only by its path and schema. The schema's strings must outlive the repository.
+    ConfigReader& add(const std::string& path, std::vector<ConfigGen::ConfigSection> sections);
+
+    size_t size() const { return readers.size(); }
+    ConfigReader& get(size_t index) const { return *readers[index]; }
+
+    // Loads every reader on threads threads (0: one per hardware thread) and returns one result
+    // per reader, in the order they were added. Failures are reported, never thrown.
+    std::vector<ConfigLoadResult> loadAll(unsigned threads = 0);
+
+private:
+    std::vector<ConfigReader*> readers;
+    std::vector<std::unique_ptr<ConfigReader>> owned;
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_REPOSITORY_H
@@ -0,0 +1,234 @@
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+
+#include "value_type.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ValidationRules {
+    class Rule;
+}
+
+namespace ConfigLib {
+namespace ConfigGen {
+
+// Runtime schema, as returned by ConfigReader::getConfigSections(). Type names are decoded
+// with parseValueType(); validateConfig() reports names it does not know.
+struct ConfigItem {
+    const char* name;
+    const char* type;
+    const char* defaultValue;
+    const char* description;
+    const ValidationRules::Rule* validationRule;
+};
+
+struct ConfigSection {
+    std::string name;
+    std::vector<ConfigItem> items;
+};
+
+// Logs and returns false for unknown type names, missing names or defaults, and keys declared twice.
+bool validateConfig(const std::vector<ConfigSection>& sections);
+std::string generateConfig(const std::vector<ConfigSection>& sections);
+
+// One key of a compile-time schema, declared with its C++ type, e.g.
+//   inline constexpr ConfigGen::Key<double> volatility{"Simulation", "volatility", "0.2", "Asset price volatility"};
+// Only the four value types have a ValueTypeOf, so any other type fails to compile.
+struct KeyInfo {
+    const char* section;
+    const char* name;
+    ValueType type;
+    const char* defaultValue;
+    const char* description;
+    const ValidationRules::Rule* validationRule;
+};
+
+template<typename T>
+struct Key {
+    using value_type = T;
+
+    constexpr Key(const char* section, const char* name, const char* defaultValue, const char* description,
+                  const ValidationRules::Rule* validationRule = nullptr)
+        : info{section, name, ValueTypeOf<T>::value, defaultValue, description, validationRule} {}
+
+    KeyInfo info;
+};
+
+// Position of a key in its schema, which is also its position in the reader's key table.
+template<typename T>
+struct KeyId {
+    using value_type = T;
+    uint32_t index;
+};
+
+namespace SchemaCheck {
+
+    constexpr bool equal(const char* a, const char* b) {
+        while (*a && *a == *b) ++a, ++b;
+        return *a == *b;
+    }
+
+    constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    constexpr bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+    constexpr bool contains(const char* text, char c) {
+        for (; *text; ++text) {
+            if (*text == c) return true;
+        }
+        return false;
+    }
+
+    // Whether [begin, end) is a number NumberCodec::parseDouble accepts, blanks around it allowed
+    constexpr bool isDouble(const char* begin, const char* end) {
+        while (begin < end && isBlank(*begin)) ++begin;
+        while (end > begin && isBlank(end[-1])) --end;
+        if (begin < end && (*begin == '+' || *begin == '-')) ++begin;
+        if (end - begin == 3 && ((begin[0] == 'i' && begin[1] == 'n' && begin[2] == 'f')
+            || (begin[0] == 'n' && begin[1] == 'a' && begin[2] == 'n'))) {
+            return true;
+        }
+        size_t digits = 0;
+        while (begin < end && isDigit(*begin)) ++begin, ++digits;
+        if (begin < end && *begin == '.') {
+            ++begin;
+            while (begin < end && isDigit(*begin)) ++begin, ++digits;
+        }
+        if (digits == 0) return false;
+        if (begin < end && (*begin == 'e' || *begin == 'E')) {
+            ++begin;
+            if (begin < end && (*begin == '+' || *begin == '-')) ++begin;
+            if (begin == end || !isDigit(*begin)) return false;
+            while (begin < end && isDigit(*begin)) ++begin;
+        }
+        return begin == end;
+    }
+
+    // Stricter than the loader: digits with an optional sign and an all-zero fraction, in range
+    constexpr bool isInt(const char* text) {
+        while (isBlank(*text)) ++text;
+        const bool negative = *text == '-';
+        if (*text == '+' || *text == '-') ++text;
+        if (!isDigit(*text)) return false;
+        long long value = 0;
+        for (; isDigit(*text); ++text) {
+            value = value * 10 + (*text - '0');
+            if (value > 2147483647LL + (negative ? 1 : 0)) return false;
+        }
+        if (*text == '.') {
+            for (++text; *text == '0'; ++text) {}
+        }
+        while (isBlank(*text)) ++text;
+        return *text == '\0';
+    }
+
+    // Comma-separated doubles; empty elements are skipped, as NumberCodec::parseDoubleList does
+    constexpr bool isDoubleList(const char* text) {
+        const char* element = text;
+        for (const char* p = text;; ++p) {
+            if (*p == ',' || *p == '\0') {
+                const char* begin = element;
+                while (begin < p && isBlank(*begin)) ++begin;
+                if (begin != p && !isDouble(begin, p)) return false;
+                if (*p == '\0') return true;
+                element = p + 1;
+            }
+        }
+    }
+
+    constexpr const char* end(const char* text) {
+        while (*text) ++text;
+        return text;
+    }
+
+    constexpr bool isValidDefault(const KeyInfo& key) {
+        switch (key.type) {
+            case ValueType::Int: return isInt(key.defaultValue);
+            case ValueType::Double: return isDouble(key.defaultValue, end(key.defaultValue));
+            case ValueType::DoubleVector: return isDoubleList(key.defaultValue);
+            case ValueType::String: break;
+        }
+        return !contains(key.defaultValue, '\n') && !contains(key.defaultValue, '#');
+    }
+
+    // Names the loader can find again: not empty, on one line, free of INI delimiters
+    constexpr bool isValidName(const char* name, const char* delimiters) {
+        if (!name || !*name || isBlank(*name) || isBlank(end(name)[-1])) return false;
+        for (const char* d = delimiters; *d; ++d) {
+            if (contains(name, *d)) return false;
+        }
+        return !contains(name, '\n') && !contains(name, '\r');
+    }
+
+} // namespace SchemaCheck
+
+template<size_t N>
+class Schema {
+public:
+    constexpr explicit Schema(const std::array<KeyInfo, N>& keys) : keys(keys) {}
+
+    static constexpr size_t size() { return N; }
+    constexpr const KeyInfo& operator[](size_t index) const { return keys[index]; }
+
+    // In a constant expression, a key that is not part of the schema fails to compile.
+    template<typename T>
+    constexpr KeyId<T> id(const Key<T>& key) const {
+        for (size_t i = 0; i < N; ++i) {
+            if (SchemaCheck::equal(keys[i].section, key.info.section) && SchemaCheck::equal(keys[i].name, key.info.name)) {
+                if (keys[i].type != key.info.type) throw std::logic_error("Key is declared in the schema with another type");
+                return KeyId<T>{static_cast<uint32_t>(i)};
+            }
+        }
+        throw std::logic_error("Key is not part of the schema");
+    }
+
+    // The same schema in runtime form. Sections appear in declaration order, so the ConfigReader
+    // schema index numbers keys exactly as id() does.
+    std::vector<ConfigSection> toConfigSections() const {
+        std::vector<ConfigSection> sections;
+        for (const auto& key : keys) {
+            if (sections.empty() || sections.back().name != key.section) sections.push_back({key.section, {}});
+            sections.back().items.push_back({key.name, valueTypeName(key.type), key.defaultValue, key.description,
+                key.validationRule});
+        }
+        return sections;
+    }
+
+private:
+    std::array<KeyInfo, N> keys;
+};
+
+template<typename... Ts>
+constexpr Schema<sizeof...(Ts)> makeSchema(const Key<Ts>&... keys) {
+    return Schema<sizeof...(Ts)>(std::array<KeyInfo, sizeof...(Ts)>{keys.info...});
+}
+
+// Compile-time checks of a schema, for use in a static_assert. A failing check does not
+// compile, and the diagnostic points at the throw naming the problem.
+template<size_t N>
+constexpr bool validateConfigStructure(const Schema<N>& schema) {
+    for (size_t i = 0; i < N; ++i) {
+        const KeyInfo& key = schema[i];
+        if (!SchemaCheck::isValidName(key.section, "[]")) throw std::logic_error("Invalid section name");
+        if (!SchemaCheck::isValidName(key.name, "=#[")) throw std::logic_error("Invalid key name");
+        if (!key.defaultValue || !key.description) throw std::logic_error("Missing default value or description");
+        if (!SchemaCheck::isValidDefault(key)) throw std::logic_error("Default value does not parse as the key's type");
+        for (size_t j = 0; j < i; ++j) {
+            const bool sameSection = SchemaCheck::equal(schema[j].section, key.section);
+            if (sameSection && SchemaCheck::equal(schema[j].name, key.name)) throw std::logic_error("Key declared twice");
+            // generateConfig() writes a [Section] block per run of keys, so a section must be one run
+            if (sameSection && j + 1 < i && !SchemaCheck::equal(schema[i - 1].section, key.section)) {
+                throw std::logic_error("Keys of a section must be declared together");
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace ConfigGen
+} // namespace ConfigLib
+
+#endif // CONFIG_SCHEMA_H
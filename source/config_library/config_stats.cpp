@@ -0,0 +1,214 @@
+#include "config_stats.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace ConfigLib {
+
+	namespace {
+		std::atomic<uint64_t> nextCollectorId(1);
+		std::atomic<uint32_t> nextThreadIndex(1);
+
+		// Small, stable ids for the tid field of trace events
+		uint32_t threadIndex() {
+			static thread_local const uint32_t index = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+			return index;
+		}
+
+		void appendMilliseconds(std::string& json, const char* name, uint64_t nanoseconds) {
+			char number[64];
+			std::snprintf(number, sizeof(number), "\"%s\": %.3f", name, nanoseconds / 1e6);
+			json += number;
+		}
+
+		void appendCount(std::string& json, const char* name, uint64_t count) {
+			json += "\"";
+			json += name;
+			json += "\": " + std::to_string(count);
+		}
+	}
+
+	const char* loadPhaseName(LoadPhase phase) {
+		switch (phase) {
+			case LoadPhase::Schema: return "schema";
+			case LoadPhase::FileIO: return "file io";
+			case LoadPhase::Tokenize: return "tokenize";
+			case LoadPhase::NumberParse: return "number parse";
+			case LoadPhase::Validation: return "validation";
+			case LoadPhase::Store: return "store";
+			case LoadPhase::Defaults: return "defaults";
+			case LoadPhase::Finish: return "finish";
+			case LoadPhase::Count: break;
+		}
+		return "unknown";
+	}
+
+	uint64_t ConfigStats::totalNanoseconds() const {
+		uint64_t total = 0;
+		for (uint64_t nanoseconds : phaseNanoseconds) total += nanoseconds;
+		return total;
+	}
+
+	const std::chrono::steady_clock::time_point LoadProfile::epoch = std::chrono::steady_clock::now();
+
+	StatsCollector::StatsCollector() : id(nextCollectorId.fetch_add(1, std::memory_order_relaxed)) {}
+
+	StatsCollector::~StatsCollector() = default;
+
+	void StatsCollector::setEnabled(bool enabled, uint32_t readSamplePeriod) {
+		this->readSamplePeriod.store(enabled ? readSamplePeriod : 0, std::memory_order_relaxed);
+		this->enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void StatsCollector::recordRead(std::string_view section, std::string_view key, uint32_t period) {
+		// The table of the collector this thread sampled for last, and a buffer for the map key
+		struct Cache {
+			uint64_t owner = 0;
+			std::shared_ptr<ReadTable> table;
+			std::string name;
+		};
+		static thread_local Cache cache;
+
+		if (cache.owner != id) {
+			std::lock_guard<std::mutex> lock(mutex);
+			std::shared_ptr<ReadTable>& table = readTables[std::this_thread::get_id()];
+			if (!table) table = std::make_shared<ReadTable>();
+			cache.table = table;
+			cache.owner = id;
+		}
+		cache.name.assign(section.data(), section.size());
+		cache.name += '\0';
+		cache.name.append(key.data(), key.size());
+
+		std::lock_guard<std::mutex> lock(cache.table->mutex);
+		cache.table->counts[cache.name] += period;
+	}
+
+	void StatsCollector::addLoad(const LoadProfile& profile) {
+		std::lock_guard<std::mutex> lock(mutex);
+		++totals.loads;
+		for (size_t phase = 0; phase < kLoadPhaseCount; ++phase) {
+			totals.phaseNanoseconds[phase] += profile.nanoseconds[phase] + profile.helpers.nanoseconds[phase];
+		}
+		totals.parseErrors += profile.parseErrors + profile.helpers.parseErrors;
+		totals.validationFailures += profile.validationFailures + profile.helpers.validationFailures;
+		totals.defaultedKeys += profile.defaultedKeys + profile.helpers.defaultedKeys;
+
+		for (const auto* from : { &profile.spans, &profile.helpers.spans }) {
+			for (const auto& span : *from) {
+				if (spans.size() == kMaxSpans) return;
+				spans.push_back(span);
+			}
+		}
+	}
+
+	ConfigStats StatsCollector::getStats() const {
+		ConfigStats stats;
+		std::unordered_map<std::string, uint64_t> reads;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stats = totals;
+			for (const auto& table : readTables) {
+				std::lock_guard<std::mutex> tableLock(table.second->mutex);
+				for (const auto& count : table.second->counts) reads[count.first] += count.second;
+			}
+		}
+		stats.readSamplePeriod = readSamplePeriod.load(std::memory_order_relaxed);
+
+		stats.keyReads.reserve(reads.size());
+		for (const auto& count : reads) {
+			const size_t separator = count.first.find('\0');
+			stats.keyReads.push_back({count.first.substr(0, separator), count.first.substr(separator + 1), count.second});
+		}
+		std::sort(stats.keyReads.begin(), stats.keyReads.end(), [](const KeyReadCount& a, const KeyReadCount& b) {
+			if (a.reads != b.reads) return a.reads > b.reads;
+			return a.section != b.section ? a.section < b.section : a.key < b.key;
+		});
+		return stats;
+	}
+
+	std::string StatsCollector::exportTrace() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		std::string json = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+		char event[256];
+		for (size_t i = 0; i < spans.size(); ++i) {
+			const Span& span = spans[i];
+			// Timestamps are in microseconds
+			std::snprintf(event, sizeof(event),
+				"%s\n  {\"name\": \"%s\", \"cat\": \"config\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+				i == 0 ? "" : ",", span.name, span.thread, span.start / 1e3, span.duration / 1e3);
+			json += event;
+			if (!span.args.empty()) json += ", \"args\": {" + span.args + "}";
+			json += "}";
+		}
+		json += "\n]}\n";
+		return json;
+	}
+
+	void StatsCollector::reset() {
+		std::lock_guard<std::mutex> lock(mutex);
+		totals = ConfigStats();
+		spans.clear();
+		for (const auto& table : readTables) {
+			std::lock_guard<std::mutex> tableLock(table.second->mutex);
+			table.second->counts.clear();
+		}
+	}
+
+	LoadProfile::LoadProfile(StatsCollector& collector, const char* name, LoadPhase phase) : collector(&collector), name(name) {
+		if (!collector.isEnabled() || currentProfile) return;
+		active = true;
+		currentProfile = this;
+		start = since = now();
+		phaseNow = phase;
+	}
+
+	LoadProfile::LoadProfile(LoadProfile* parent, const char* name, LoadPhase phase) : parent(parent), name(name) {
+		if (!CONFIG_STATS_ENABLED || !parent) return;
+		active = true;
+		collector = parent->collector;
+		// A load whose thread helps with its own work does not also charge that time to itself
+		suspended = currentProfile;
+		if (suspended) suspended->enter(suspended->phaseNow);
+		currentProfile = this;
+		start = since = now();
+		phaseNow = phase;
+	}
+
+	void LoadProfile::addSpan(const char* name, uint64_t start, uint64_t end) {
+		spans.push_back({name, threadIndex(), start, end - start, std::string()});
+	}
+
+	void LoadProfile::finish() {
+		enter(phaseNow);
+		const uint64_t end = since;
+		currentProfile = suspended;
+		if (suspended) suspended->since = end;
+
+		if (parent) {
+			addSpan(name, start, end);
+			std::lock_guard<std::mutex> lock(parent->helpersMutex);
+			for (size_t phase = 0; phase < kLoadPhaseCount; ++phase) parent->helpers.nanoseconds[phase] += nanoseconds[phase];
+			parent->helpers.parseErrors += parseErrors;
+			parent->helpers.validationFailures += validationFailures;
+			parent->helpers.defaultedKeys += defaultedKeys;
+			parent->helpers.spans.insert(parent->helpers.spans.end(), spans.begin(), spans.end());
+			return;
+		}
+
+		// The load's own event carries its totals
+		std::string args;
+		for (size_t phase = 0; phase < kLoadPhaseCount; ++phase) {
+			appendMilliseconds(args, (std::string(loadPhaseName(static_cast<LoadPhase>(phase))) + " ms").c_str(),
+				nanoseconds[phase] + helpers.nanoseconds[phase]);
+			args += ", ";
+		}
+		appendCount(args, "parse errors", parseErrors + helpers.parseErrors);
+		args += ", ";
+		appendCount(args, "validation failures", validationFailures + helpers.validationFailures);
+		args += ", ";
+		appendCount(args, "defaulted keys", defaultedKeys + helpers.defaultedKeys);
+		spans.insert(spans.begin(), {name, threadIndex(), start, end - start, std::move(args)});
+		collector->addLoad(*this);
+	}
+
+} // namespace ConfigLib
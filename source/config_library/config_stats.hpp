@@ -0,0 +1,258 @@
+#ifndef CONFIG_STATS_H
+#define CONFIG_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Whether load timing and read counting are compiled into the library. Set through the
+// CONFIG_STATS CMake option; without it the hooks run per key and per read compile to nothing.
+#ifndef CONFIG_STATS_ENABLED
+#define CONFIG_STATS_ENABLED 1
+#endif
+
+namespace ConfigLib {
+
+// Where the time of a load goes. Phases are exclusive: time spent in a nested phase, such as
+// the validation of a value while tokenizing, is not also charged to the enclosing one.
+enum class LoadPhase {
+    Schema,        // building the schema index from getConfigSections()
+    FileIO,        // opening and mapping the file, fingerprinting its sections, the compiled cache;
+                   // pages of a mapped file are read in as the tokenizer first touches them
+    Tokenize,      // splitting lines into headers and keys, and finding keys in the schema
+    NumberParse,   // converting value text to numbers
+    Validation,    // evaluating rules
+    Store,         // storing values, and merging the chunks of a parallel parse
+    Defaults,      // replacing rejected values by their defaults
+    Finish,        // binding rules and publishing the new generation
+    Count
+};
+
+constexpr size_t kLoadPhaseCount = static_cast<size_t>(LoadPhase::Count);
+
+const char* loadPhaseName(LoadPhase phase);
+
+struct KeyReadCount {
+    std::string section;
+    std::string key;
+    uint64_t reads;     // estimated: sampled reads times the sampling period
+};
+
+// What a ConfigReader recorded since its statistics were enabled or last reset.
+struct ConfigStats {
+    uint64_t loads = 0;                 // initialize(), loadConfig(), reload(), reloadIncremental(), loadFromBuffer()
+    // Summed over the threads of each load, so a parallel parse can exceed the wall time
+    uint64_t phaseNanoseconds[kLoadPhaseCount] = {};
+    uint64_t parseErrors = 0;           // malformed lines, and values that are not numbers
+    uint64_t validationFailures = 0;    // values a rule rejected
+    uint64_t defaultedKeys = 0;         // values replaced by their default
+    uint32_t readSamplePeriod = 0;      // 0 if reads were not counted
+    std::vector<KeyReadCount> keyReads; // most read first
+
+    uint64_t totalNanoseconds() const;
+};
+
+class LoadProfile;
+
+// The statistics of one ConfigReader. Loads report to it through LoadProfile, reads through
+// countRead(). Disabled, it costs one untaken branch per load and per read.
+class StatsCollector {
+public:
+    StatsCollector();
+    ~StatsCollector();
+
+    StatsCollector(const StatsCollector&) = delete;
+    StatsCollector& operator=(const StatsCollector&) = delete;
+
+    void setEnabled(bool enabled, uint32_t readSamplePeriod);
+    bool isEnabled() const { return CONFIG_STATS_ENABLED && enabled.load(std::memory_order_relaxed); }
+
+    // Counts one read in every readSamplePeriod on each thread. Between samples this is a
+    // decrement of a thread-local counter.
+    bool isCountingReads() const {
+        return CONFIG_STATS_ENABLED && readSamplePeriod.load(std::memory_order_relaxed) != 0;
+    }
+    void countRead(std::string_view section, std::string_view key) {
+#if CONFIG_STATS_ENABLED
+        const uint32_t period = readSamplePeriod.load(std::memory_order_relaxed);
+        if (period == 0) return;
+        if (readCountdown > 1) {
+            --readCountdown;
+            return;
+        }
+        readCountdown = period;
+        recordRead(section, key, period);
+#else
+        (void)section;
+        (void)key;
+#endif
+    }
+
+    ConfigStats getStats() const;
+    // The loads recorded, one complete event per load, phase and parse chunk, in the Chrome
+    // trace event format (chrome://tracing, Perfetto).
+    std::string exportTrace() const;
+    void reset();
+
+private:
+    friend class LoadProfile;
+
+    struct Span {
+        const char* name;
+        uint32_t thread;
+        uint64_t start;         // ns since process start
+        uint64_t duration;
+        std::string args;       // JSON object members, or empty
+    };
+    // Sampled reads of one thread, keyed by section and key separated by '\0'
+    struct ReadTable {
+        std::mutex mutex;
+        std::unordered_map<std::string, uint64_t> counts;
+    };
+
+    void recordRead(std::string_view section, std::string_view key, uint32_t period);
+    void addLoad(const LoadProfile& profile);
+
+    // Spans beyond this many are dropped, so that a long-running process stays bounded
+    static constexpr size_t kMaxSpans = 100000;
+    static inline thread_local uint32_t readCountdown = 0;
+
+    std::atomic<bool> enabled{false};
+    std::atomic<uint32_t> readSamplePeriod{0};
+    const uint64_t id;          // tells collectors apart in thread-local caches
+    mutable std::mutex mutex;
+    ConfigStats totals;         // without keyReads
+    std::vector<Span> spans;
+    std::unordered_map<std::thread::id, std::shared_ptr<ReadTable>> readTables;
+};
+
+// The time and counts of one load on one thread. The outermost profile of a thread is the
+// load: it is inactive when the collector is disabled, and reports to the collector when
+// destroyed. A profile made for a worker thread reports to the profile of the load it helps.
+// Loads find the active profile of their thread through current().
+class LoadProfile {
+public:
+    // Inactive if the collector is disabled or another load is already profiled on this thread.
+    // Time is charged to phase until the load enters another.
+    LoadProfile(StatsCollector& collector, const char* name, LoadPhase phase);
+    // Part of parent's load on the calling thread; inactive if parent is null.
+    LoadProfile(LoadProfile* parent, const char* name, LoadPhase phase);
+    ~LoadProfile() {
+        if (active) finish();
+    }
+
+    LoadProfile(const LoadProfile&) = delete;
+    LoadProfile& operator=(const LoadProfile&) = delete;
+
+    static LoadProfile* current() {
+#if CONFIG_STATS_ENABLED
+        return currentProfile;
+#else
+        return nullptr;
+#endif
+    }
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    // Charges the time since the last switch to the current phase and makes phase current;
+    // returns the phase that was current.
+    LoadPhase enter(LoadPhase phase) {
+        const LoadPhase previous = phaseNow;
+        const uint64_t time = now();
+        nanoseconds[static_cast<size_t>(previous)] += time - since;
+        since = time;
+        phaseNow = phase;
+        return previous;
+    }
+
+    void countParseError() { ++parseErrors; }
+    void countValidationFailure() { ++validationFailures; }
+    void countDefault() { ++defaultedKeys; }
+    void addSpan(const char* name, uint64_t start, uint64_t end);
+
+private:
+    friend class StatsCollector;
+
+    void finish();
+
+    static inline thread_local LoadProfile* currentProfile = nullptr;
+    static const std::chrono::steady_clock::time_point epoch;
+
+    bool active = false;
+    StatsCollector* collector = nullptr;
+    LoadProfile* parent = nullptr;
+    LoadProfile* suspended = nullptr;    // the thread's profile before this one
+    const char* name;
+    uint64_t start = 0;
+    uint64_t since = 0;
+    LoadPhase phaseNow = LoadPhase::Finish;
+    uint64_t nanoseconds[kLoadPhaseCount] = {};
+    uint64_t parseErrors = 0;
+    uint64_t validationFailures = 0;
+    uint64_t defaultedKeys = 0;
+    std::vector<StatsCollector::Span> spans;
+
+    // What worker profiles added, kept apart from the fields the owning thread updates unlocked
+    struct Helpers {
+        uint64_t nanoseconds[kLoadPhaseCount] = {};
+        uint64_t parseErrors = 0;
+        uint64_t validationFailures = 0;
+        uint64_t defaultedKeys = 0;
+        std::vector<StatsCollector::Span> spans;
+    };
+    std::mutex helpersMutex;
+    Helpers helpers;
+};
+
+// Makes phase current for the scope; does nothing without an active profile.
+class PhaseScope {
+public:
+    PhaseScope(LoadProfile* profile, LoadPhase phase) : profile(profile) {
+        if (profile) previous = profile->enter(phase);
+    }
+    ~PhaseScope() {
+        if (profile) profile->enter(previous);
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    LoadProfile* profile;
+    LoadPhase previous = LoadPhase::Finish;
+};
+
+// Like PhaseScope, and also records the scope as a span of the timeline.
+class SpanScope {
+public:
+    SpanScope(LoadProfile* profile, const char* name, LoadPhase phase) : phase(profile, phase), profile(profile), name(name) {
+        if (profile) start = LoadProfile::now();
+    }
+    ~SpanScope() {
+        if (profile) profile->addSpan(name, start, LoadProfile::now());
+    }
+
+    SpanScope(const SpanScope&) = delete;
+    SpanScope& operator=(const SpanScope&) = delete;
+
+private:
+    PhaseScope phase;
+    LoadProfile* profile;
+    const char* name;
+    uint64_t start = 0;
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_STATS_H
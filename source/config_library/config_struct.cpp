@@ -0,0 +1,90 @@
+#include "config_struct.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ConfigLib {
+	namespace ConfigGen {
+
+		namespace {
+			void copyOut(int value, int& out) { out = value; }
+			void copyOut(double value, double& out) { out = value; }
+			void copyOut(const std::pmr::string& value, std::string& out) { out.assign(value.data(), value.size()); }
+			void copyOut(const DoubleList& value, std::vector<double>& out) { out.assign(value.begin(), value.end()); }
+		}
+
+		const ConfigEntry* StructLoader::findEntry(const FieldInfo& field) {
+			if (!section || sectionName != field.section) {
+				sectionName = field.section;
+				section = snapshot.getGeneration().findSection(sectionName);
+			}
+			return section ? section->findEntry(field.key) : nullptr;
+		}
+
+		template<typename T>
+		void StructLoader::read(const FieldInfo& field, T& out) {
+			const ConfigEntry* entry = findEntry(field);
+			if (!entry || entry->value.empty()) return;
+			if constexpr (std::is_same_v<T, std::vector<double>>) {
+				// External arrays are copied out as they are; rules do not apply to them
+				if (entry->value.isExternal()) {
+					try {
+						const DoubleSpan values = entry->value.getArray();
+						out.assign(values.begin(), values.end());
+					} catch (const std::runtime_error& e) {
+						errors.push_back(std::string(field.section) + "." + field.key + ": " + e.what());
+					}
+					return;
+				}
+			}
+			const StoredType<T>* value = entry->value.get<T>();
+			if (!value) {
+				errors.push_back(std::string(field.section) + "." + field.key + " does not hold a " + valueTypeName(field.type));
+				return;
+			}
+			if (!entry->value.satisfies(entry->check)) {
+				errors.push_back(std::string(field.section) + "." + field.key + ": " + entry->check.rule->toString());
+				return;
+			}
+			copyOut(*value, out);
+		}
+
+		void StructLoader::finish() const {
+			if (errors.empty()) return;
+			std::string message = "Unable to load config struct:";
+			for (const auto& error : errors) message += "\n  " + error;
+			throw std::runtime_error(message);
+		}
+
+		template<typename T>
+		void StructSaver::write(const FieldInfo& field, const T& value) {
+			if constexpr (std::is_same_v<T, std::vector<double>>) {
+				const ConfigSnapshot pinned = reader.snapshot();
+				const StoredValue* stored = pinned.getGeneration().findValue(field.section, field.key);
+				if (stored && stored->isExternal()) {
+					// Compared bit for bit, so that NaNs read back from the file count as unchanged
+					try {
+						const DoubleSpan values = stored->getArray();
+						if (values.size() == value.size()
+							&& (value.empty() || std::memcmp(values.data(), value.data(), value.size() * sizeof(double)) == 0)) {
+							return;
+						}
+					} catch (const std::runtime_error&) {
+						// An unreadable array file is replaced by the member's values
+					}
+				}
+			}
+			reader.setValue(field.section, field.key, value);
+		}
+
+		template void StructLoader::read<int>(const FieldInfo&, int&);
+		template void StructLoader::read<double>(const FieldInfo&, double&);
+		template void StructLoader::read<std::string>(const FieldInfo&, std::string&);
+		template void StructLoader::read<std::vector<double>>(const FieldInfo&, std::vector<double>&);
+		template void StructSaver::write<int>(const FieldInfo&, const int&);
+		template void StructSaver::write<double>(const FieldInfo&, const double&);
+		template void StructSaver::write<std::string>(const FieldInfo&, const std::string&);
+		template void StructSaver::write<std::vector<double>>(const FieldInfo&, const std::vector<double>&);
+
+	}
+} // namespace ConfigLib
@@ -0,0 +1,64 @@
+#ifndef CONFIG_STRUCT_H
+#define CONFIG_STRUCT_H
+
+#include "config_reader.hpp"
+#include "value_type.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ConfigLib {
+namespace ConfigGen {
+
+// Reflection record of one member of a struct generated by config_generate_struct().
+struct FieldInfo {
+    const char* section;
+    const char* key;
+    ValueType type;
+    const char* defaultValue;
+    const char* description;
+};
+
+// Fills generated structs from a reader. Every read comes from the one generation pinned at
+// construction, so a struct never mixes values from before and after a concurrent write.
+// Fields are expected grouped by section, which the generator guarantees, so each section is
+// looked up once. A key without a value keeps the struct's default; a value of another type or
+// one that fails its validation rule is recorded and reported by finish().
+class StructLoader {
+public:
+    explicit StructLoader(const ConfigReader& reader) : snapshot(reader.snapshot()) {}
+
+    template<typename T>
+    void read(const FieldInfo& field, T& out);
+
+    // Throws std::runtime_error listing every field that could not be read.
+    void finish() const;
+
+private:
+    const ConfigEntry* findEntry(const FieldInfo& field);
+
+    ConfigSnapshot snapshot;
+    std::string_view sectionName;
+    const ConfigLib::ConfigSection* section = nullptr;
+    std::vector<std::string> errors;
+};
+
+// Writes generated structs back through ConfigReader::setValue(), which applies the validation
+// rules. A list stored as a reference to an ExternalArray is left alone while the array still
+// holds the member's values, so that a load and save round trip keeps the "@path" reference
+// instead of writing the whole array into the config file.
+class StructSaver {
+public:
+    explicit StructSaver(ConfigReader& reader) : reader(reader) {}
+
+    template<typename T>
+    void write(const FieldInfo& field, const T& value);
+
+private:
+    ConfigReader& reader;
+};
+
+} // namespace ConfigGen
+} // namespace ConfigLib
+
+#endif // CONFIG_STRUCT_H
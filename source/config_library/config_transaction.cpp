@@ -0,0 +1,117 @@
+#include "config_transaction.hpp"
+#include "hash_bytes.hpp"
+#include <type_traits>
+
+namespace ConfigLib {
+
+	namespace {
+		std::string describeFailures(const std::vector<ConfigViolation>& violations) {
+			std::string message = "Transaction rejected: " + std::to_string(violations.size()) + " failed checks";
+			if (!violations.empty()) {
+				const ConfigViolation& first = violations.front();
+				message += first.key.empty() ? ", first: " + first.reason
+					: ", first: " + first.section + "." + first.key + " (" + first.reason + ")";
+			}
+			return message;
+		}
+	}
+
+	ConfigTransactionError::ConfigTransactionError(std::vector<ConfigViolation> violations)
+		: std::runtime_error(describeFailures(violations)), violations(std::move(violations)) {}
+
+	size_t ConfigTransaction::KeyRefHash::operator()(const KeyRef& key) const {
+		return static_cast<size_t>((hashBytes(key.first) * 0x9e3779b97f4a7c15ull) ^ hashBytes(key.second));
+	}
+
+	ConfigTransaction::Staged& ConfigTransaction::stage(const std::string& section, const std::string& key) {
+		const auto found = positions.find(KeyRef(section, key));
+		if (found != positions.end()) return staged[found->second];
+		staged.push_back({section, key, StoredValue(), false});
+		Staged& added = staged.back();
+		positions.emplace(KeyRef(added.section, added.key), staged.size() - 1);
+		return added;
+	}
+
+	const ConfigTransaction::Staged* ConfigTransaction::findStaged(std::string_view section, std::string_view key) const {
+		const auto found = positions.find(KeyRef(section, key));
+		return found != positions.end() ? &staged[found->second] : nullptr;
+	}
+
+	ConfigTransaction& ConfigTransaction::set(const std::string& section, const std::string& key, int value) {
+		Staged& entry = stage(section, key);
+		entry.value.set(value, std::pmr::new_delete_resource());
+		entry.text = false;
+		return *this;
+	}
+
+	ConfigTransaction& ConfigTransaction::set(const std::string& section, const std::string& key, double value) {
+		Staged& entry = stage(section, key);
+		entry.value.set(value, std::pmr::new_delete_resource());
+		entry.text = false;
+		return *this;
+	}
+
+	ConfigTransaction& ConfigTransaction::set(const std::string& section, const std::string& key, const std::string& value) {
+		Staged& entry = stage(section, key);
+		entry.value.set(std::string_view(value), std::pmr::new_delete_resource());
+		entry.text = true;
+		return *this;
+	}
+
+	ConfigTransaction& ConfigTransaction::set(const std::string& section, const std::string& key, const std::vector<double>& value) {
+		Staged& entry = stage(section, key);
+		entry.value.set(value, std::pmr::new_delete_resource());
+		entry.text = false;
+		return *this;
+	}
+
+	ConfigTransaction& ConfigTransaction::require(std::string description, std::function<bool(const View&)> check) {
+		requirements.push_back({std::move(description), std::move(check)});
+		return *this;
+	}
+
+	void ConfigTransaction::commit() {
+		// Emptied even when the commit fails, so that a rejected batch is never applied later
+		struct Reset {
+			ConfigTransaction& transaction;
+			~Reset() { transaction.rollback(); }
+		} reset{*this};
+		reader->commitTransaction(*this);
+	}
+
+	void ConfigTransaction::rollback() {
+		staged.clear();
+		requirements.clear();
+		positions.clear();
+	}
+
+	const StoredValue* ConfigTransaction::View::findValue(std::string_view section, std::string_view key) const {
+		if (const Staged* entry = transaction.findStaged(section, key)) return &entry->value;
+		return generation.findValue(section, key);
+	}
+
+	template<typename T>
+	T ConfigTransaction::View::getValue(const std::string& section, const std::string& key) const {
+		const StoredValue* value = findValue(section, key);
+		if constexpr (std::is_same_v<T, std::vector<double>>) {
+			// Read as ConfigReader::getValue() reads it, so checks see the array file's values
+			if (value && value->isExternal()) {
+				const DoubleSpan values = value->getArray();
+				return T(values.begin(), values.end());
+			}
+		}
+		const StoredType<T>* typed = value ? value->get<T>() : nullptr;
+		if (!typed) throw std::runtime_error("Key not found or type mismatch: " + section + "." + key);
+		if constexpr (std::is_arithmetic_v<T>) {
+			return *typed;
+		} else {
+			return T(typed->begin(), typed->end());
+		}
+	}
+
+	template int ConfigTransaction::View::getValue<int>(const std::string&, const std::string&) const;
+	template double ConfigTransaction::View::getValue<double>(const std::string&, const std::string&) const;
+	template std::string ConfigTransaction::View::getValue<std::string>(const std::string&, const std::string&) const;
+	template std::vector<double> ConfigTransaction::View::getValue<std::vector<double>>(const std::string&, const std::string&) const;
+
+} // namespace ConfigLib
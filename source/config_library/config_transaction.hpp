@@ -0,0 +1,116 @@
+#ifndef CONFIG_TRANSACTION_H
+#define CONFIG_TRANSACTION_H
+
+#include "config_reader.hpp"
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ConfigLib {
+
+// Thrown by ConfigTransaction::commit() when a staged value or a check fails. Nothing of the
+// transaction was applied. Failed cross-key checks have no section or key.
+class ConfigTransactionError : public std::runtime_error {
+public:
+    explicit ConfigTransactionError(std::vector<ConfigViolation> violations);
+
+    const std::vector<ConfigViolation>& getViolations() const { return violations; }
+
+private:
+    std::vector<ConfigViolation> violations;
+};
+
+// A batch of writes to one reader, applied all or nothing, e.g.
+//   ConfigTransaction transaction = reader.begin();
+//   transaction.set("Optimizer", "lower", 0.1).set("Optimizer", "upper", 0.9);
+//   transaction.require("lower below upper", [](const ConfigTransaction::View& view) {
+//       return view.getValue<double>("Optimizer", "lower") < view.getValue<double>("Optimizer", "upper");
+//   });
+//   transaction.commit();
+// Staging changes nothing. commit() takes the reader's write lock once. It first checks every
+// staged value against its key's declared type and rule. It then runs the cross-key checks on
+// the values the batch would leave. Only if all of them pass are the values applied. In
+// snapshot mode they are published as one new generation, so readers see none of them or all
+// of them.
+class ConfigTransaction {
+public:
+    // The reader's values as commit() would leave them: staged values over current ones.
+    class View {
+    public:
+        // A list held in an array file is read from it. Throws std::runtime_error if the key has
+        // no value of type T or its array file cannot be read.
+        template<typename T>
+        T getValue(const std::string& section, const std::string& key) const;
+        // The value, or null if the key has none.
+        const StoredValue* findValue(std::string_view section, std::string_view key) const;
+
+    private:
+        friend class ConfigReader;
+        View(const ConfigTransaction& transaction, const ConfigGeneration& generation)
+            : transaction(transaction), generation(generation) {}
+
+        const ConfigTransaction& transaction;
+        const ConfigGeneration& generation;
+    };
+
+    explicit ConfigTransaction(ConfigReader& reader) : reader(&reader) {}
+
+    // Staging a key again replaces what was staged for it. A string is parsed as the key's type,
+    // as ConfigReader::setValue() does.
+    ConfigTransaction& set(const std::string& section, const std::string& key, int value);
+    ConfigTransaction& set(const std::string& section, const std::string& key, double value);
+    ConfigTransaction& set(const std::string& section, const std::string& key, const std::string& value);
+    ConfigTransaction& set(const std::string& section, const std::string& key, const std::vector<double>& value);
+
+    // A check across keys. It runs at commit, after every staged value has passed its own
+    // checks. A check that returns false or throws fails the transaction.
+    ConfigTransaction& require(std::string description, std::function<bool(const View&)> check);
+
+    size_t size() const { return staged.size(); }
+    bool empty() const { return staged.empty(); }
+
+    // Applies everything staged, or nothing: throws ConfigTransactionError listing every
+    // failure. Either way the transaction is empty afterwards and can be reused.
+    void commit();
+    // Drops everything staged and every check.
+    void rollback();
+
+private:
+    friend class ConfigReader;
+
+    struct Staged {
+        std::string section;
+        std::string key;
+        StoredValue value;
+        bool text;             // a string still to be parsed as the key's type
+    };
+
+    struct Requirement {
+        std::string description;
+        std::function<bool(const View&)> check;
+    };
+
+    // Section and key, viewing the strings of a staged entry
+    using KeyRef = std::pair<std::string_view, std::string_view>;
+    struct KeyRefHash {
+        size_t operator()(const KeyRef& key) const;
+    };
+
+    Staged& stage(const std::string& section, const std::string& key);
+    const Staged* findStaged(std::string_view section, std::string_view key) const;
+
+    ConfigReader* reader;
+    // A deque never moves its elements, so the views in positions stay valid
+    std::deque<Staged> staged;
+    std::vector<Requirement> requirements;
+    std::unordered_map<KeyRef, size_t, KeyRefHash> positions;
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_TRANSACTION_H
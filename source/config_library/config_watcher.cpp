@@ -0,0 +1,234 @@
+#include "config_watcher.hpp"
+#include "config_reader.hpp"
+#include "config_log.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ConfigLib {
+
+	namespace {
+		void splitPath(const std::string& path, std::string& directory, std::string& name) {
+			const size_t slash = path.find_last_of('/');
+			directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+			name = slash == std::string::npos ? path : path.substr(slash + 1);
+		}
+	}
+
+	ConfigWatcher::ConfigWatcher(ConfigReader& reader, std::chrono::milliseconds debounce)
+		: reader(reader), debounce(debounce) {
+		splitPath(reader.getConfigFilePath(), directory, filename);
+	}
+
+	ConfigWatcher::~ConfigWatcher() {
+		stop();
+	}
+
+#ifdef __linux__
+	void ConfigWatcher::start() {
+		if (isRunning()) return;
+		// Reloads on another thread are only safe for readers that are read through snapshots
+		if (!reader.isSnapshotMode()) {
+			throw std::logic_error("ConfigWatcher requires a reader in snapshot mode");
+		}
+		if (reader.hasBoundValues()) {
+			throw std::logic_error("ConfigWatcher cannot reload a reader with bound handles");
+		}
+
+		inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyFd < 0) {
+			throw std::runtime_error(std::string("inotify_init1 failed: ") + std::strerror(errno));
+		}
+		if (!watch(directory, filename)) {
+			const int error = errno;
+			::close(inotifyFd);
+			inotifyFd = -1;
+			throw std::runtime_error("Unable to watch directory " + directory + ": " + std::strerror(error));
+		}
+		watchArrayFiles();
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (wakeFd < 0) {
+			const int error = errno;
+			::close(inotifyFd);
+			inotifyFd = -1;
+			throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(error));
+		}
+
+		running.store(true, std::memory_order_relaxed);
+		thread = std::thread(&ConfigWatcher::run, this);
+		CONFIG_LOG_INFO("Watching " << directory << "/" << filename << " for changes");
+	}
+
+	void ConfigWatcher::stop() {
+		if (!thread.joinable()) return;
+		running.store(false, std::memory_order_relaxed);
+		const uint64_t one = 1;
+		if (::write(wakeFd, &one, sizeof(one)) < 0) {
+			CONFIG_LOG_WARN("Unable to wake the config watcher: " << std::strerror(errno));
+		}
+		thread.join();
+		::close(inotifyFd);
+		::close(wakeFd);
+		inotifyFd = -1;
+		wakeFd = -1;
+		std::lock_guard<std::mutex> lock(watchMutex);
+		watchedNames.clear();
+	}
+
+	bool ConfigWatcher::watch(const std::string& directory, const std::string& name) {
+		// Editors either rewrite the file in place or rename a new file over it
+		const uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO;
+		const int descriptor = inotify_add_watch(inotifyFd, directory.c_str(), mask);
+		if (descriptor < 0) return false;
+		std::lock_guard<std::mutex> lock(watchMutex);
+		watchedNames[descriptor].insert(name);
+		return true;
+	}
+
+	void ConfigWatcher::watchArrayFiles() {
+		for (const auto& path : reader.getArrayFiles()) {
+			std::string arrayDirectory;
+			std::string arrayName;
+			splitPath(path, arrayDirectory, arrayName);
+			if (!watch(arrayDirectory, arrayName)) {
+				CONFIG_LOG_WARN("Unable to watch array file " << path << ": " << std::strerror(errno));
+			}
+		}
+	}
+
+	bool ConfigWatcher::isWatched(int descriptor, const char* name) {
+		std::lock_guard<std::mutex> lock(watchMutex);
+		const auto names = watchedNames.find(descriptor);
+		return names != watchedNames.end() && names->second.count(name);
+	}
+
+	void ConfigWatcher::run() {
+		using Clock = std::chrono::steady_clock;
+		alignas(inotify_event) char events[4096];
+		bool pending = false;
+		Clock::time_point deadline;
+
+		while (running.load(std::memory_order_relaxed)) {
+			int timeout = -1;
+			if (pending) {
+				const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+				timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(0, remaining.count()));
+			}
+
+			pollfd fds[2] = {{wakeFd, POLLIN, 0}, {inotifyFd, POLLIN, 0}};
+			if (poll(fds, 2, timeout) < 0) {
+				if (errno == EINTR) continue;
+				CONFIG_LOG_ERROR("Config watcher poll failed: " << std::strerror(errno));
+				break;
+			}
+			if (fds[0].revents & POLLIN) break;
+
+			if (fds[1].revents & POLLIN) {
+				ssize_t length;
+				while ((length = ::read(inotifyFd, events, sizeof(events))) > 0) {
+					for (const char* p = events; p < events + length;) {
+						const auto* event = reinterpret_cast<const inotify_event*>(p);
+						if (event->len > 0 && isWatched(event->wd, event->name)) {
+							// Every further event pushes the reload back, so a burst of writes reloads once
+							pending = true;
+							deadline = Clock::now() + debounce;
+						}
+						if (event->mask & IN_IGNORED) {
+							CONFIG_LOG_WARN("A directory of " << directory << "/" << filename << " or its arrays is no longer watched");
+						}
+						p += sizeof(inotify_event) + event->len;
+					}
+				}
+			}
+
+			if (pending && Clock::now() >= deadline) {
+				pending = false;
+				reloadNow();
+			}
+		}
+	}
+#else
+	void ConfigWatcher::start() {
+		throw std::runtime_error("ConfigWatcher requires inotify, which this platform does not provide");
+	}
+
+	void ConfigWatcher::stop() {}
+
+	void ConfigWatcher::run() {}
+
+	bool ConfigWatcher::watch(const std::string&, const std::string&) { return false; }
+
+	void ConfigWatcher::watchArrayFiles() {}
+
+	bool ConfigWatcher::isWatched(int, const char*) { return false; }
+#endif
+
+	ConfigWatcher::SubscriptionId ConfigWatcher::subscribe(const std::string& section, const std::string& key, Callback callback) {
+		std::lock_guard<std::mutex> lock(subscriptionMutex);
+		const SubscriptionId id = nextId++;
+		subscriptions.push_back({id, section, key, std::move(callback)});
+		return id;
+	}
+
+	void ConfigWatcher::unsubscribe(SubscriptionId id) {
+		std::lock_guard<std::mutex> lock(subscriptionMutex);
+		subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+			[id](const Subscription& subscription) { return subscription.id == id; }), subscriptions.end());
+	}
+
+	bool ConfigWatcher::reloadNow() {
+		std::lock_guard<std::mutex> lock(reloadMutex);
+		// A file that is missing for a moment, e.g. between an editor's unlink and rename, is
+		// not an instruction to fall back to the defaults
+		if (!std::ifstream(reader.getConfigFilePath()).is_open()) {
+			CONFIG_LOG_WARN("Config file " << reader.getConfigFilePath() << " is missing, keeping current values");
+			failedReloads.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		const ConfigSnapshot before = reader.snapshot();
+		try {
+			reader.reloadIncremental();
+		} catch (const std::exception& e) {
+			CONFIG_LOG_ERROR("Config reload failed, keeping current values: " << e.what());
+			failedReloads.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		reloads.fetch_add(1, std::memory_order_relaxed);
+		// The reload may have brought references to other array files
+		if (isRunning()) watchArrayFiles();
+		notify(before, reader.snapshot());
+		return true;
+	}
+
+	void ConfigWatcher::notify(const ConfigSnapshot& before, const ConfigSnapshot& after) {
+		// Callbacks run without the lock so that they may subscribe and unsubscribe
+		std::vector<Subscription> current;
+		{
+			std::lock_guard<std::mutex> lock(subscriptionMutex);
+			current = subscriptions;
+		}
+		for (const auto& subscription : current) {
+			const StoredValue* oldValue = before.getGeneration().findValue(subscription.section, subscription.key);
+			const StoredValue* newValue = after.getGeneration().findValue(subscription.section, subscription.key);
+			if (oldValue == newValue) continue;
+			if (oldValue && newValue && *oldValue == *newValue) continue;
+			try {
+				subscription.callback(ConfigChange{subscription.section, subscription.key, oldValue, newValue});
+			} catch (const std::exception& e) {
+				CONFIG_LOG_ERROR("Config change callback for " << subscription.section << "." << subscription.key
+					<< " threw: " << e.what());
+			}
+		}
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,113 @@
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include "stored_value.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ConfigLib {
+
+class ConfigReader;
+class ConfigSnapshot;
+
+// One subscribed key whose value differs before and after a reload. Either value is null if
+// the key had no value on that side. Everything referenced is valid only during the callback.
+struct ConfigChange {
+    const std::string& section;
+    const std::string& key;
+    const StoredValue* oldValue;
+    const StoredValue* newValue;
+};
+
+// Reloads a reader's config file on a background thread whenever the file, or an array file
+// that one of its lists refers to (see ExternalArray), changes on disk. The files' directories
+// are watched with inotify, so editors that save through a temporary file and a rename are
+// picked up as well. Array files are watched from start() and after every reload, and stay
+// watched once referred to. A burst of events triggers a single reload, once the file
+// has been quiet for the debounce interval. Changed sections are parsed and validated again on
+// the watcher thread (see ConfigReader::reloadIncremental()), and the result is published only
+// if that succeeds. Invalid values fall back to their defaults
+// as in loadConfig(); if the file is missing or the reload throws, the previous values stay.
+//
+// The reader is written from another thread, so it must be in snapshot mode before start(),
+// and read only through snapshots from then on. The reader must outlive the watcher.
+class ConfigWatcher {
+public:
+    using Callback = std::function<void(const ConfigChange&)>;
+    using SubscriptionId = uint64_t;
+
+    explicit ConfigWatcher(ConfigReader& reader, std::chrono::milliseconds debounce = std::chrono::milliseconds(100));
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // Throws std::logic_error if the reader is not in snapshot mode or a ConfigHandle was bound
+    // to one of its values, std::runtime_error if the directory cannot be watched, or on
+    // platforms without inotify.
+    void start();
+    // Waits for a reload in progress to finish. Safe to call when not running.
+    void stop();
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // Callbacks run on the watcher thread, after the new values are published, and only when
+    // the key's value really changed. A notification already in progress may still call a
+    // callback after it has been unsubscribed.
+    SubscriptionId subscribe(const std::string& section, const std::string& key, Callback callback);
+    void unsubscribe(SubscriptionId id);
+
+    // Reloads on the calling thread and notifies subscribers. Returns false if the reload failed.
+    bool reloadNow();
+
+    size_t getReloadCount() const { return reloads.load(std::memory_order_relaxed); }
+    size_t getFailedReloadCount() const { return failedReloads.load(std::memory_order_relaxed); }
+
+private:
+    struct Subscription {
+        SubscriptionId id;
+        std::string section;
+        std::string key;
+        Callback callback;
+    };
+
+    void run();
+    void notify(const ConfigSnapshot& before, const ConfigSnapshot& after);
+    // Watches directory and makes changes to name in it trigger a reload. Returns false, with
+    // errno set, if the directory cannot be watched.
+    bool watch(const std::string& directory, const std::string& name);
+    void watchArrayFiles();
+    bool isWatched(int descriptor, const char* name);
+
+    ConfigReader& reader;
+    std::chrono::milliseconds debounce;
+    std::string directory;
+    std::string filename;
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    int inotifyFd = -1;
+    int wakeFd = -1;           // eventfd signalled by stop()
+    std::mutex watchMutex;
+    // Names that trigger a reload, by the inotify watch descriptor of their directory
+    std::unordered_map<int, std::unordered_set<std::string>> watchedNames;
+
+    std::mutex reloadMutex;    // pairs each reload with the snapshots it is compared against
+    std::mutex subscriptionMutex;
+    std::vector<Subscription> subscriptions;
+    SubscriptionId nextId = 1;
+
+    std::atomic<size_t> reloads{0};
+    std::atomic<size_t> failedReloads{0};
+};
+
+} // namespace ConfigLib
+
+#endif // CONFIG_WATCHER_H
@@ -0,0 +1,66 @@
+#ifndef DOUBLE_LIST_H
+#define DOUBLE_LIST_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace ConfigLib {
+
+// Alignment of the storage of lists of at least this many bytes; shorter lists are aligned to
+// their size rounded up to a power of two, so that no list straddles more cache lines than it
+// needs and loops over a list can use aligned vector loads.
+constexpr size_t kListAlignment = 64;
+
+// Polymorphic allocator that aligns each block as described for kListAlignment.
+template<typename T>
+class AlignedAllocator : public std::pmr::polymorphic_allocator<T> {
+public:
+    using std::pmr::polymorphic_allocator<T>::polymorphic_allocator;
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U>& other) noexcept : std::pmr::polymorphic_allocator<T>(other.resource()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(this->resource()->allocate(count * sizeof(T), alignmentFor(count)));
+    }
+    void deallocate(T* block, size_t count) {
+        this->resource()->deallocate(block, count * sizeof(T), alignmentFor(count));
+    }
+
+    // As for std::pmr containers, a copy uses the default resource unless given one
+    AlignedAllocator select_on_container_copy_construction() const { return AlignedAllocator(); }
+
+private:
+    static size_t alignmentFor(size_t count) {
+        size_t alignment = alignof(T);
+        while (alignment < kListAlignment && alignment < count * sizeof(T)) alignment *= 2;
+        return alignment;
+    }
+};
+
+// How lists of doubles are stored.
+using DoubleList = std::vector<double, AlignedAllocator<double>>;
+
+// Read-only view of contiguous doubles, valid as long as the value it was taken from.
+class DoubleSpan {
+public:
+    DoubleSpan() = default;
+    DoubleSpan(const double* data, size_t size) : first(data), count(size) {}
+
+    const double* data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const double* begin() const { return first; }
+    const double* end() const { return first + count; }
+    const double& operator[](size_t index) const { return first[index]; }
+
+private:
+    const double* first = nullptr;
+    size_t count = 0;
+};
+
+} // namespace ConfigLib
+
+#endif // DOUBLE_LIST_H
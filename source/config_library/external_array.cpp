@@ -0,0 +1,172 @@
+#include "external_array.hpp"
+#include "config_log.hpp"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace ConfigLib {
+
+	namespace {
+		bool isLittleEndian() {
+			const uint16_t probe = 1;
+			unsigned char first;
+			std::memcpy(&first, &probe, 1);
+			return first == 1;
+		}
+
+		bool endsWith(std::string_view text, std::string_view suffix) {
+			return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+		}
+
+		// The quoted or bare value following 'name': in the dictionary of a .npy header
+		std::string_view headerField(std::string_view header, std::string_view name) {
+			const std::string quoted = "'" + std::string(name) + "'";
+			size_t at = header.find(quoted);
+			if (at == std::string_view::npos) return std::string_view();
+			at = header.find(':', at + quoted.size());
+			if (at == std::string_view::npos) return std::string_view();
+			++at;
+			while (at < header.size() && header[at] == ' ') ++at;
+			if (at == header.size()) return std::string_view();
+			if (header[at] == '\'') {
+				const size_t end = header.find('\'', at + 1);
+				return end == std::string_view::npos ? std::string_view() : header.substr(at + 1, end - at - 1);
+			}
+			if (header[at] == '(') {
+				const size_t end = header.find(')', at);
+				return end == std::string_view::npos ? std::string_view() : header.substr(at, end - at + 1);
+			}
+			const size_t end = header.find_first_of(",}", at);
+			return end == std::string_view::npos ? std::string_view() : header.substr(at, end - at);
+		}
+
+		// Values and data offset of a .npy file: the format's magic string, a version, the length
+		// of the header and the header, a Python dictionary literal such as
+		//   {'descr': '<f8', 'fortran_order': False, 'shape': (1000,), }
+		// padded so that the data starts on a 64-byte boundary.
+		void parseNpyHeader(std::string_view bytes, size_t& offset, size_t& count) {
+			if (bytes.size() < 10 || bytes.substr(0, 6) != "\x93NUMPY") throw std::runtime_error("not a .npy file");
+			const unsigned major = static_cast<unsigned char>(bytes[6]);
+			size_t headerLength = 0;
+			size_t headerStart = 0;
+			if (major == 1) {
+				headerLength = static_cast<unsigned char>(bytes[8]) | size_t(static_cast<unsigned char>(bytes[9])) << 8;
+				headerStart = 10;
+			} else if (major == 2 || major == 3) {
+				if (bytes.size() < 12) throw std::runtime_error("truncated .npy header");
+				for (int i = 3; i >= 0; --i) headerLength = headerLength << 8 | static_cast<unsigned char>(bytes[8 + i]);
+				headerStart = 12;
+			} else {
+				throw std::runtime_error("unsupported .npy version " + std::to_string(major));
+			}
+			if (headerLength > bytes.size() - headerStart) throw std::runtime_error("truncated .npy header");
+			const std::string_view header = bytes.substr(headerStart, headerLength);
+
+			const std::string_view descr = headerField(header, "descr");
+			const char* const native = isLittleEndian() ? "<f8" : ">f8";
+			if (descr != native) {
+				throw std::runtime_error("holds '" + std::string(descr) + "' values, not '" + native + "'");
+			}
+			const std::string_view shape = headerField(header, "shape");
+			if (shape.empty() || shape.front() != '(') throw std::runtime_error("no shape in .npy header");
+			count = 1;
+			size_t longDimensions = 0;
+			for (size_t i = 1; i < shape.size();) {
+				if (shape[i] < '0' || shape[i] > '9') {
+					++i;
+					continue;
+				}
+				size_t extent = 0;
+				for (; i < shape.size() && shape[i] >= '0' && shape[i] <= '9'; ++i) {
+					if (extent > (SIZE_MAX - 9) / 10) throw std::runtime_error("shape too large");
+					extent = extent * 10 + static_cast<size_t>(shape[i] - '0');
+				}
+				if (extent != 0 && count > SIZE_MAX / extent) throw std::runtime_error("shape too large");
+				count *= extent;
+				if (extent > 1) ++longDimensions;
+			}
+			// Fortran order only matters once two dimensions have more than one element
+			if (headerField(header, "fortran_order") == "True" && longDimensions > 1) {
+				throw std::runtime_error("is in Fortran order");
+			}
+			offset = headerStart + headerLength;
+		}
+	}
+
+	std::string_view ExternalArray::referencedPath(std::string_view text) {
+		size_t begin = 0;
+		size_t end = text.size();
+		while (begin < end && (text[begin] == ' ' || text[begin] == '\t')) ++begin;
+		while (end > begin && (text[end - 1] == ' ' || text[end - 1] == '\t')) --end;
+		if (begin == end || text[begin] != '@') return std::string_view();
+		++begin;
+		while (begin < end && (text[begin] == ' ' || text[begin] == '\t')) ++begin;
+		return text.substr(begin, end - begin);
+	}
+
+	ExternalArray::Stamp ExternalArray::stampOf(const std::string& path) {
+		Stamp stamp;
+#ifdef _WIN32
+		struct _stat64 info;
+		if (_stat64(path.c_str(), &info) != 0) return stamp;
+		stamp.modified = static_cast<int64_t>(info.st_mtime) * 1000000000;
+#else
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0) return stamp;
+#if defined(__APPLE__)
+		stamp.modified = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+		stamp.modified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+		stamp.inode = static_cast<uint64_t>(info.st_ino);
+#endif
+		stamp.exists = true;
+		stamp.size = static_cast<uint64_t>(info.st_size);
+		stamp.device = static_cast<uint64_t>(info.st_dev);
+		return stamp;
+	}
+
+	void ExternalArray::map() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (mapped.load(std::memory_order_relaxed)) return;
+		// The values are still the file's, but no longer those of the stamp a reload compares
+		if (hasChanged()) {
+			CONFIG_LOG_WARN("Array file " << path << " changed since it was loaded; reload to pick the change up");
+		}
+
+		MappedFile opened;
+		if (!opened.open(path)) throw std::runtime_error("Unable to open array file: " + path);
+		const std::string_view bytes = opened.view();
+		size_t offset = 0;
+		size_t count = 0;
+		try {
+			if (endsWith(path, ".npy")) {
+				parseNpyHeader(bytes, offset, count);
+			} else if (bytes.size() % sizeof(double) != 0) {
+				throw std::runtime_error("size is not a multiple of 8 bytes");
+			} else {
+				count = bytes.size() / sizeof(double);
+			}
+			if (count > (bytes.size() - offset) / sizeof(double)) throw std::runtime_error("shorter than its shape");
+		} catch (const std::runtime_error& e) {
+			throw std::runtime_error("Invalid array file " + path + ": " + e.what());
+		}
+
+		// Moving the file may move a buffer it read the file into
+		file = std::move(opened);
+		const char* data = file.view().data() + offset;
+		if (reinterpret_cast<uintptr_t>(data) % alignof(double) == 0) {
+			span = DoubleSpan(reinterpret_cast<const double*>(data), count);
+		} else {
+			copy.resize(count);
+			if (count) std::memcpy(copy.data(), data, count * sizeof(double));
+			span = DoubleSpan(copy.data(), count);
+			file.close();
+		}
+		CONFIG_LOG_DEBUG("Mapped " << count << " values of " << path);
+		mapped.store(true, std::memory_order_release);
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,90 @@
+#ifndef EXTERNAL_ARRAY_H
+#define EXTERNAL_ARRAY_H
+
+#include "double_list.hpp"
+#include "mapped_file.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace ConfigLib {
+
+// A list of doubles kept in a binary file instead of the INI text, where a list key refers to
+// it as "@path", e.g.
+//   [Calibration]
+//   curve = @data/curve.npy
+// Relative paths are opened from the working directory, as the config file itself is. Nothing
+// is read at load time: the file is memory-mapped on first access and its values are viewed in
+// place, never parsed. A file ending in .npy is read in NumPy's format, which must hold float64
+// values in the byte order of this machine ('<f8' on little-endian ones) and in C order or one
+// dimension; its values are read flat, whatever its shape. Any other file is read as raw
+// doubles in the byte order of this machine.
+//
+// The file's stamp is taken when the reference is loaded, and a file whose stamp has changed
+// since counts as a new value on the next reload. A mapping faults with SIGBUS once its file is
+// truncated, and shows a rewrite while it is half done, so a file in use must be updated by
+// writing a new file and renaming it over the old one, as np.save to a temporary name and
+// os.replace do; the old file then stays mapped, unchanged, for as long as it is viewed.
+class ExternalArray {
+public:
+    // Identifies one version of a file. A file rewritten in place has another size or
+    // modification time, and one replaced through a rename another inode.
+    struct Stamp {
+        bool exists = false;
+        uint64_t size = 0;
+        int64_t modified = 0;                   // nanoseconds where the platform records them
+        uint64_t device = 0;
+        uint64_t inode = 0;
+
+        bool operator==(const Stamp& other) const {
+            return exists == other.exists && size == other.size && modified == other.modified
+                && device == other.device && inode == other.inode;
+        }
+        bool operator!=(const Stamp& other) const { return !(*this == other); }
+    };
+
+    explicit ExternalArray(std::string path) : path(std::move(path)), stamp(stampOf(this->path)) {}
+
+    ExternalArray(const ExternalArray&) = delete;
+    ExternalArray& operator=(const ExternalArray&) = delete;
+
+    // The path of a "@path" reference, or an empty view if text is not one. Blanks around the
+    // path are ignored.
+    static std::string_view referencedPath(std::string_view text);
+    // The stamp of the file at path now; exists is false if there is none.
+    static Stamp stampOf(const std::string& path);
+
+    const std::string& getPath() const { return path; }
+    // The file's stamp when this reference was created.
+    const Stamp& getStamp() const { return stamp; }
+    // Whether the file on disk is no longer the one this reference was created for.
+    bool hasChanged() const { return stampOf(path) != stamp; }
+    bool isMapped() const { return mapped.load(std::memory_order_acquire); }
+
+    // Maps the file on the first call, from any thread; later calls return the same view, which
+    // stays valid as long as this object. Throws std::runtime_error if the file cannot be opened
+    // or does not hold doubles as described above, and tries again on the next call.
+    DoubleSpan get() const {
+        if (!isMapped()) map();
+        return span;
+    }
+
+private:
+    void map() const;
+
+    const std::string path;
+    const Stamp stamp;
+    mutable std::mutex mutex;
+    mutable std::atomic<bool> mapped{false};
+    mutable MappedFile file;
+    // The values, if the file's were not aligned for doubles
+    mutable DoubleList copy;
+    mutable DoubleSpan span;
+};
+
+} // namespace ConfigLib
+
+#endif // EXTERNAL_ARRAY_H
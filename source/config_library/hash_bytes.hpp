@@ -0,0 +1,49 @@
+#ifndef HASH_BYTES_H
+#define HASH_BYTES_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace ConfigLib {
+
+// Non-cryptographic 64-bit hash, used for key lookup and for file fingerprints. Input is
+// mixed a word at a time rather than byte by byte, as keys are short identifiers. Passing the
+// hash of one string as the seed of the next hashes the two as a pair.
+inline uint64_t hashBytes(std::string_view bytes, uint64_t seed = 0x9e3779b97f4a7c15ull) {
+    const uint64_t multiplier = 0xff51afd7ed558ccdull;
+    uint64_t hash = seed ^ bytes.size();
+    const char* data = bytes.data();
+    size_t remaining = bytes.size();
+    for (; remaining >= 8; data += 8, remaining -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 32;
+    }
+    if (remaining) {
+        // Fixed-size loads only; the last word may overlap bytes already mixed in
+        uint64_t word;
+        if (bytes.size() >= 8) {
+            std::memcpy(&word, data + remaining - 8, 8);
+        } else if (remaining >= 4) {
+            uint32_t low, high;
+            std::memcpy(&low, data, 4);
+            std::memcpy(&high, data + remaining - 4, 4);
+            word = low | (uint64_t(high) << 32);
+        } else {
+            word = uint64_t(static_cast<unsigned char>(data[0]))
+                | uint64_t(static_cast<unsigned char>(data[remaining / 2])) << 8
+                | uint64_t(static_cast<unsigned char>(data[remaining - 1])) << 16;
+        }
+        hash = (hash ^ word) * multiplier;
+    }
+    // Hash tables pick slots with the low bits, which a multiply alone leaves poorly mixed
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    return hash ^ (hash >> 33);
+}
+
+} // namespace ConfigLib
+
+#endif // HASH_BYTES_H
@@ -0,0 +1,53 @@
+#include "hazard_pointers.hpp"
+#include <algorithm>
+
+namespace ConfigLib {
+	namespace HazardPointers {
+
+		namespace {
+			std::atomic<Slot*> slots{nullptr};
+			thread_local Slot* cachedSlot = nullptr;
+
+			bool tryClaim(Slot* slot) {
+				bool expected = false;
+				return !slot->active.load(std::memory_order_relaxed)
+					&& slot->active.compare_exchange_strong(expected, true, std::memory_order_acquire);
+			}
+		}
+
+		Slot* acquire() {
+			if (Slot* cached = cachedSlot) {
+				if (tryClaim(cached)) return cached;
+			}
+			for (Slot* slot = slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+				if (tryClaim(slot)) return slot;
+			}
+
+			// Every slot is busy: add one. Slots are never removed, so pushing is the only update.
+			Slot* slot = new Slot;
+			slot->active.store(true, std::memory_order_relaxed);
+			Slot* head = slots.load(std::memory_order_relaxed);
+			do {
+				slot->next = head;
+			} while (!slots.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+			return slot;
+		}
+
+		void release(Slot* slot) {
+			slot->pointer.store(nullptr, std::memory_order_release);
+			slot->active.store(false, std::memory_order_release);
+			cachedSlot = slot;
+		}
+
+		void collectProtected(std::vector<const void*>& out) {
+			for (Slot* slot = slots.load(std::memory_order_acquire); slot; slot = slot->next) {
+				if (const void* pointer = slot->pointer.load(std::memory_order_seq_cst)) {
+					out.push_back(pointer);
+				}
+			}
+			std::sort(out.begin(), out.end());
+			out.erase(std::unique(out.begin(), out.end()), out.end());
+		}
+
+	}
+} // namespace ConfigLib
@@ -0,0 +1,47 @@
+#ifndef HAZARD_POINTERS_H
+#define HAZARD_POINTERS_H
+
+#include <atomic>
+#include <vector>
+
+namespace ConfigLib {
+namespace HazardPointers {
+
+    // Safe memory reclamation for objects that readers use without locks while writers
+    // replace them. A reader announces the pointer it is about to use in a slot; a writer that
+    // has unlinked an object frees it only once no slot announces it any more.
+    // Slots are shared by the whole process and never freed. A thread keeps the last slot it
+    // released, so pinning is normally one uncontended exchange.
+    struct Slot {
+        std::atomic<const void*> pointer{nullptr};
+        std::atomic<bool> active{false};
+        Slot* next = nullptr;
+    };
+
+    // Claims a free slot, creating one if every slot is in use. Lock-free.
+    Slot* acquire();
+    // Clears the slot's announcement and returns it for reuse.
+    void release(Slot* slot);
+
+    // Loads source and announces the result in slot. The returned object stays valid until the
+    // slot is released or protects something else, even if a writer replaces source meanwhile.
+    template<typename T>
+    T* protect(const std::atomic<T*>& source, Slot* slot) {
+        T* pointer = source.load(std::memory_order_acquire);
+        for (;;) {
+            // Sequentially consistent on both sides, so a writer scanning the slots after
+            // replacing source either sees this announcement or we see its replacement.
+            slot->pointer.store(pointer, std::memory_order_seq_cst);
+            T* current = source.load(std::memory_order_seq_cst);
+            if (current == pointer) return pointer;
+            pointer = current;
+        }
+    }
+
+    // Appends every pointer currently announced by some slot, sorted and without duplicates.
+    void collectProtected(std::vector<const void*>& out);
+
+} // namespace HazardPointers
+} // namespace ConfigLib
+
+#endif // HAZARD_POINTERS_H
@@ -0,0 +1,107 @@
+#include "ini_stream.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ConfigLib {
+
+	IniStreamReader::IniStreamReader(std::string_view buffer) : tokenizer(buffer) {}
+
+	IniStreamReader::IniStreamReader(std::istream& input, size_t bufferSize)
+		: input(&input), tokenizer(std::string_view()), window(std::max<size_t>(bufferSize, 1)) {}
+
+	bool IniStreamReader::refill() {
+		if (!input) return false;
+
+		// Keep the partial line the last window ended with
+		std::memmove(window.data(), window.data() + consumed, filled - consumed);
+		filled -= consumed;
+		consumed = 0;
+
+		// What is left holds no newline, so only newly read bytes need searching
+		for (;;) {
+			if (filled == window.size()) window.resize(window.size() * 2);
+			const size_t searched = filled;
+			if (*input) {
+				input->read(window.data() + filled, static_cast<std::streamsize>(window.size() - filled));
+				filled += static_cast<size_t>(input->gcount());
+			}
+			const bool atEnd = !*input;
+			// Hand over everything up to the last newline, or the rest once the input is exhausted
+			size_t end = filled;
+			while (end > searched && window[end - 1] != '\n') --end;
+			if (end == searched) {
+				if (!atEnd) continue;
+				end = filled;
+			}
+			if (end == 0) return false;
+			consumed = end;
+			tokenizer = IniTokenizer(std::string_view(window.data(), end));
+			return true;
+		}
+	}
+
+	bool IniStreamReader::next(IniEvent& event) {
+		IniToken token;
+		for (;;) {
+			if (!tokenizer.next(token)) {
+				if (input && input->bad()) {
+					input = nullptr;
+					event.kind = IniEvent::Kind::Error;
+					event.section = section;
+					event.key = event.value = std::string_view();
+					event.text = "Unable to read input";
+					event.line = 0;
+					return true;
+				}
+				if (!refill()) return false;
+				continue;
+			}
+			++lineNumber;
+			if (token.kind == IniToken::Kind::Blank) continue;
+
+			event.line = lineNumber;
+			event.key = token.key;
+			event.value = token.value;
+			event.text = token.text;
+			switch (token.kind) {
+				case IniToken::Kind::Section:
+					if (input) {
+						sectionName.assign(token.name.data(), token.name.size());
+						section = sectionName;
+					} else {
+						section = token.name;
+					}
+					event.kind = IniEvent::Kind::Section;
+					break;
+				case IniToken::Kind::KeyValue:
+					event.kind = IniEvent::Kind::KeyValue;
+					break;
+				case IniToken::Kind::Comment:
+					event.kind = IniEvent::Kind::Comment;
+					event.text = token.value;
+					break;
+				default:
+					event.kind = IniEvent::Kind::Error;
+					break;
+			}
+			event.section = section;
+			return true;
+		}
+	}
+
+	bool IniStreamReader::parse(IniHandler& handler) {
+		IniEvent event;
+		while (next(event)) {
+			bool proceed = true;
+			switch (event.kind) {
+				case IniEvent::Kind::Section: proceed = handler.onSection(event.section, event.line); break;
+				case IniEvent::Kind::KeyValue: proceed = handler.onKeyValue(event.section, event.key, event.value, event.line); break;
+				case IniEvent::Kind::Comment: proceed = handler.onComment(event.text, event.line); break;
+				case IniEvent::Kind::Error: proceed = handler.onError(event.text, event.line); break;
+			}
+			if (!proceed) return false;
+		}
+		return true;
+	}
+
+} // namespace ConfigLib
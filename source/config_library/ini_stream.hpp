@@ -0,0 +1,82 @@
+#ifndef INI_STREAM_H
+#define INI_STREAM_H
+
+#include "ini_tokenizer.hpp"
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ConfigLib {
+
+// One event of an IniStreamReader. Views stay valid until the next call to next(); section
+// names the enclosing section of a key and is empty before the first header.
+struct IniEvent {
+    enum class Kind {
+        Section,    // section holds the new section's name
+        KeyValue,   // key and value are trimmed, value has any trailing '#' comment removed
+        Comment,    // text holds everything after the leading '#'
+        Error       // text holds the line, or describes a read failure
+    };
+
+    Kind kind = Kind::Section;
+    std::string_view section;
+    std::string_view key;
+    std::string_view value;
+    std::string_view text;
+    size_t line = 0;         // 1-based line number; 0 for a read failure
+};
+
+// Callbacks of IniStreamReader::parse(). Returning false from any of them stops the parse.
+class IniHandler {
+public:
+    virtual ~IniHandler() = default;
+    virtual bool onSection(std::string_view /*name*/, size_t /*line*/) { return true; }
+    virtual bool onKeyValue(std::string_view /*section*/, std::string_view /*key*/, std::string_view /*value*/, size_t /*line*/) { return true; }
+    virtual bool onComment(std::string_view /*text*/, size_t /*line*/) { return true; }
+    // A line that is neither blank, a header, a key nor a comment, or a failed read.
+    virtual bool onError(std::string_view /*text*/, size_t /*line*/) { return true; }
+};
+
+// Streaming INI parser, pull or callback style, built on IniTokenizer so that it yields exactly
+// the tokens the loader sees. Blank lines produce no event. Over a std::istream only a window
+// of whole lines is held at a time, so memory stays constant however large the input is; the
+// window grows only to fit a line longer than it.
+//   IniStreamReader reader(stream);
+//   for (IniEvent event; reader.next(event);) { ... }
+class IniStreamReader {
+public:
+    static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+    // Reads an INI document already in memory, such as a MappedFile view, without copying it.
+    explicit IniStreamReader(std::string_view buffer);
+    // input must outlive the reader.
+    explicit IniStreamReader(std::istream& input, size_t bufferSize = kDefaultBufferSize);
+
+    IniStreamReader(const IniStreamReader&) = delete;
+    IniStreamReader& operator=(const IniStreamReader&) = delete;
+
+    // Returns false once the input is exhausted.
+    bool next(IniEvent& event);
+    // Calls handler for every remaining event; returns false if a callback stopped the parse.
+    bool parse(IniHandler& handler);
+
+private:
+    // Replaces the tokenizer's window with the next run of whole lines; false at end of input.
+    bool refill();
+
+    std::istream* input = nullptr;
+    IniTokenizer tokenizer;
+    std::vector<char> window;
+    size_t filled = 0;       // bytes of window read from input
+    size_t consumed = 0;     // bytes of window handed to the tokenizer
+    size_t lineNumber = 0;
+    // The current section's name; copied only when the window it points into can move
+    std::string sectionName;
+    std::string_view section;
+};
+
+} // namespace ConfigLib
+
+#endif // INI_STREAM_H
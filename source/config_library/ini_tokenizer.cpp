@@ -0,0 +1,142 @@
+#include "ini_tokenizer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ConfigLib {
+
+	namespace {
+		inline bool isBlank(char c) {
+			return c == ' ' || c == '\t';
+		}
+	}
+
+	std::string_view IniTokenizer::trim(std::string_view str) {
+		size_t strBegin = 0;
+		size_t strEnd = str.size();
+		while (strBegin < strEnd && isBlank(str[strBegin])) ++strBegin;
+		while (strEnd > strBegin && isBlank(str[strEnd - 1])) --strEnd;
+		return str.substr(strBegin, strEnd - strBegin);
+	}
+
+	void IniTokenizer::classify(std::string_view line, IniToken& token) {
+		const auto equals = line.find('=');
+		const auto hash = equals == std::string_view::npos ? std::string_view::npos : line.find('#', equals + 1);
+		classify(line, equals, hash, token);
+	}
+	
+	void IniTokenizer::classify(std::string_view raw, size_t equals, size_t hash, IniToken& token) {
+		if (!raw.empty() && raw.back() == '\r') raw.remove_suffix(1);
+
+		token.name = std::string_view();
+		token.key = std::string_view();
+		token.value = std::string_view();
+
+		// '=' and '#' are never blanks, so both offsets fall inside the trimmed line
+		const std::string_view line = trim(raw);
+		token.text = line;
+		if (line.empty()) {
+			token.kind = IniToken::Kind::Blank;
+			return;
+		}
+		const size_t begin = static_cast<size_t>(line.data() - raw.data());
+		const size_t end = begin + line.size();
+
+		if (line.front() == '#') {
+			token.kind = IniToken::Kind::Comment;
+			token.value = line.substr(1);
+			return;
+		}
+		if (line.front() == '[' && line.back() == ']') {
+			token.kind = IniToken::Kind::Section;
+			token.name = line.substr(1, line.size() - 2);
+			return;
+		}
+		if (equals == std::string_view::npos) {
+			token.kind = IniToken::Kind::Other;
+			return;
+		}
+
+		token.kind = IniToken::Kind::KeyValue;
+		token.key = trim(raw.substr(begin, equals - begin));
+		const auto valueEnd = hash != std::string_view::npos ? hash : end;
+		token.value = trim(raw.substr(equals + 1, valueEnd - (equals + 1)));
+	}
+
+	bool IniTokenizer::next(IniToken& token) {
+		if (offset >= buffer.size()) return false;
+		if (indexed) return nextIndexed(token);
+
+		const char* begin = buffer.data() + offset;
+		const size_t remaining = buffer.size() - offset;
+		const char* newline = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+		const size_t lineLength = newline ? static_cast<size_t>(newline - begin) : remaining;
+
+		offset += lineLength + (newline ? 1 : 0);
+		token.line = ++lineNumber;
+		classify(std::string_view(begin, lineLength), token);
+		return true;
+	}
+
+	bool IniTokenizer::refillIndex() {
+		if (windowEnd >= buffer.size()) return false;
+		windowBegin = windowEnd;
+		windowEnd = std::min(buffer.size(), windowBegin + kIndexWindowSize);
+		StructuralIndex::build(buffer.substr(windowBegin, windowEnd - windowBegin), blocks, kernel);
+		return true;
+	}
+
+	namespace {
+		// First position in [from, limit) whose bit is set in the given bitmap, or npos.
+		// Both bounds must lie within the window the blocks were built for.
+		template<uint64_t StructuralIndex::Block::* Bitmap>
+		inline size_t findInWindow(const std::vector<StructuralIndex::Block>& blocks, size_t windowBegin, size_t from, size_t limit) {
+			if (from >= limit) return std::string_view::npos;
+
+			const size_t relative = from - windowBegin;
+			const size_t lastBlock = (limit - windowBegin - 1) / StructuralIndex::kBlockSize;
+			size_t block = relative / StructuralIndex::kBlockSize;
+			uint64_t mask = blocks[block].*Bitmap & (~uint64_t(0) << (relative % StructuralIndex::kBlockSize));
+			while (!mask) {
+				if (++block > lastBlock) return std::string_view::npos;
+				mask = blocks[block].*Bitmap;
+			}
+			const size_t position = windowBegin + block * StructuralIndex::kBlockSize + StructuralIndex::lowestBit(mask);
+			return position < limit ? position : std::string_view::npos;
+		}
+	}
+
+	bool IniTokenizer::nextIndexed(IniToken& token) {
+		const size_t npos = std::string_view::npos;
+		const size_t lineStart = offset;
+		size_t lineEnd = buffer.size();
+		size_t equals = npos;
+		size_t hash = npos;
+
+		// A line may span several index windows
+		for (size_t from = lineStart;; from = windowEnd) {
+			if (from >= windowEnd && !refillIndex()) break;
+
+			const size_t newline = findInWindow<&StructuralIndex::Block::newlines>(blocks, windowBegin, from, windowEnd);
+			const size_t limit = newline != npos ? newline : windowEnd;
+			if (equals == npos) {
+				const size_t found = findInWindow<&StructuralIndex::Block::equals>(blocks, windowBegin, from, limit);
+				if (found != npos) equals = found - lineStart;
+			}
+			if (equals != npos && hash == npos) {
+				const size_t hashFrom = std::max(from, lineStart + equals + 1);
+				const size_t found = findInWindow<&StructuralIndex::Block::hashes>(blocks, windowBegin, hashFrom, limit);
+				if (found != npos) hash = found - lineStart;
+			}
+			if (newline != npos) {
+				lineEnd = newline;
+				break;
+			}
+		}
+
+		offset = lineEnd + (lineEnd < buffer.size() ? 1 : 0);
+		token.line = ++lineNumber;
+		classify(buffer.substr(lineStart, lineEnd - lineStart), equals, hash, token);
+		return true;
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,71 @@
+#ifndef INI_TOKENIZER_H
+#define INI_TOKENIZER_H
+
+#include "structural_index.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ConfigLib {
+
+// One logical INI line. All views point into the buffer given to the tokenizer.
+struct IniToken {
+    enum class Kind {
+        Blank,      // empty or whitespace-only line
+        Comment,    // text holds everything after the leading '#'
+        Section,    // name holds the text between '[' and ']'
+        KeyValue,   // key and value are trimmed, value has any trailing '#' comment removed
+        Other       // anything else; ignored by the loader
+    };
+
+    Kind kind = Kind::Blank;
+    std::string_view name;
+    std::string_view key;
+    std::string_view value;
+    std::string_view text;   // the whole trimmed line
+    size_t line = 0;         // 1-based line number
+};
+
+// Splits an INI buffer into tokens without copying. Lines end at '\n'; a trailing '\r'
+// is dropped so that CRLF files behave the same on every platform.
+class IniTokenizer {
+public:
+    explicit IniTokenizer(std::string_view buffer) : buffer(buffer) {}
+    // Finds delimiters through a StructuralIndex built block by block with the given kernel,
+    // instead of searching each line. Produces exactly the same tokens as the plain constructor.
+    IniTokenizer(std::string_view buffer, StructuralIndex::Kernel kernel)
+        : buffer(buffer), indexed(true), kernel(kernel) {}
+
+    // Returns false once the buffer is exhausted.
+    bool next(IniToken& token);
+
+    size_t position() const { return offset; }
+
+    static std::string_view trim(std::string_view str);
+    // Classifies a single line that has already had its line terminator removed.
+    static void classify(std::string_view line, IniToken& token);
+
+private:
+    // equals is the offset of the first '=' in the line, hash the first '#' after it
+    static void classify(std::string_view line, size_t equals, size_t hash, IniToken& token);
+    bool nextIndexed(IniToken& token);
+    bool refillIndex();
+
+    // Sized so that a window and its bitmaps stay in cache while they are walked
+    static constexpr size_t kIndexWindowSize = 64 * 1024;
+
+    std::string_view buffer;
+    size_t offset = 0;
+    size_t lineNumber = 0;
+
+    bool indexed = false;
+    StructuralIndex::Kernel kernel = StructuralIndex::Kernel::Auto;
+    std::vector<StructuralIndex::Block> blocks;   // covers [windowBegin, windowEnd)
+    size_t windowBegin = 0;
+    size_t windowEnd = 0;
+};
+
+} // namespace ConfigLib
+
+#endif // INI_TOKENIZER_H
@@ -0,0 +1,139 @@
+#include "mapped_file.hpp"
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ConfigLib {
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		swap(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			close();
+			swap(other);
+		}
+		return *this;
+	}
+
+	void MappedFile::swap(MappedFile& other) noexcept {
+		std::swap(data, other.data);
+		std::swap(length, other.length);
+		std::swap(mapping, other.mapping);
+		std::swap(buffer, other.buffer);
+		std::swap(opened, other.opened);
+		// A small buffer lives inside the string object itself, so re-point unmapped views
+		if (!mapping && opened) data = buffer.data();
+		if (!other.mapping && other.opened) other.data = other.buffer.data();
+	}
+
+	bool MappedFile::open(const std::string& path) {
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+								  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize)) {
+			CloseHandle(file);
+			return readFallback(path);
+		}
+		if (fileSize.QuadPart == 0) {
+			CloseHandle(file);
+			opened = true;
+			return true;
+		}
+
+		HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!fileMapping) return readFallback(path);
+
+		void* view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+		// The view keeps the mapping alive on its own
+		CloseHandle(fileMapping);
+		if (!view) return readFallback(path);
+
+		mapping = view;
+		data = static_cast<const char*>(view);
+		length = static_cast<size_t>(fileSize.QuadPart);
+		opened = true;
+		return true;
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+			::close(fd);
+			return readFallback(path);
+		}
+		if (info.st_size == 0) {
+			::close(fd);
+			opened = true;
+			return true;
+		}
+
+		size_t fileSize = static_cast<size_t>(info.st_size);
+		void* view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (view == MAP_FAILED) return readFallback(path);
+#ifdef MADV_SEQUENTIAL
+		madvise(view, fileSize, MADV_SEQUENTIAL);
+#endif
+
+		mapping = view;
+		data = static_cast<const char*>(view);
+		length = fileSize;
+		opened = true;
+		return true;
+#endif
+	}
+
+	bool MappedFile::read(const std::string& path) {
+		close();
+		return readFallback(path);
+	}
+
+	bool MappedFile::readFallback(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) return false;
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		buffer = contents.str();
+		data = buffer.data();
+		length = buffer.size();
+		opened = true;
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (mapping) {
+#ifdef _WIN32
+			UnmapViewOfFile(mapping);
+#else
+			munmap(mapping, length);
+#endif
+		}
+		mapping = nullptr;
+		data = nullptr;
+		length = 0;
+		buffer.clear();
+		opened = false;
+	}
+
+} // namespace ConfigLib
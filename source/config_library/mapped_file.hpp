@@ -0,0 +1,49 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace ConfigLib {
+
+// Read-only view of a whole file. The file is memory-mapped where the platform allows it,
+// otherwise it is read into an owned buffer. Either way view() stays valid until close().
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Returns false if the file cannot be opened.
+    bool open(const std::string& path);
+    // As open(), but always reads into the owned buffer. A mapping faults with SIGBUS once the
+    // file is truncated under it, so files that may be rewritten in place while in use, such as
+    // one being reloaded, are best read this way.
+    bool read(const std::string& path);
+    void close();
+
+    bool isOpen() const { return opened; }
+    bool isMapped() const { return mapping != nullptr; }
+    std::string_view view() const { return std::string_view(data, length); }
+    size_t size() const { return length; }
+
+private:
+    bool readFallback(const std::string& path);
+    void swap(MappedFile& other) noexcept;
+
+    const char* data = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr;
+    std::string buffer;
+    bool opened = false;
+};
+
+} // namespace ConfigLib
+
+#endif // MAPPED_FILE_H
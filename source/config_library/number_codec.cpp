@@ -0,0 +1,136 @@
+#include "number_codec.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace ConfigLib {
+	namespace NumberCodec {
+
+		namespace {
+			std::string_view trimBlanks(std::string_view text) {
+				while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+				while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+				return text;
+			}
+
+			// from_chars rejects a leading '+', which users reasonably write in config files
+			std::string_view skipPlus(std::string_view text) {
+				if (text.size() > 1 && text.front() == '+' && text[1] != '-' && text[1] != '+') {
+					text.remove_prefix(1);
+				}
+				return text;
+			}
+		}
+
+		bool parseDouble(std::string_view text, double& out) {
+			text = skipPlus(trimBlanks(text));
+			if (text.empty()) return false;
+
+			double value = 0.0;
+			const char* end = text.data() + text.size();
+			auto result = std::from_chars(text.data(), end, value, std::chars_format::general);
+			if (result.ec != std::errc() || result.ptr != end) return false;
+			out = value;
+			return true;
+		}
+
+		bool parseInt(std::string_view text, int& out) {
+			text = skipPlus(trimBlanks(text));
+			if (text.empty()) return false;
+
+			int value = 0;
+			const char* end = text.data() + text.size();
+			auto result = std::from_chars(text.data(), end, value);
+			if (result.ec == std::errc() && result.ptr == end) {
+				out = value;
+				return true;
+			}
+			if (result.ec == std::errc::result_out_of_range) return false;
+
+			// Fall back for integral values written in decimal or scientific form
+			double decimal = 0.0;
+			if (!parseDouble(text, decimal)) return false;
+			if (!std::isfinite(decimal) || decimal != std::trunc(decimal)) return false;
+			if (decimal < static_cast<double>(std::numeric_limits<int>::min())
+				|| decimal > static_cast<double>(std::numeric_limits<int>::max())) {
+				return false;
+			}
+			out = static_cast<int>(decimal);
+			return true;
+		}
+
+		namespace {
+			// The result is built in a vector sharing out's allocator and swapped in on success
+			template<typename Vector>
+			bool parseList(std::string_view text, Vector& out) {
+				Vector values(out.get_allocator());
+				values.reserve(static_cast<size_t>(std::count(text.begin(), text.end(), ',')) + 1);
+				while (!text.empty()) {
+					const auto comma = text.find(',');
+					std::string_view element = trimBlanks(text.substr(0, comma));
+					text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+					if (element.empty()) continue;
+
+					double value = 0.0;
+					if (!parseDouble(element, value)) return false;
+					values.push_back(value);
+				}
+				out.swap(values);
+				return true;
+			}
+
+			std::string formatList(const double* values, size_t count) {
+				std::string out;
+				out.reserve(count * 8);
+				for (size_t i = 0; i < count; ++i) {
+					if (i > 0) out += ',';
+					appendDouble(out, values[i]);
+				}
+				return out;
+			}
+		}
+
+		bool parseDoubleList(std::string_view text, std::vector<double>& out) {
+			return parseList(text, out);
+		}
+
+		bool parseDoubleList(std::string_view text, DoubleList& out) {
+			return parseList(text, out);
+		}
+
+		void appendInt(std::string& out, int value) {
+			char buffer[16];
+			auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out.append(buffer, result.ptr);
+		}
+
+		void appendDouble(std::string& out, double value) {
+			// Large enough for the longest shortest-form double, e.g. "-2.2250738585072014e-308"
+			char buffer[32];
+			auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out.append(buffer, result.ptr);
+		}
+
+		std::string formatInt(int value) {
+			std::string out;
+			appendInt(out, value);
+			return out;
+		}
+
+		std::string formatDouble(double value) {
+			std::string out;
+			appendDouble(out, value);
+			return out;
+		}
+
+		std::string formatDoubleList(const std::vector<double>& values) {
+			return formatList(values.data(), values.size());
+		}
+
+		std::string formatDoubleList(const DoubleList& values) {
+			return formatList(values.data(), values.size());
+		}
+
+	}
+} // namespace ConfigLib
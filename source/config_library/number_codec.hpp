@@ -0,0 +1,37 @@
+#ifndef NUMBER_CODEC_H
+#define NUMBER_CODEC_H
+
+#include "double_list.hpp"
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ConfigLib {
+namespace NumberCodec {
+
+    // Locale-independent parsing. The whole input must be consumed (surrounding spaces and
+    // tabs are ignored) and failures are reported through the return value, never by throwing.
+
+    // Accepts a leading '+' or '-'. Decimal forms with no fractional part, such as "500.0"
+    // or "5e2", are accepted as long as the value fits in an int.
+    bool parseInt(std::string_view text, int& out);
+    // Accepts a leading '+', fixed and scientific notation, "inf" and "nan".
+    bool parseDouble(std::string_view text, double& out);
+    // Comma-separated doubles. Empty elements are skipped, as the loader always has.
+    bool parseDoubleList(std::string_view text, std::vector<double>& out);
+    bool parseDoubleList(std::string_view text, DoubleList& out);
+
+    // Shortest text that parses back to exactly the same value.
+    std::string formatInt(int value);
+    std::string formatDouble(double value);
+    std::string formatDoubleList(const std::vector<double>& values);
+    std::string formatDoubleList(const DoubleList& values);
+
+    void appendInt(std::string& out, int value);
+    void appendDouble(std::string& out, double value);
+
+} // namespace NumberCodec
+} // namespace ConfigLib
+
+#endif // NUMBER_CODEC_H
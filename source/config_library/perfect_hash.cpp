@@ -0,0 +1,79 @@
+#include "perfect_hash.hpp"
+#include <algorithm>
+
+namespace ConfigLib {
+
+	bool PerfectHash::build(const std::vector<uint64_t>& hashes) {
+		clear();
+		if (hashes.empty()) return true;
+		if (hashes.size() >= (size_t(1) << 32)) return false;
+		{
+			// Two equal hashes share every slot under every seed
+			std::vector<uint64_t> sorted(hashes);
+			std::sort(sorted.begin(), sorted.end());
+			if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return false;
+		}
+
+		const size_t n = hashes.size();
+		const size_t bucketCount = n / kKeysPerBucket + 1;
+		// Members of each bucket, as a counting sort of the hashes' indexes by bucket
+		std::vector<uint32_t> bucketStart(bucketCount + 1, 0);
+		for (uint64_t hash : hashes) ++bucketStart[reduce(hash, bucketCount) + 1];
+		for (size_t b = 0; b < bucketCount; ++b) bucketStart[b + 1] += bucketStart[b];
+		std::vector<uint32_t> members(n);
+		{
+			std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+			for (size_t i = 0; i < n; ++i) members[fill[reduce(hashes[i], bucketCount)]++] = static_cast<uint32_t>(i);
+		}
+		std::vector<uint32_t> order(bucketCount);
+		for (size_t b = 0; b < bucketCount; ++b) order[b] = static_cast<uint32_t>(b);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+		});
+
+		// Placing into a table a little larger than n leaves the last buckets free slots to find
+		const size_t size = n + n / 16 + 1;
+		seeds.assign(bucketCount, 0);
+		std::vector<bool> taken(size, false);
+		std::vector<size_t> placed;
+		for (uint32_t bucket : order) {
+			const uint32_t begin = bucketStart[bucket];
+			const uint32_t end = bucketStart[bucket + 1];
+			if (begin == end) break;
+			uint32_t seed = 0;
+			for (;; ++seed) {
+				if (seed == kMaxSeed) {
+					clear();
+					return false;
+				}
+				placed.clear();
+				for (uint32_t m = begin; m < end; ++m) {
+					const size_t slot = reduce(mix(hashes[members[m]], seed), size);
+					if (taken[slot] || std::find(placed.begin(), placed.end(), slot) != placed.end()) break;
+					placed.push_back(slot);
+				}
+				if (placed.size() == end - begin) break;
+			}
+			seeds[bucket] = seed;
+			for (size_t slot : placed) taken[slot] = true;
+		}
+		remap.assign(size - n, 0);
+		size_t free = 0;
+		for (size_t slot = n; slot < size; ++slot) {
+			if (!taken[slot]) continue;
+			while (taken[free]) ++free;
+			remap[slot - n] = static_cast<uint32_t>(free++);
+		}
+		slotCount = n;
+		tableSize = size;
+		return true;
+	}
+
+	void PerfectHash::clear() {
+		seeds.clear();
+		remap.clear();
+		slotCount = 0;
+		tableSize = 0;
+	}
+
+} // namespace ConfigLib
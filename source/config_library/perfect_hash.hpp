@@ -0,0 +1,53 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ConfigLib {
+
+// Minimal perfect hash of a fixed set of 64-bit hashes: n distinct hashes map to the n slots
+// 0..n-1 without collisions. Built by hash and displace: the hashes are split into buckets of
+// about three, and each bucket, largest first, gets the first seed under which all its hashes
+// land on free slots of a table slightly larger than n; the few slots past n are then mapped
+// onto the free ones below it. A lookup is the bucket's seed and one mix, whatever the set.
+// Hashes outside the set also map to some slot, so callers compare what they find there.
+class PerfectHash {
+public:
+    // Returns false, and stays empty, if hashes holds a duplicate or a bucket finds no seed.
+    bool build(const std::vector<uint64_t>& hashes);
+    void clear();
+    bool empty() const { return slotCount == 0; }
+    size_t size() const { return slotCount; }
+
+    size_t slot(uint64_t hash) const {
+        const size_t slot = reduce(mix(hash, seeds[reduce(hash, seeds.size())]), tableSize);
+        return slot < slotCount ? slot : remap[slot - slotCount];
+    }
+
+private:
+    static constexpr size_t kKeysPerBucket = 3;
+    static constexpr uint32_t kMaxSeed = 1u << 24;
+
+    // Maps the high 32 bits of value onto [0, n) without a division
+    static size_t reduce(uint64_t value, size_t n) {
+        return static_cast<size_t>(((value >> 32) * n) >> 32);
+    }
+    static uint64_t mix(uint64_t hash, uint32_t seed) {
+        uint64_t x = hash + seed * 0x9e3779b97f4a7c15ull;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        return x ^ (x >> 29);
+    }
+
+    std::vector<uint32_t> seeds;
+    // Slots [slotCount, tableSize) taken while placing, each moved to a free slot below slotCount
+    std::vector<uint32_t> remap;
+    size_t slotCount = 0;
+    size_t tableSize = 0;
+};
+
+} // namespace ConfigLib
+
+#endif // PERFECT_HASH_H
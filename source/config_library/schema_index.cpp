@@ -0,0 +1,95 @@
+#include "schema_index.hpp"
+#include "config_reader.hpp"
+#include "config_log.hpp"
+
+namespace ConfigLib {
+	namespace ConfigGen {
+
+		SchemaIndex::SchemaIndex(const SchemaIndex& other) {
+			*this = other;
+		}
+
+		SchemaIndex& SchemaIndex::operator=(const SchemaIndex& other) {
+			if (this != &other) {
+				clear();
+				for (const auto& name : other.sectionNames) {
+					sectionTable(name);
+				}
+				for (const auto& entry : other.entries) {
+					insert(entry);
+				}
+				buildKeyHash();
+			}
+			return *this;
+		}
+
+		void SchemaIndex::build(const std::vector<ConfigSection>& configSections) {
+			clear();
+			for (const auto& section : configSections) {
+				sectionTable(section.name).reserve(section.items.size());
+				for (const auto& item : section.items) {
+					SchemaEntry entry;
+					entry.section = section.name;
+					entry.key = item.name;
+					entry.type = parseValueType(item.type);
+					entry.defaultValue = item.defaultValue ? item.defaultValue : "";
+					entry.validationRule = item.validationRule;
+					if (entry.validationRule) entry.check = entry.validationRule->bind(entry.type);
+					insert(std::move(entry));
+				}
+			}
+			buildKeyHash();
+		}
+
+		void SchemaIndex::insert(SchemaEntry entry) {
+			KeyTable& keys = sectionTable(entry.section);
+			// The loader used to stop at the first match, so the first declaration of a key wins
+			if (keys.find(entry.key) != keys.end()) return;
+			entries.push_back(std::move(entry));
+			const SchemaEntry& stored = entries.back();
+			keys.emplace(std::string_view(stored.key), &stored);
+		}
+
+		void SchemaIndex::buildKeyHash() {
+			std::vector<uint64_t> hashes;
+			hashes.reserve(entries.size());
+			for (const auto& entry : entries) hashes.push_back(hashKey(entry.section, entry.key));
+			if (!keyHash.build(hashes)) {
+				// Practically only two keys with equal 64-bit hashes get here; find() still works
+				CONFIG_LOG_WARN("No perfect hash for the " << entries.size() << " keys of the schema; keys are looked up by section");
+				return;
+			}
+			keySlots.resize(entries.size());
+			for (size_t i = 0; i < entries.size(); ++i) {
+				keySlots[keyHash.slot(hashes[i])] = {hashes[i], &entries[i], static_cast<uint32_t>(i)};
+			}
+		}
+
+		SchemaIndex::KeyTable& SchemaIndex::sectionTable(const std::string& section) {
+			auto it = sections.find(section);
+			if (it != sections.end()) return it->second;
+			sectionNames.push_back(section);
+			return sections[std::string_view(sectionNames.back())];
+		}
+
+		void SchemaIndex::clear() {
+			keySlots.clear();
+			keyHash.clear();
+			sections.clear();
+			entries.clear();
+			sectionNames.clear();
+		}
+
+		const SchemaIndex::KeyTable* SchemaIndex::findSection(std::string_view section) const {
+			auto it = sections.find(section);
+			return it != sections.end() ? &it->second : nullptr;
+		}
+
+		const SchemaEntry* SchemaIndex::find(const KeyTable* keys, std::string_view key) {
+			if (!keys) return nullptr;
+			auto it = keys->find(key);
+			return it != keys->end() ? it->second : nullptr;
+		}
+
+	}
+} // namespace ConfigLib
@@ -0,0 +1,106 @@
+#ifndef SCHEMA_INDEX_H
+#define SCHEMA_INDEX_H
+
+#include "value_type.hpp"
+#include "validation_rules.hpp"
+#include "hash_bytes.hpp"
+#include "perfect_hash.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ConfigLib {
+namespace ConfigGen {
+
+struct ConfigSection;
+
+// One schema item with its type name already decoded.
+struct SchemaEntry {
+    std::string section;
+    std::string key;
+    ValueType type;
+    std::string defaultValue;
+    const ValidationRules::Rule* validationRule;
+    ValidationRules::Check check;           // validationRule bound to type
+};
+
+// Compiled view of ConfigReader::getConfigSections(), built once per initialize()
+// so that the loader can resolve (section, key) pairs without rescanning the schema.
+// Lookups take string_views, so tokens can be resolved without building std::strings.
+// Besides a table per section, the index keeps a minimal perfect hash of all (section, key)
+// pairs, which finds a key of the schema with one hash of the pair and one probe.
+class SchemaIndex {
+public:
+    using KeyTable = std::unordered_map<std::string_view, const SchemaEntry*>;
+
+    static constexpr uint32_t kNotFound = 0xffffffffu;
+
+    SchemaIndex() = default;
+    SchemaIndex(const SchemaIndex& other);
+    SchemaIndex& operator=(const SchemaIndex& other);
+    SchemaIndex(SchemaIndex&&) = default;
+    SchemaIndex& operator=(SchemaIndex&&) = default;
+
+    void build(const std::vector<ConfigSection>& sections);
+    void clear();
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+
+    // Section lookups are meant to be done once per [Section] header in the loader.
+    const KeyTable* findSection(std::string_view section) const;
+    const SchemaEntry* find(std::string_view section, std::string_view key) const {
+        if (keySlots.empty()) return find(findSection(section), key);
+        const KeySlot* slot = findSlot(section, key);
+        return slot ? slot->entry : nullptr;
+    }
+    static const SchemaEntry* find(const KeyTable* keys, std::string_view key);
+    // Position of the key in getEntries(), which is also its KeyId; kNotFound if the key is not
+    // part of the schema, or if the perfect hash could not be built.
+    uint32_t findPosition(std::string_view section, std::string_view key) const {
+        const KeySlot* slot = findSlot(section, key);
+        return slot ? slot->position : kNotFound;
+    }
+
+    // Entries in declaration order. Addresses are stable for the lifetime of the index.
+    const std::deque<SchemaEntry>& getEntries() const { return entries; }
+
+private:
+    struct KeySlot {
+        uint64_t hash;
+        const SchemaEntry* entry;
+        uint32_t position;
+    };
+
+    static uint64_t hashKey(std::string_view section, std::string_view key) {
+        return hashBytes(key, hashBytes(section));
+    }
+
+    void insert(SchemaEntry entry);
+    KeyTable& sectionTable(const std::string& section);
+    // Builds keyHash and keySlots over entries; called whenever entries change.
+    void buildKeyHash();
+    const KeySlot* findSlot(std::string_view section, std::string_view key) const {
+        if (keySlots.empty()) return nullptr;
+        const uint64_t hash = hashKey(section, key);
+        const KeySlot& slot = keySlots[keyHash.slot(hash)];
+        // Keys outside the schema land on some slot as well
+        if (slot.hash != hash || slot.entry->key != key || slot.entry->section != section) return nullptr;
+        return &slot;
+    }
+
+    // The maps' keys are views into these, so both containers must never relocate elements
+    std::deque<SchemaEntry> entries;
+    std::deque<std::string> sectionNames;
+    std::unordered_map<std::string_view, KeyTable> sections;
+    PerfectHash keyHash;
+    // Indexed by keyHash; empty if the hash could not be built, when lookups use the tables
+    std::vector<KeySlot> keySlots;
+};
+
+} // namespace ConfigGen
+} // namespace ConfigLib
+
+#endif // SCHEMA_INDEX_H
@@ -0,0 +1,152 @@
+#include "stored_value.hpp"
+#include "config_reader.hpp"
+#include "number_codec.hpp"
+#include <stdexcept>
+
+namespace ConfigLib {
+
+	void StoredValue::set(int value, std::pmr::memory_resource*) {
+		storage = value;
+	}
+
+	void StoredValue::set(double value, std::pmr::memory_resource*) {
+		storage = value;
+	}
+
+	void StoredValue::set(std::string_view value, std::pmr::memory_resource* resource) {
+		if (auto* current = std::get_if<std::pmr::string>(&storage)) {
+			current->assign(value.data(), value.size());
+		} else {
+			storage.emplace<std::pmr::string>(value.data(), value.size(), resource);
+		}
+	}
+
+	void StoredValue::set(const std::vector<double>& value, std::pmr::memory_resource* resource) {
+		set(value.data(), value.size(), resource);
+	}
+
+	void StoredValue::set(const double* values, size_t count, std::pmr::memory_resource* resource) {
+		if (auto* current = std::get_if<DoubleList>(&storage)) {
+			current->assign(values, values + count);
+		} else {
+			storage.emplace<DoubleList>(values, values + count, resource);
+		}
+	}
+
+	void StoredValue::setExternal(std::string_view path) {
+		storage.emplace<ExternalRef>(ExternalRef{std::make_shared<const ExternalArray>(std::string(path))});
+	}
+
+	DoubleSpan StoredValue::getArray() const {
+		if (const auto* list = std::get_if<DoubleList>(&storage)) return DoubleSpan(list->data(), list->size());
+		if (const auto* external = std::get_if<ExternalRef>(&storage)) return external->array->get();
+		return DoubleSpan();
+	}
+
+	void StoredValue::assign(const StoredValue& other, std::pmr::memory_resource* resource) {
+		if (const auto* text = std::get_if<std::pmr::string>(&other.storage)) {
+			set(std::string_view(*text), resource);
+		} else if (const auto* list = std::get_if<DoubleList>(&other.storage)) {
+			set(list->data(), list->size(), resource);
+		} else {
+			storage = other.storage;
+		}
+	}
+
+	void StoredValue::fromString(const std::string& str, std::pmr::memory_resource* resource) {
+		if (empty()) {
+			set(std::string_view(str), resource);
+			return;
+		}
+		switch (type()) {
+			case ValueType::Int:
+				if (!NumberCodec::parseInt(str, std::get<int>(storage))) {
+					throw std::invalid_argument("Invalid integer: " + str);
+				}
+				break;
+			case ValueType::Double:
+				if (!NumberCodec::parseDouble(str, std::get<double>(storage))) {
+					throw std::invalid_argument("Invalid number: " + str);
+				}
+				break;
+			case ValueType::String:
+				std::get<std::pmr::string>(storage).assign(str);
+				break;
+			case ValueType::DoubleVector: {
+				const std::string_view path = ExternalArray::referencedPath(str);
+				if (!path.empty()) {
+					setExternal(path);
+					break;
+				}
+				// An external list becomes an inline one
+				if (isExternal()) storage.emplace<DoubleList>(resource);
+				if (!NumberCodec::parseDoubleList(str, std::get<DoubleList>(storage))) {
+					throw std::invalid_argument("Invalid number list: " + str);
+				}
+				break;
+			}
+		}
+	}
+
+	bool StoredValue::parse(ValueType type, std::string_view text, std::pmr::memory_resource* resource) {
+		switch (type) {
+			case ValueType::Int: {
+				int number;
+				if (!NumberCodec::parseInt(text, number)) return false;
+				storage = number;
+				return true;
+			}
+			case ValueType::Double: {
+				double number;
+				if (!NumberCodec::parseDouble(text, number)) return false;
+				storage = number;
+				return true;
+			}
+			case ValueType::String:
+				set(text, resource);
+				return true;
+			case ValueType::DoubleVector: {
+				const std::string_view path = ExternalArray::referencedPath(text);
+				if (!path.empty()) {
+					setExternal(path);
+					return true;
+				}
+				DoubleList list(resource);
+				if (!NumberCodec::parseDoubleList(text, list)) return false;
+				storage = std::move(list);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::string StoredValue::toString() const {
+		if (empty()) return std::string();
+		switch (type()) {
+			case ValueType::Int: return NumberCodec::formatInt(std::get<int>(storage));
+			case ValueType::Double: return NumberCodec::formatDouble(std::get<double>(storage));
+			case ValueType::String: break;
+			case ValueType::DoubleVector:
+				if (const auto* external = std::get_if<ExternalRef>(&storage)) return "@" + external->array->getPath();
+				return NumberCodec::formatDoubleList(std::get<DoubleList>(storage));
+		}
+		const std::pmr::string& text = std::get<std::pmr::string>(storage);
+		return std::string(text.data(), text.size());
+	}
+
+	bool StoredValue::satisfies(const ValidationRules::Check& check) const {
+		if (empty()) return false;
+		switch (type()) {
+			case ValueType::Int: return check(std::get<int>(storage));
+			case ValueType::Double: return check(std::get<double>(storage));
+			case ValueType::String: break;
+			case ValueType::DoubleVector: {
+				if (isExternal()) return true;
+				const DoubleList& list = std::get<DoubleList>(storage);
+				return check(list.data(), list.size());
+			}
+		}
+		return check(std::string_view(std::get<std::pmr::string>(storage)));
+	}
+
+} // namespace ConfigLib
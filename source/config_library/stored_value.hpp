@@ -0,0 +1,107 @@
+#ifndef STORED_VALUE_H
+#define STORED_VALUE_H
+
+#include "value_type.hpp"
+#include "double_list.hpp"
+#include "external_array.hpp"
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace ValidationRules {
+    struct Check;
+}
+
+namespace ConfigLib {
+
+// How a value read as T is held. Strings and lists allocate from the memory resource of
+// the section that owns them; lists are aligned as kListAlignment describes.
+template<typename T> struct StorageOf { using type = T; };
+template<> struct StorageOf<std::string> { using type = std::pmr::string; };
+template<> struct StorageOf<std::vector<double>> { using type = DoubleList; };
+
+template<typename T>
+using StoredType = typename StorageOf<T>::type;
+
+// A configuration value held inline: one of the four ValueTypes plus a type tag.
+// Default-constructed values are empty. A list may instead refer to an ExternalArray, which
+// copies of the value share; get<std::vector<double>>() is then null, and getArray() views it.
+// Rules are not applied to the values of an external array, which are never read up front.
+class StoredValue {
+public:
+    StoredValue() = default;
+
+    bool empty() const { return storage.index() == 0; }
+    // Type of the held value; the value must not be empty.
+    ValueType type() const {
+        return isExternal() ? ValueType::DoubleVector : static_cast<ValueType>(storage.index() - 1);
+    }
+    bool isExternal() const { return storage.index() == kExternalIndex; }
+    // The array an external list refers to; null for values held inline.
+    const ExternalArray* getExternal() const {
+        const ExternalRef* reference = std::get_if<ExternalRef>(&storage);
+        return reference ? reference->array.get() : nullptr;
+    }
+
+    // The held value if it was stored as T, null otherwise.
+    template<typename T>
+    const StoredType<T>* get() const { return std::get_if<StoredType<T>>(&storage); }
+    // The held list, stored inline or external, without a copy; an empty view for other types.
+    // Maps an external array on first use, and throws std::runtime_error if it cannot.
+    DoubleSpan getArray() const;
+
+    // Same type and same value; two empty values are equal.
+    bool operator==(const StoredValue& other) const { return storage == other.storage; }
+    bool operator!=(const StoredValue& other) const { return !(storage == other.storage); }
+
+    // Reuse the existing object, and so its address and capacity, when the type is unchanged.
+    // A string or list that replaces another type is allocated from resource.
+    void set(int value, std::pmr::memory_resource* resource);
+    void set(double value, std::pmr::memory_resource* resource);
+    void set(std::string_view value, std::pmr::memory_resource* resource);
+    void set(const std::vector<double>& value, std::pmr::memory_resource* resource);
+    void set(const double* values, size_t count, std::pmr::memory_resource* resource);
+    // Refers to the array file at path, which is not opened until the list is read.
+    void setExternal(std::string_view path);
+
+    // Copies other, allocating any string or list from resource.
+    void assign(const StoredValue& other, std::pmr::memory_resource* resource);
+    void clear() { storage.emplace<0>(); }
+
+    // Parses str as the currently held type; an empty value becomes a string.
+    // Throws std::invalid_argument if str does not parse.
+    void fromString(const std::string& str, std::pmr::memory_resource* resource);
+    // Replaces the value with text parsed as type. Returns false, leaving the value as it was,
+    // if text does not parse. Lists may be given as a "@path" reference to an ExternalArray.
+    bool parse(ValueType type, std::string_view text, std::pmr::memory_resource* resource);
+    // External arrays as their "@path" reference.
+    std::string toString() const;
+
+    // Applies a bound validation rule to the held value; an empty value never satisfies one.
+    bool satisfies(const ValidationRules::Check& check) const;
+
+private:
+    // Values referring to the same version of the same file are equal, whether or not either
+    // has been mapped
+    struct ExternalRef {
+        std::shared_ptr<const ExternalArray> array;
+
+        bool operator==(const ExternalRef& other) const {
+            return array->getPath() == other.array->getPath() && array->getStamp() == other.array->getStamp();
+        }
+    };
+
+    // Alternatives follow ValueType, offset by one for the empty state, with external lists last
+    static_assert(static_cast<int>(ValueType::Int) == 0 && static_cast<int>(ValueType::Double) == 1
+        && static_cast<int>(ValueType::String) == 2 && static_cast<int>(ValueType::DoubleVector) == 3,
+        "StoredValue alternatives must follow ValueType");
+    static constexpr size_t kExternalIndex = 5;
+    std::variant<std::monostate, int, double, std::pmr::string, DoubleList, ExternalRef> storage;
+};
+
+} // namespace ConfigLib
+
+#endif // STORED_VALUE_H
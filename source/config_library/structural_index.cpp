@@ -0,0 +1,157 @@
+#include "structural_index.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CONFIG_STRUCTURAL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ConfigLib {
+
+	namespace {
+
+		using Block = StructuralIndex::Block;
+
+		Block classifyScalar(const char* data, size_t length) {
+			Block block = {0, 0, 0, 0};
+			for (size_t i = 0; i < length; ++i) {
+				const uint64_t bit = uint64_t(1) << i;
+				switch (data[i]) {
+					case '\n': block.newlines |= bit; break;
+					case '=': block.equals |= bit; break;
+					case '#': block.hashes |= bit; break;
+					case '[': block.brackets |= bit; break;
+					default: break;
+				}
+			}
+			return block;
+		}
+
+		void buildScalar(const char* data, size_t fullBlocks, Block* out) {
+			for (size_t b = 0; b < fullBlocks; ++b) {
+				out[b] = classifyScalar(data + b * StructuralIndex::kBlockSize, StructuralIndex::kBlockSize);
+			}
+		}
+
+#ifdef CONFIG_STRUCTURAL_X86
+		__attribute__((target("sse2")))
+		inline uint64_t matchSse2(const __m128i* chunks, __m128i needle) {
+			uint64_t mask = 0;
+			for (int i = 0; i < 4; ++i) {
+				const uint64_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], needle)));
+				mask |= bits << (16 * i);
+			}
+			return mask;
+		}
+
+		__attribute__((target("sse2")))
+		void buildSse2(const char* data, size_t fullBlocks, Block* out) {
+			const __m128i newline = _mm_set1_epi8('\n');
+			const __m128i equals = _mm_set1_epi8('=');
+			const __m128i hash = _mm_set1_epi8('#');
+			const __m128i bracket = _mm_set1_epi8('[');
+
+			for (size_t b = 0; b < fullBlocks; ++b) {
+				const char* block = data + b * StructuralIndex::kBlockSize;
+				__m128i chunks[4];
+				for (int i = 0; i < 4; ++i) {
+					chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+				}
+				out[b].newlines = matchSse2(chunks, newline);
+				out[b].equals = matchSse2(chunks, equals);
+				out[b].hashes = matchSse2(chunks, hash);
+				out[b].brackets = matchSse2(chunks, bracket);
+			}
+		}
+
+		__attribute__((target("avx2")))
+		inline uint64_t matchAvx2(__m256i low, __m256i high, __m256i needle) {
+			const uint64_t lowBits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle)));
+			const uint64_t highBits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)));
+			return lowBits | (highBits << 32);
+		}
+
+		__attribute__((target("avx2")))
+		void buildAvx2(const char* data, size_t fullBlocks, Block* out) {
+			const __m256i newline = _mm256_set1_epi8('\n');
+			const __m256i equals = _mm256_set1_epi8('=');
+			const __m256i hash = _mm256_set1_epi8('#');
+			const __m256i bracket = _mm256_set1_epi8('[');
+
+			for (size_t b = 0; b < fullBlocks; ++b) {
+				const char* block = data + b * StructuralIndex::kBlockSize;
+				const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+				const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+				out[b].newlines = matchAvx2(low, high, newline);
+				out[b].equals = matchAvx2(low, high, equals);
+				out[b].hashes = matchAvx2(low, high, hash);
+				out[b].brackets = matchAvx2(low, high, bracket);
+			}
+		}
+#endif
+
+	}
+
+	bool StructuralIndex::isSupported(Kernel kernel) {
+		switch (kernel) {
+			case Kernel::Auto:
+			case Kernel::Scalar:
+				return true;
+#ifdef CONFIG_STRUCTURAL_X86
+			case Kernel::SSE2:
+				return __builtin_cpu_supports("sse2");
+			case Kernel::AVX2:
+				return __builtin_cpu_supports("avx2");
+#else
+			case Kernel::SSE2:
+			case Kernel::AVX2:
+				return false;
+#endif
+		}
+		return false;
+	}
+
+	StructuralIndex::Kernel StructuralIndex::bestKernel() {
+		static const Kernel best = isSupported(Kernel::AVX2) ? Kernel::AVX2
+			: isSupported(Kernel::SSE2) ? Kernel::SSE2
+			: Kernel::Scalar;
+		return best;
+	}
+
+	const char* StructuralIndex::kernelName(Kernel kernel) {
+		switch (kernel) {
+			case Kernel::Auto: return kernelName(bestKernel());
+			case Kernel::Scalar: return "scalar";
+			case Kernel::SSE2: return "sse2";
+			case Kernel::AVX2: return "avx2";
+		}
+		return "unknown";
+	}
+
+	void StructuralIndex::build(std::string_view input, std::vector<Block>& blocks, Kernel kernel) {
+		if (kernel == Kernel::Auto || !isSupported(kernel)) kernel = bestKernel();
+
+		const size_t fullBlocks = input.size() / kBlockSize;
+		const size_t tail = input.size() % kBlockSize;
+		blocks.resize(fullBlocks + (tail ? 1 : 0));
+
+		switch (kernel) {
+#ifdef CONFIG_STRUCTURAL_X86
+			case Kernel::AVX2:
+				buildAvx2(input.data(), fullBlocks, blocks.data());
+				break;
+			case Kernel::SSE2:
+				buildSse2(input.data(), fullBlocks, blocks.data());
+				break;
+#endif
+			default:
+				buildScalar(input.data(), fullBlocks, blocks.data());
+				break;
+		}
+
+		// The last partial block is classified without reading past the end of the input
+		if (tail) {
+			blocks[fullBlocks] = classifyScalar(input.data() + fullBlocks * kBlockSize, tail);
+		}
+	}
+
+} // namespace ConfigLib
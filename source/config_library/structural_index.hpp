@@ -0,0 +1,59 @@
+#ifndef STRUCTURAL_INDEX_H
+#define STRUCTURAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace ConfigLib {
+
+// Bitmap of the characters that delimit INI tokens, classified 16 or 32 bytes at a time.
+// Each 64-byte block of input gets one bit per byte for line ends, '=', '#' and '['. The last
+// lets a pre-scan find section headers without visiting every line; closing brackets are only
+// checked at the end of a header and list commas are split by NumberCodec, so neither needs
+// indexing.
+class StructuralIndex {
+public:
+    enum class Kernel {
+        Auto,     // best kernel the running CPU supports
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    struct Block {
+        uint64_t newlines;
+        uint64_t equals;
+        uint64_t hashes;
+        uint64_t brackets;
+    };
+
+    static constexpr size_t kBlockSize = 64;
+
+    // Index of the lowest set bit; mask must be non-zero.
+    static unsigned lowestBit(uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    static Kernel bestKernel();
+    static bool isSupported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+
+    // Replaces blocks with one entry per 64 bytes of input; bit i of block b is byte 64 * b + i.
+    static void build(std::string_view input, std::vector<Block>& blocks, Kernel kernel = Kernel::Auto);
+};
+
+} // namespace ConfigLib
+
+#endif // STRUCTURAL_INDEX_H
@@ -1,10 +1,68 @@
 #include "validation_rules.hpp"
 #include "config_reader.hpp"
+#include "number_codec.hpp"
 #include <algorithm>
+#include <limits>
 #include <sstream>
 
 namespace ValidationRules {
 
+	namespace {
+		// Numeric bounds; a string item is checked on its parsed value, a list on every element
+		Check rangeCheck(const Rule* rule, double min, bool minInclusive, double max, bool maxInclusive) {
+			Check check;
+			check.kind = Check::Kind::Range;
+			check.min = min;
+			check.minInclusive = minInclusive;
+			check.max = max;
+			check.maxInclusive = maxInclusive;
+			check.rule = rule;
+			return check;
+		}
+
+		const double kInfinity = std::numeric_limits<double>::infinity();
+	}
+
+	bool Check::operator()(std::string_view value) const {
+		switch (kind) {
+			case Kind::Pass: return true;
+			case Kind::Range: {
+				double number;
+				return ConfigLib::NumberCodec::parseDouble(value, number) && inRange(number);
+			}
+			case Kind::OneOf: return std::find(values->begin(), values->end(), value) != values->end();
+			case Kind::Fail: return false;
+			case Kind::Custom: break;
+		}
+		return (*rule)(ConfigLib::TypedConfigValue<std::string>(std::string(value)));
+	}
+
+	bool Check::operator()(const double* list, size_t count) const {
+		switch (kind) {
+			case Kind::Pass: return true;
+			case Kind::Range: return std::all_of(list, list + count, [this](double value) { return inRange(value); });
+			case Kind::OneOf:
+			case Kind::Fail: return false;
+			case Kind::Custom: break;
+		}
+		return (*rule)(ConfigLib::TypedConfigValue<std::vector<double>>(std::vector<double>(list, list + count)));
+	}
+
+	bool Check::custom(int value) const {
+		return (*rule)(ConfigLib::TypedConfigValue<int>(value));
+	}
+
+	bool Check::custom(double value) const {
+		return (*rule)(ConfigLib::TypedConfigValue<double>(value));
+	}
+
+	Check Rule::bind(ConfigLib::ValueType) const {
+		Check check;
+		check.kind = Check::Kind::Custom;
+		check.rule = this;
+		return check;
+	}
+
 	bool GreaterThanZero::operator()(const ConfigLib::ConfigValue& value) const {
 		if (const auto* intValue = dynamic_cast<const ConfigLib::TypedConfigValue<int>*>(&value)) {
             return intValue->getValue() > 0;
@@ -13,14 +71,15 @@ namespace ValidationRules {
             return doubleValue->getValue() > 0;
         }
         if (const auto* stringValue = dynamic_cast<const ConfigLib::TypedConfigValue<std::string>*>(&value)) {
-            try {
-                return std::stod(stringValue->getValue()) > 0;
-            } catch (...) {
-                return false;
-            }
+            double doubleVal;
+            return ConfigLib::NumberCodec::parseDouble(stringValue->getValue(), doubleVal) && doubleVal > 0;
         }
         return false;
     }
+
+	Check GreaterThanZero::bind(ConfigLib::ValueType) const {
+		return rangeCheck(this, 0.0, false, kInfinity, true);
+	}
 	
 	bool GreaterThanOrEqualToZero::operator()(const ConfigLib::ConfigValue& value) const {
 		if (const auto* intValue = dynamic_cast<const ConfigLib::TypedConfigValue<int>*>(&value)) {
@@ -30,14 +89,15 @@ namespace ValidationRules {
             return doubleValue->getValue() >= 0;
         }
         if (const auto* stringValue = dynamic_cast<const ConfigLib::TypedConfigValue<std::string>*>(&value)) {
-            try {
-                return std::stod(stringValue->getValue()) >= 0;
-            } catch (...) {
-                return false;
-            }
+            double doubleVal;
+            return ConfigLib::NumberCodec::parseDouble(stringValue->getValue(), doubleVal) && doubleVal >= 0;
         }
         return false;
 	}
+
+	Check GreaterThanOrEqualToZero::bind(ConfigLib::ValueType) const {
+		return rangeCheck(this, 0.0, true, kInfinity, true);
+	}
 	
 	bool BetweenValues::operator()(const ConfigLib::ConfigValue& value) const {
 		if (const auto* intValue = dynamic_cast<const ConfigLib::TypedConfigValue<int>*>(&value)) {
@@ -47,15 +107,16 @@ namespace ValidationRules {
 			return doubleValue->getValue() >= min_ && doubleValue->getValue() <= max_;
 		}
 		if (const auto* stringValue = dynamic_cast<const ConfigLib::TypedConfigValue<std::string>*>(&value)) {
-			try {
-				double doubleVal = std::stod(stringValue->getValue());
-				return doubleVal >= min_ && doubleVal <= max_;
-			} catch (...) {
-				return false;
-			}
+			double doubleVal;
+			return ConfigLib::NumberCodec::parseDouble(stringValue->getValue(), doubleVal)
+				&& doubleVal >= min_ && doubleVal <= max_;
 		}
 		return false;
 	}
+
+	Check BetweenValues::bind(ConfigLib::ValueType) const {
+		return rangeCheck(this, min_, true, max_, true);
+	}
 	
 	std::string BetweenValues::toString() const {
 		std::ostringstream oss;
@@ -67,6 +128,15 @@ namespace ValidationRules {
 		const ConfigLib::TypedConfigValue<std::string>* stringValue = dynamic_cast<const ConfigLib::TypedConfigValue<std::string>*>(&value);
 		return stringValue && std::find(validValues_.begin(), validValues_.end(), stringValue->getValue()) != validValues_.end();
 	}
+
+	Check InList::bind(ConfigLib::ValueType type) const {
+		Check check;
+		// Only strings can be in the list
+		check.kind = type == ConfigLib::ValueType::String ? Check::Kind::OneOf : Check::Kind::Fail;
+		check.values = &validValues_;
+		check.rule = this;
+		return check;
+	}
 	
 	std::string InList::toString() const {
 		std::ostringstream oss;
@@ -83,12 +153,12 @@ namespace ValidationRules {
 	const GreaterThanOrEqualToZero greaterThanOrEqualToZero;
 	
 	// Factory functions for rules with parameters
-	Rule* betweenValues(double min, double max) {
-        return new BetweenValues(min, max);
+	std::unique_ptr<Rule> betweenValues(double min, double max) {
+        return std::make_unique<BetweenValues>(min, max);
     }
 	
-    Rule* inList(const std::vector<std::string>& validValues) {
-        return new InList(validValues);
+    std::unique_ptr<Rule> inList(const std::vector<std::string>& validValues) {
+        return std::make_unique<InList>(validValues);
     }
 
-} 
\ No newline at end of file
+} 
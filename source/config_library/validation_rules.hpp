@@ -1,8 +1,13 @@
 #ifndef VALIDATION_RULES_H
 #define VALIDATION_RULES_H
 
+#include "value_type.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ConfigLib {
@@ -10,23 +15,64 @@ namespace ConfigLib {
 }
 namespace ValidationRules {
 
+	class Rule;
+
+	// A rule bound by Rule::bind() to the declared type of one item. Evaluating it is a switch
+	// over a few predicate kinds, with no virtual call, dynamic_cast or exception; only
+	// numeric rules on string items parse, and then without throwing. Rules that have no typed
+	// form are bound as Custom and still go through Rule::operator().
+	struct Check {
+		enum class Kind : uint8_t { Pass, Range, OneOf, Fail, Custom };
+
+		Kind kind = Kind::Pass;
+		bool minInclusive = true;
+		bool maxInclusive = true;
+		double min = 0.0;
+		double max = 0.0;
+		const std::vector<std::string>* values = nullptr;   // OneOf
+		const Rule* rule = nullptr;                         // the bound rule, null for Pass
+
+		bool operator()(int value) const {
+			return kind == Kind::Range ? inRange(value) : kind == Kind::Pass || (kind == Kind::Custom && custom(value));
+		}
+		bool operator()(double value) const {
+			return kind == Kind::Range ? inRange(value) : kind == Kind::Pass || (kind == Kind::Custom && custom(value));
+		}
+		bool operator()(std::string_view value) const;
+		bool operator()(const double* values, size_t count) const;
+		bool operator()(const std::vector<double>& values) const { return (*this)(values.data(), values.size()); }
+
+		bool inRange(double value) const {
+			return (minInclusive ? value >= min : value > min) && (maxInclusive ? value <= max : value < max);
+		}
+
+	private:
+		bool custom(int value) const;
+		bool custom(double value) const;
+	};
+
 	class Rule {
     public:
         virtual ~Rule() {}
         virtual bool operator()(const ConfigLib::ConfigValue& value) const = 0;
         virtual std::string toString() const = 0;
+        // The rule as a Check for items of the given type. Bound once per schema item; the
+        // default binds to operator().
+        virtual Check bind(ConfigLib::ValueType type) const;
     };
 	
 	class GreaterThanZero : public Rule {
     public:
         bool operator()(const ConfigLib::ConfigValue& value) const override;
         std::string toString() const override { return "Must be greater than zero"; }
+        Check bind(ConfigLib::ValueType type) const override;
     };
 	
 	class GreaterThanOrEqualToZero : public Rule {
 	public:
 		bool operator()(const ConfigLib::ConfigValue& value) const override;
 		std::string toString() const override { return "Must be greater than or equal to zero"; }
+		Check bind(ConfigLib::ValueType type) const override;
 	};
 	
 	class BetweenValues : public Rule {
@@ -34,6 +80,7 @@ namespace ValidationRules {
 		BetweenValues(double min, double max) : min_(min), max_(max) {}
 		bool operator()(const ConfigLib::ConfigValue& value) const override;
 		std::string toString() const override;
+		Check bind(ConfigLib::ValueType type) const override;
 	private:
 		double min_;
 		double max_;
@@ -44,6 +91,7 @@ namespace ValidationRules {
 		InList(const std::vector<std::string>& validValues) : validValues_(validValues) {}
 		bool operator()(const ConfigLib::ConfigValue& value) const override;
 		std::string toString() const override;
+		Check bind(ConfigLib::ValueType type) const override;
 	private:
 		std::vector<std::string> validValues_;
 	};
@@ -52,10 +100,11 @@ namespace ValidationRules {
 	extern const GreaterThanZero greaterThanZero;
 	extern const GreaterThanOrEqualToZero greaterThanOrEqualToZero;
 	
-	// functions for "core" supported rules with parameters
-	Rule* betweenValues(double min, double max);
-    Rule* inList(const std::vector<std::string>& validValues);
+	// functions for "core" supported rules with parameters. Schema items only point at rules,
+	// so the caller keeps the returned rule alive for as long as any reader uses it.
+	std::unique_ptr<Rule> betweenValues(double min, double max);
+    std::unique_ptr<Rule> inList(const std::vector<std::string>& validValues);
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,46 @@
+#ifndef VALUE_TYPE_H
+#define VALUE_TYPE_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ConfigLib {
+
+// Decoded form of the ConfigItem::type strings used by the schema.
+enum class ValueType {
+    Int,
+    Double,
+    String,
+    DoubleVector
+};
+
+// Unknown type names are treated as strings, matching the loader's historical behaviour.
+inline ValueType parseValueType(const char* typeName) {
+    if (!typeName) return ValueType::String;
+    if (std::strcmp(typeName, "double") == 0) return ValueType::Double;
+    if (std::strcmp(typeName, "int") == 0) return ValueType::Int;
+    if (std::strcmp(typeName, "vector<double>") == 0) return ValueType::DoubleVector;
+    return ValueType::String;
+}
+
+// The ValueType stored for each C++ type accepted by getValue/setValue.
+template<typename T> struct ValueTypeOf;
+template<> struct ValueTypeOf<int> { static constexpr ValueType value = ValueType::Int; };
+template<> struct ValueTypeOf<double> { static constexpr ValueType value = ValueType::Double; };
+template<> struct ValueTypeOf<std::string> { static constexpr ValueType value = ValueType::String; };
+template<> struct ValueTypeOf<std::vector<double>> { static constexpr ValueType value = ValueType::DoubleVector; };
+
+inline const char* valueTypeName(ValueType type) {
+    switch (type) {
+        case ValueType::Int: return "int";
+        case ValueType::Double: return "double";
+        case ValueType::DoubleVector: return "vector<double>";
+        case ValueType::String: break;
+    }
+    return "string";
+}
+
+} // namespace ConfigLib
+
+#endif // VALUE_TYPE_H
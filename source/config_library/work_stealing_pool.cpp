@@ -0,0 +1,111 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+namespace ConfigLib {
+
+	namespace {
+		thread_local bool runningTask = false;
+	}
+
+	WorkStealingPool::WorkStealingPool(unsigned threads) {
+		if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+		// Queue 0 belongs to the thread calling run()
+		for (unsigned i = 1; i < threads; ++i) workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+	}
+
+	WorkStealingPool::~WorkStealingPool() {
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers) worker.join();
+	}
+
+	void WorkStealingPool::run(size_t count, const std::function<void(size_t)>& work) {
+		if (count == 0) return;
+		std::lock_guard<std::mutex> running(runMutex);
+
+		const size_t threads = queues.size();
+		for (size_t i = 0; i < threads; ++i) {
+			std::lock_guard<std::mutex> lock(queues[i]->mutex);
+			queues[i]->begin = count * i / threads;
+			queues[i]->end = count * (i + 1) / threads;
+		}
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			task = &work;
+			error = nullptr;
+			busy = static_cast<unsigned>(workers.size());
+			++batch;
+		}
+		wake.notify_all();
+
+		drain(0);
+
+		std::unique_lock<std::mutex> lock(stateMutex);
+		// Workers may still be running tasks they took before the queues ran dry
+		finished.wait(lock, [this] { return busy == 0; });
+		task = nullptr;
+		if (error) std::rethrow_exception(error);
+	}
+
+	void WorkStealingPool::workerLoop(unsigned self) {
+		size_t seen = 0;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(stateMutex);
+				wake.wait(lock, [this, seen] { return stopping || batch != seen; });
+				if (stopping) return;
+				seen = batch;
+			}
+			drain(self);
+			std::lock_guard<std::mutex> lock(stateMutex);
+			if (--busy == 0) finished.notify_one();
+		}
+	}
+
+	bool WorkStealingPool::isRunningTask() {
+		return runningTask;
+	}
+
+	void WorkStealingPool::drain(unsigned self) {
+		// The caller of run() may itself be a task of another pool
+		const bool outer = runningTask;
+		runningTask = true;
+		size_t index;
+		while (take(self, index)) {
+			try {
+				(*task)(index);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(stateMutex);
+				if (!error) error = std::current_exception();
+			}
+		}
+		runningTask = outer;
+	}
+
+	bool WorkStealingPool::take(unsigned self, size_t& index) {
+		{
+			Queue& own = *queues[self];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (own.begin < own.end) {
+				index = own.begin++;
+				return true;
+			}
+		}
+		// Steal from the back of the others, starting with the next thread so thieves spread out
+		const size_t threads = queues.size();
+		for (size_t offset = 1; offset < threads; ++offset) {
+			Queue& victim = *queues[(self + offset) % threads];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (victim.begin < victim.end) {
+				index = --victim.end;
+				return true;
+			}
+		}
+		return false;
+	}
+
+} // namespace ConfigLib
@@ -0,0 +1,68 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ConfigLib {
+
+// Fixed set of threads running batches of independent tasks. A batch of n tasks is split into
+// one contiguous range of indexes per thread; each thread takes tasks from the front of its own
+// range and, once that is empty, steals from the back of the others', so uneven tasks even out
+// without every task going through one shared queue. The thread calling run() works too, so a
+// pool of size 1 runs everything on the caller.
+class WorkStealingPool {
+public:
+    // threads counts the caller; 0 means one per hardware thread.
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    // Calls task(i) for every i in [0, count) and returns once all calls have finished. If any
+    // call throws, the remaining tasks still run and the first exception is rethrown. Batches
+    // from different callers run one after the other.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    // True while the calling thread runs a task of any pool. Work that would start a pool of its
+    // own should then run serially, or nested pools multiply the threads.
+    static bool isRunningTask();
+
+private:
+    // Indexes [begin, end) not yet taken; the owner takes from begin, thieves from end
+    struct Queue {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    void workerLoop(unsigned self);
+    void drain(unsigned self);
+    bool take(unsigned self, size_t& index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex runMutex;                       // one batch at a time
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* task = nullptr;
+    size_t batch = 0;                          // incremented for every batch
+    unsigned busy = 0;                         // workers still inside the current batch
+    bool stopping = false;
+    std::exception_ptr error;
+};
+
+} // namespace ConfigLib
+
+#endif // WORK_STEALING_POOL_H
@@ -4,9 +4,25 @@
 #include <fstream>
 #include <memory>
 
-class SpecificAlgorithmConfig : public ConfigLib::ConfigReader {
+namespace SpecificAlgorithm {
+    using ConfigLib::ConfigGen::Key;
+
+    const ValidationRules::BetweenValues between0And100(0, 100);
+
+    inline constexpr Key<double> abtKor{"ABT", "kor", "500.0", "ABT kor value", &ValidationRules::greaterThanZero};
+    inline constexpr Key<int> abtKoh{"ABT", "koh", "1", "ABT koh value"};
+    inline constexpr Key<double> tbmKor{"TBM", "kor", "500.0", "TBM kor value", &ValidationRules::greaterThanZero};
+    inline constexpr Key<double> fixedWing{"General", "FW", "10.0", "Fixed Wing value", &between0And100};
+    inline constexpr Key<double> rotaryWing{"General", "RW", "20.0", "Rotary Wing value", &between0And100};
+    inline constexpr Key<double> cruiseMissile{"General", "CM", "30.0", "Cruise Missile value", &between0And100};
+    inline constexpr Key<std::vector<double>> misc{"General", "Misc", "1.0,2.0,3.0", "Misc item just for proof of principle"};
+
+    inline constexpr auto schema = ConfigLib::ConfigGen::makeSchema(abtKor, abtKoh, tbmKor, fixedWing, rotaryWing, cruiseMissile, misc);
+}
+
+class SpecificAlgorithmConfig : public ConfigLib::StaticConfigReader<SpecificAlgorithm::schema> {
 public:
-    SpecificAlgorithmConfig() : ConfigReader() {
+    SpecificAlgorithmConfig() {
         std::cout << "SpecificAlgorithmConfig constructor started" << std::endl;
 		initialize();
         std::cout << "SpecificAlgorithmConfig constructor finished" << std::endl;
@@ -16,35 +32,6 @@ public:
         std::cout << "Getting config file path" << std::endl;
         return "specific_algorithm_config.ini";
     }
-
-    std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override 
-    {
-        static const ValidationRules::BetweenValues between0And100(0, 100);
-        return {
-            {
-                "ABT",
-                {
-                    {"kor", "double", "500.0", "ABT kor value", &ValidationRules::greaterThanZero},
-                    {"koh", "integer", "1", "ABT koh value", nullptr}
-                }
-            },
-            {
-                "TBM",
-                {
-                    {"kor", "double", "500.0", "TBM kor value", &ValidationRules::greaterThanZero}
-                }
-            },
-            {
-                "General",
-                {
-                    {"FW", "double", "10.0", "Fixed Wing value", &between0And100},
-                    {"RW", "double", "20.0", "Rotary Wing value", &between0And100},
-                    {"CM", "double", "30.0", "Cruise Missile value", &between0And100},
-                    {"Misc", "vector<double>", "1.0,2.0,3.0", "Misc item just for proof of principle", nullptr}
-                }
-            }
-        };
-    }
 };
  
 int main() {
@@ -58,17 +45,18 @@ int main() {
         // Print out the loaded configuration
         std::cout << "Loaded Configuration:" << std::endl;
         for (const auto& section : config.getSections()) {
-            std::cout << "[" << section.first << "]" << std::endl;
-            for (const auto& item : section.second.getValues()) {
-                std::cout << item.first << " = " << item.second->toString() << std::endl;
+            std::cout << "[" << section.getName() << "]" << std::endl;
+            for (const auto& entry : section.getEntries()) {
+                if (entry.value.empty()) continue;
+                std::cout << entry.key << " = " << entry.value.toString() << std::endl;
             }
             std::cout << std::endl;
         }
         
 		 // Use the config object like this
         try {
-            std::cout << "1ABT.kor: " << config.getValue<double>("ABT", "kor") << std::endl;
-			std::cout << "1ABT.koh: " << config.getValue<int>("ABT", "koh") << std::endl;
+            std::cout << "1ABT.kor: " << config.get<SpecificAlgorithm::abtKor>() << std::endl;
+			std::cout << "1ABT.koh: " << config.get<SpecificAlgorithm::abtKoh>() << std::endl;
             //std::cout << "1TBM.kor: " << config.getValue<double>("TBM", "kor") << std::endl;
             //std::cout << "1General.FW: " << config.getValue<double>("General", "FW") << std::endl;
         } catch (const std::exception& e) {
@@ -76,7 +64,7 @@ int main() {
         }
 		
 		// Use the config object like this
-		double kor_new = config.getValue<double>("ABT", "kor") * 3.0;
+		double kor_new = config.get<SpecificAlgorithm::abtKor>() * 3.0;
 		std::cout << "kor_new: " << std::to_string(kor_new) << std::endl;
 		
         // Testing validation logic
@@ -88,9 +76,9 @@ int main() {
 
         // Use the config object like this
         try {
-            std::cout << "2ABT.kor: " << config.getValue<double>("ABT", "kor") << std::endl;
-            std::cout << "2TBM.kor: " << config.getValue<double>("TBM", "kor") << std::endl;
-            std::cout << "2General.FW: " << config.getValue<double>("General", "FW") << std::endl;
+            std::cout << "2ABT.kor: " << config.get<SpecificAlgorithm::abtKor>() << std::endl;
+            std::cout << "2TBM.kor: " << config.get<SpecificAlgorithm::tbmKor>() << std::endl;
+            std::cout << "2General.FW: " << config.get<SpecificAlgorithm::fixedWing>() << std::endl;
         } catch (const std::exception& e) {
             std::cerr << "Error retrieving value: " << e.what() << std::endl;
         }
@@ -1,14 +1,15 @@
 #include "config_library/config_reader.hpp"
-#include "config_library/validation_rules.hpp"
+#include "monte_carlo_schema.hpp"
+#include "MonteCarloSettings.hpp"
 #include <iostream>
 #include <vector>
 #include <random>
 #include <cmath>
 #include <numeric>
 
-class MonteCarloConfig : public ConfigLib::ConfigReader {
+class MonteCarloConfig : public ConfigLib::StaticConfigReader<MonteCarloSchema::schema> {
 public:
-    MonteCarloConfig() : ConfigReader() {
+    MonteCarloConfig() {
         std::cout << "MonteCarloConfig constructor started" << std::endl;
         initialize();
         std::cout << "MonteCarloConfig constructor finished" << std::endl;
@@ -17,37 +18,22 @@ public:
     std::string getConfigFilePath() const override {
         return "monte_carlo_config.ini";
     }
-
-    std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override 
-    {
-        return {
-            {
-                "Simulation",
-                {
-                    {"num_simulations", "int", "10000", "Number of Monte Carlo simulations", &ValidationRules::greaterThanZero},
-                    {"initial_price", "double", "100.0", "Initial asset price", &ValidationRules::greaterThanZero},
-                    {"time_horizon", "double", "1.0", "Time horizon in years", &ValidationRules::greaterThanZero},
-                    {"num_steps", "int", "252", "Number of time steps", &ValidationRules::greaterThanZero},
-                    {"risk_free_rate", "double", "0.05", "Risk-free interest rate", &ValidationRules::greaterThanOrEqualToZero},
-                    {"volatility", "double", "0.2", "Asset price volatility", &ValidationRules::greaterThanZero}
-                }
-            }
-        };
-    }
 };
 
 class MonteCarloSimulation {
 public:
-    MonteCarloSimulation() : config(), rng(std::random_device{}()) {}
+    // Copy every value once; reads in runSimulation() are then plain field accesses
+    MonteCarloSimulation() : config(), settings(MonteCarloSettings::load(config)), rng(std::random_device{}()) {}
 
     double runSimulation() const {
-        int num_simulations = config.getValue<int>("Simulation", "num_simulations");
+        const MonteCarloSettings::SimulationSection& simulation = settings.Simulation;
+        int num_simulations = simulation.num_simulations;
 		std::cout << "num_simulations: " << std::to_string(num_simulations) << std::endl; 
-        double initial_price = config.getValue<double>("Simulation", "initial_price");
-        double time_horizon = config.getValue<double>("Simulation", "time_horizon");
-        int num_steps = config.getValue<int>("Simulation", "num_steps");
-        double risk_free_rate = config.getValue<double>("Simulation", "risk_free_rate");
-        double volatility = config.getValue<double>("Simulation", "volatility");
+        double initial_price = simulation.initial_price;
+        double time_horizon = simulation.time_horizon;
+        int num_steps = simulation.num_steps;
+        double risk_free_rate = simulation.risk_free_rate;
+        double volatility = simulation.volatility;
 
         double dt = time_horizon / num_steps;
         double drift = (risk_free_rate - 0.5 * volatility * volatility) * dt;
@@ -81,6 +67,7 @@ public:
 
 private:
     MonteCarloConfig config;
+    MonteCarloSettings settings;
     mutable std::mt19937 rng;
 };
 
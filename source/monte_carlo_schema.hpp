@@ -0,0 +1,21 @@
+#ifndef MONTE_CARLO_SCHEMA_H
+#define MONTE_CARLO_SCHEMA_H
+
+#include "config_library/config_schema.hpp"
+#include "config_library/validation_rules.hpp"
+
+// Shared by the monte_carlo executable and the MonteCarloSettings generator.
+namespace MonteCarloSchema {
+    using ConfigLib::ConfigGen::Key;
+
+    inline constexpr Key<int> numSimulations{"Simulation", "num_simulations", "10000", "Number of Monte Carlo simulations", &ValidationRules::greaterThanZero};
+    inline constexpr Key<double> initialPrice{"Simulation", "initial_price", "100.0", "Initial asset price", &ValidationRules::greaterThanZero};
+    inline constexpr Key<double> timeHorizon{"Simulation", "time_horizon", "1.0", "Time horizon in years", &ValidationRules::greaterThanZero};
+    inline constexpr Key<int> numSteps{"Simulation", "num_steps", "252", "Number of time steps", &ValidationRules::greaterThanZero};
+    inline constexpr Key<double> riskFreeRate{"Simulation", "risk_free_rate", "0.05", "Risk-free interest rate", &ValidationRules::greaterThanOrEqualToZero};
+    inline constexpr Key<double> volatility{"Simulation", "volatility", "0.2", "Asset price volatility", &ValidationRules::greaterThanZero};
+
+    inline constexpr auto schema = ConfigLib::ConfigGen::makeSchema(numSimulations, initialPrice, timeHorizon, numSteps, riskFreeRate, volatility);
+}
+
+#endif // MONTE_CARLO_SCHEMA_H
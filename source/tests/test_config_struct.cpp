@@ -0,0 +1,156 @@
+#include "test_struct_schema.hpp"
+#include "TestSettings.hpp"
+#include "config_library/config_reader.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Loads, saves and defaults of a struct generated by config_generate_struct(), checked against
+// the reader it comes from and against the file a save leaves behind. Prints each failed check
+// and returns nonzero if there was one.
+
+namespace {
+
+	const char* const kConfigPath = "test_config_struct.ini";
+	const char* const kArrayPath = "test_config_struct_rates.bin";
+
+	class TestConfig : public ConfigLib::ConfigReader {
+	public:
+		TestConfig() { initialize(); }
+
+		std::string getConfigFilePath() const override { return kConfigPath; }
+		std::vector<ConfigLib::ConfigGen::ConfigSection> getConfigSections() const override { return TestStructSchema::sections(); }
+	};
+
+	int failures = 0;
+
+	void check(bool condition, const char* what) {
+		if (condition) return;
+		std::printf("FAILED: %s\n", what);
+		++failures;
+	}
+
+	void writeFile(const char* path, const std::string& contents) {
+		std::ofstream(path, std::ios::binary) << contents;
+	}
+
+	std::string readFile(const char* path) {
+		std::ifstream in(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	bool same(const TestSettings& a, const TestSettings& b) {
+		return a.Simulation.num_steps == b.Simulation.num_steps
+			&& a.Simulation.volatility == b.Simulation.volatility
+			&& a.Simulation.scheme == b.Simulation.scheme
+			&& a.Curve_EUR.tenors == b.Curve_EUR.tenors
+			&& a.Curve_EUR.rates == b.Curve_EUR.rates
+			&& a.Curve_EUR.default_ == b.Curve_EUR.default_;
+	}
+
+	void testDefaults() {
+		const TestSettings defaults;
+		check(defaults.Simulation.num_steps == 252 && defaults.Simulation.volatility == 0.2
+			&& defaults.Simulation.scheme == "euler" && defaults.Curve_EUR.default_ == -1
+			&& defaults.Curve_EUR.tenors == std::vector<double>{0.25, 0.5, 1.0}, "member initializers hold the schema defaults");
+
+		writeFile(kConfigPath, "# nothing set\n");
+		TestConfig empty;
+		check(same(TestSettings::load(empty), defaults), "an empty file loads the defaults");
+
+		writeFile(kConfigPath, "[Simulation]\nnum_steps = 10\n");
+		TestConfig partial;
+		TestSettings expected;
+		expected.Simulation.num_steps = 10;
+		check(same(TestSettings::load(partial), expected), "keys missing from the file keep their defaults");
+	}
+
+	void testLoad() {
+		writeFile(kConfigPath, "[Simulation]\nnum_steps = 365\nvolatility = 0.25\nscheme = milstein\n\n"
+			"[Curve.EUR]\ntenors = 1, 2, 3\nrates = 0.5\ndefault = 3\n");
+		TestConfig config;
+		const TestSettings settings = TestSettings::load(config);
+		check(settings.Simulation.num_steps == config.getValue<int>("Simulation", "num_steps"), "load() reads ints");
+		check(settings.Simulation.volatility == config.getValue<double>("Simulation", "volatility"), "load() reads doubles");
+		check(settings.Simulation.scheme == "milstein", "load() reads strings");
+		check(settings.Curve_EUR.tenors == std::vector<double>{1.0, 2.0, 3.0}, "load() reads lists");
+		check(settings.Curve_EUR.rates == std::vector<double>{0.5}, "load() reads one-element lists");
+		check(settings.Curve_EUR.default_ == 3, "load() reads keys named after keywords");
+
+		config.setValue("Simulation", "num_steps", 1.5);
+		bool reported = false;
+		try {
+			TestSettings::load(config);
+		} catch (const std::runtime_error&) {
+			reported = true;
+		}
+		check(reported, "load() reports a value of another type");
+	}
+
+	void testSave() {
+		writeFile(kConfigPath, "# Kept by a save\n[Simulation]\nnum_steps = 365\nvolatility = 0.25   # annual\n\n"
+			"[Curve.EUR]\ntenors = 1, 2, 3\n");
+		TestSettings changed;
+		{
+			TestConfig config;
+			changed = TestSettings::load(config);
+			changed.Simulation.volatility = 0.5;
+			changed.Simulation.scheme = "milstein";
+			changed.Curve_EUR.tenors.push_back(10.0);
+			changed.save(config);
+			check(same(TestSettings::load(config), changed), "save() writes every member to the reader");
+			config.saveConfig();
+		}
+		const std::string saved = readFile(kConfigPath);
+		check(saved.find("# Kept by a save\n") == 0 && saved.find("volatility = 0.5   # annual\n") != std::string::npos,
+			"saveConfig() keeps comments");
+		TestConfig reloaded;
+		check(same(TestSettings::load(reloaded), changed), "a saved struct loads back unchanged");
+
+		// A member that fails its rule is not written; the reader keeps the value it had
+		TestSettings invalid = changed;
+		invalid.Simulation.num_steps = 0;
+		invalid.save(reloaded);
+		check(reloaded.getValue<int>("Simulation", "num_steps") == changed.Simulation.num_steps, "save() applies the validation rules");
+	}
+
+	// A list loaded from an array file is saved as its "@path" reference until it is changed
+	void testArrayReference() {
+		const std::vector<double> rates = {0.01, 0.015, 0.02, 0.03};
+		writeFile(kArrayPath, std::string(reinterpret_cast<const char*>(rates.data()), rates.size() * sizeof(double)));
+		writeFile(kConfigPath, std::string("[Curve.EUR]\nrates = @") + kArrayPath + "\n");
+		const std::string reference = std::string("rates = @") + kArrayPath + "\n";
+
+		TestConfig config;
+		TestSettings settings = TestSettings::load(config);
+		check(settings.Curve_EUR.rates == rates, "load() copies an array file");
+
+		settings.Simulation.num_steps = 100;
+		settings.save(config);
+		config.saveConfig();
+		check(readFile(kConfigPath).find(reference) != std::string::npos, "an unchanged list keeps its reference");
+
+		settings.Curve_EUR.rates.back() = 0.04;
+		settings.save(config);
+		config.saveConfig();
+		check(readFile(kConfigPath).find('@') == std::string::npos, "a changed list is written out");
+		TestConfig reloaded;
+		check(TestSettings::load(reloaded).Curve_EUR.rates == settings.Curve_EUR.rates, "a written out list loads back");
+	}
+
+}
+
+int main() {
+	testDefaults();
+	testLoad();
+	testSave();
+	testArrayReference();
+
+	std::remove(kConfigPath);
+	std::remove(kArrayPath);
+	if (failures == 0) std::printf("all checks passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+#ifndef TEST_STRUCT_SCHEMA_H
+#define TEST_STRUCT_SCHEMA_H
+
+#include "config_library/config_schema.hpp"
+#include "config_library/validation_rules.hpp"
+
+// Schema of test_config_struct, which config_generate_struct() turns into TestSettings. It has
+// every value type, a rule, a key that is a C++ keyword and a section name that is not an
+// identifier.
+namespace TestStructSchema {
+
+    inline std::vector<ConfigLib::ConfigGen::ConfigSection> sections() {
+        return {
+            {
+                "Simulation",
+                {
+                    {"num_steps", "int", "252", "Number of time steps", &ValidationRules::greaterThanZero},
+                    {"volatility", "double", "0.2", "Asset price volatility", nullptr},
+                    {"scheme", "string", "euler", "Discretisation scheme", nullptr}
+                }
+            },
+            {
+                "Curve.EUR",
+                {
+                    {"tenors", "vector<double>", "0.25, 0.5, 1", "Curve tenors in years", nullptr},
+                    {"rates", "vector<double>", "0.01, 0.02, 0.03", "Zero rates per tenor", nullptr},
+                    {"default", "int", "-1", "Keyword as a key", nullptr}
+                }
+            }
+        };
+    }
+
+}
+
+#endif // TEST_STRUCT_SCHEMA_H